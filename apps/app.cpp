@@ -22,20 +22,147 @@
 
 #include "app.h"
 #include "platform/platform.h"
+#include "platform/glfw_window.h"
 
 namespace vulkr
 {
 
 MainApp::MainApp(Platform& platform, std::string name) : Application{ platform, name } {}
 
+void MainApp::setUseQuantizedVertices(bool enabled)
+{
+    useQuantizedVertices = enabled;
+}
+
+static const char *getLatencyProfileName(LatencyProfile profile)
+{
+    switch (profile)
+    {
+    case LatencyProfile::LowLatency:
+        return "Low Latency";
+    case LatencyProfile::Throughput:
+        return "Throughput";
+    case LatencyProfile::Vsync:
+        return "Vsync";
+    default:
+        LOGEANDABORT("Unknown latency profile {}", static_cast<int>(profile));
+    }
+}
+
+static uint32_t getLatencyProfileFramesInFlight(LatencyProfile profile)
+{
+    switch (profile)
+    {
+    case LatencyProfile::LowLatency:
+        return 1u;
+    case LatencyProfile::Throughput:
+        return 3u;
+    case LatencyProfile::Vsync:
+        return 2u;
+    default:
+        LOGEANDABORT("Unknown latency profile {}", static_cast<int>(profile));
+    }
+}
+
+// In decreasing priority, the swapchain falls back to FIFO when none of them are supported
+static std::vector<VkPresentModeKHR> getLatencyProfilePresentModes(LatencyProfile profile)
+{
+    switch (profile)
+    {
+    case LatencyProfile::LowLatency:
+        // MAILBOX shows the newest frame without tearing, IMMEDIATE doesn't wait for vblank at all
+        return { VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR };
+    case LatencyProfile::Throughput:
+        return { VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR };
+    case LatencyProfile::Vsync:
+        return { VK_PRESENT_MODE_FIFO_KHR };
+    default:
+        LOGEANDABORT("Unknown latency profile {}", static_cast<int>(profile));
+    }
+}
+
+void MainApp::setLatencyProfile(LatencyProfile profile)
+{
+    latencyProfile = profile;
+    requestedLatencyProfile = profile;
+    maxFramesInFlight = getLatencyProfileFramesInFlight(profile);
+}
+
+void MainApp::setPipelined(bool enabled)
+{
+    pipelined = enabled;
+}
+
+void MainApp::setUseGpuCulling(bool enabled)
+{
+    useGpuCulling = enabled;
+}
+
+void MainApp::setCompareObjLoaders(bool enabled)
+{
+    compareObjLoaders = enabled;
+}
+
+void MainApp::setBenchmarkJobSystem(bool enabled)
+{
+    benchmarkJobSystem = enabled;
+}
+
  MainApp::~MainApp()
  {
+     stopRenderThread();
+
+     // Decodes that are still running finish before the device they query goes away, queued ones are dropped
+     textureLoaderThreadPool.reset();
+     pendingTextureLoads.clear();
+     textureDecoder.reset();
+     jobSystem.reset();
+
      device->waitIdle();
 
+     cleanupSwapchain();
+     device->flushDeferredDestructions();
+
      semaphorePool.reset();
-     fencePool.reset();
+     graphicsTimeline.reset();
 
-     cleanupSwapchain();
+     for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+     {
+         frameData.commandBuffers[i].reset();
+         frameData.secondaryCommandBuffers[i].clear();
+     }
+
+     for (auto &it : materials)
+     {
+         it.second->pipeline.reset();
+         it.second->pipelineState.reset();
+     }
+     materials.clear();
+     materialTable.clear();
+
+     cullPipeline.reset();
+     cullPipelineLayout.reset();
+     cullShaderModules.clear();
+
+     renderPass.reset();
+     subpasses.clear();
+
+     offscreenImageViews.clear();
+     offscreenImages.clear();
+     inputAttachments.clear();
+     colorAttachments.clear();
+     resolveAttachments.clear();
+     depthStencilAttachments.clear();
+     preserveAttachments.clear();
+
+     swapchain.reset();
+
+     globalDescriptorSet.reset();
+     objectBuffer.reset();
+
+     descriptorPool.reset();
+
+     cameraController.reset();
 
      textureSampler.reset();
 
@@ -45,27 +172,34 @@ MainApp::MainApp(Platform& platform, std::string name) : Application{ platform,
          it.second->image.reset();
      }
      textures.clear();
+     placeholderTexture.reset();
 
      globalDescriptorSetLayout.reset();
      objectDescriptorSetLayout.reset();
      singleTextureDescriptorSetLayout.reset();
+     cullDescriptorSetLayout.reset();
 
-     for (auto &it : meshes)
-     {
-         it.second->indexBuffer.reset();
-         it.second->vertexBuffer.reset();
-     }
      meshes.clear();
+     meshTable.clear();
+     geometryArena.reset();
+
+     streamingUploadContext.reset();
+     uploadContext.reset();
+     frameRingBuffer.reset();
 
      for (uint32_t i = 0; i < maxFramesInFlight; ++i)
      {
          frameData.commandPools[i].reset();
+         frameData.secondaryCommandPools[i].clear();
      }
      imguiPool.reset();
 
-     ImGui_ImplVulkan_Shutdown();
-     ImGui_ImplGlfw_Shutdown();
-     ImGui::DestroyContext();
+     if (!platform.isHeadless())
+     {
+         ImGui_ImplVulkan_Shutdown();
+         ImGui_ImplGlfw_Shutdown();
+         ImGui::DestroyContext();
+     }
 
      device.reset();
 
@@ -79,56 +213,23 @@ MainApp::MainApp(Platform& platform, std::string name) : Application{ platform,
 
  void MainApp::cleanupSwapchain()
  {
-     for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+     // Only the objects that depend on the swapchain extent or images, the pipelines use a dynamic viewport and scissor and survive a resize
+     // The frames in flight may still use them, so they are destroyed once the last submitted frame has completed
+     const uint64_t lastUseTimelineValue{ graphicsTimeline->getPendingValue() };
+     for (uint32_t i = 0; i < framebuffers.size(); ++i)
      {
-         frameData.commandBuffers[i].reset();
+         device->deferDestruction(std::move(framebuffers[i]), lastUseTimelineValue);
      }
+     framebuffers.clear();
 
-     depthImage.reset();
-
-     depthImageView.reset();
-
-     for (uint32_t i = 0; i < swapchainFramebuffers.size(); ++i)
-     {
-         swapchainFramebuffers[i].reset();
-     }
-     swapchainFramebuffers.clear();
-
-     for (auto &it : materials)
-     {
-         it.second->pipeline.reset();
-         it.second->pipelineState.reset();
-     }
-     materials.clear();
-     renderables.clear();
-
-     renderPass.reset();
-     subpasses.clear();
+     device->deferDestruction(std::move(depthImageView), lastUseTimelineValue);
+     device->deferDestruction(std::move(depthImage), lastUseTimelineValue);
 
      for (uint32_t i = 0; i < swapChainImageViews.size(); ++i)
      {
-         swapChainImageViews[i].reset();
+         device->deferDestruction(std::move(swapChainImageViews[i]), lastUseTimelineValue);
      }
      swapChainImageViews.clear();
-     inputAttachments.clear();
-     colorAttachments.clear();
-     resolveAttachments.clear();
-     depthStencilAttachments.clear();
-     preserveAttachments.clear();
-
-     swapchain.reset();
-
-     for (uint32_t i = 0; i < maxFramesInFlight; ++i)
-     {
-         frameData.globalDescriptorSets[i].reset();
-         frameData.objectDescriptorSets[i].reset();
-         frameData.globalBuffers[i].reset();
-         frameData.objectBuffers[i].reset();
-     }
-
-     descriptorPool.reset();
-
-     cameraController.reset();
  }
 
 void MainApp::prepare()
@@ -143,50 +244,422 @@ void MainApp::prepare()
 
     graphicsQueue = device->getOptimalGraphicsQueue().getHandle();
 
-    if (device->getOptimalGraphicsQueue().canSupportPresentation())
+    if (platform.isHeadless())
     {
-        presentQueue = graphicsQueue;
+        createOffscreenRenderTargets();
     }
     else
     {
-        presentQueue = device->getQueueByPresentation().getHandle();
-    }
+        if (device->getOptimalGraphicsQueue().canSupportPresentation())
+        {
+            presentQueue = graphicsQueue;
+        }
+        else
+        {
+            presentQueue = device->getQueueByPresentation().getHandle();
+        }
 
-    createSwapchain();
-    createSwapchainImageViews();
+        createSwapchain();
+        createSwapchainImageViews();
+    }
     setupCamera();
     createRenderPass();
     createDescriptorSetLayouts();
     createGraphicsPipelines();
+    createComputePipelines();
     createDepthResources();
     createFramebuffers();
+    createJobSystem();
     createCommandPools();
     createCommandBuffers();
+    createUploadContext();
+    createFrameRingBuffer();
+    createTextureLoader();
+    // Texture decodes run on the loader threads while the rest of the startup work continues, they are uploaded as they finish
     loadTextures();
+    createPlaceholderTexture();
     createTextureSampler();
-    createUniformBuffers();
-    createSSBOs();
     createDescriptorPool();
     createDescriptorSets();
+    createObjectBuffer(INITIAL_OBJECT_CAPACITY);
     loadMeshes();
+    // The mesh uploads recorded above are submitted as a single batch, the placeholder texture went through the streaming queue and must be resident before the first frame
+    uploadContext->flush();
+    streamingUploadContext->flush();
+    LOGI("Uploaded {} bytes of startup resources in {} submission(s)", uploadContext->getTotalBytesUploaded(), uploadContext->getSubmittedBatchCount());
     createScene();
-    createSemaphoreAndFencePools();
+    createSynchronizationPrimitives();
     setupSynchronizationObjects();
-    initializeImGui();
+
+    if (!platform.isHeadless())
+    {
+        initializeImGui();
+    }
+
+    updateRenderStatistics();
+
+    if (pipelined)
+    {
+        renderThread = std::thread(&MainApp::runRenderThread, this);
+        LOGI("Recording and submitting frames on a render thread");
+    }
+}
+
+template<typename T>
+static void copyImVector(const ImVector<T> &source, ImVector<T> &destination)
+{
+    // Resizing keeps the capacity, so once the buffers have grown to the size of the UI copying doesn't allocate
+    destination.resize(source.Size);
+    if (source.Size > 0)
+    {
+        memcpy(destination.Data, source.Data, source.size_in_bytes());
+    }
+}
+
+// ImGui reuses its draw data as soon as the next UI frame starts, so the packet takes a copy which stays valid however long the render stage holds on to it
+static void copyUserInterfaceDrawData(const ImDrawData &source, FramePacket &packet)
+{
+    while (packet.userInterfaceDrawLists.size() < static_cast<size_t>(source.CmdListsCount))
+    {
+        packet.userInterfaceDrawLists.push_back(std::make_unique<ImDrawList>(nullptr));
+    }
+
+    packet.userInterfaceDrawListPointers.clear();
+    for (int i = 0; i < source.CmdListsCount; ++i)
+    {
+        const ImDrawList &sourceList = *source.CmdLists[i];
+        ImDrawList &list = *packet.userInterfaceDrawLists[i];
+        copyImVector(sourceList.CmdBuffer, list.CmdBuffer);
+        copyImVector(sourceList.IdxBuffer, list.IdxBuffer);
+        copyImVector(sourceList.VtxBuffer, list.VtxBuffer);
+        list.Flags = sourceList.Flags;
+        packet.userInterfaceDrawListPointers.push_back(&list);
+    }
+
+    packet.userInterfaceDrawData = source;
+    packet.userInterfaceDrawData.CmdLists = packet.userInterfaceDrawListPointers.data();
 }
 
 void MainApp::update()
 {
-    fencePool->wait(&frameData.inFlightFences[currentFrame]);
-    fencePool->reset(&frameData.inFlightFences[currentFrame]);
+    // The simulation stage fills a frame packet which the render stage records and submits, right away or on the render thread when pipelined
+    FramePacket &packet = framePackets.getWriteBuffer();
+    simulateFrame(packet);
+
+    if (!platform.isHeadless())
+    {
+        drawImGuiInterface(packet);
+        copyUserInterfaceDrawData(*ImGui::GetDrawData(), packet);
+    }
+
+    if (!pipelined)
+    {
+        renderFrame(packet);
+        return;
+    }
+
+    framePackets.publish();
+    {
+        // Only held while the render thread checks for a packet, so this never waits on rendering
+        std::lock_guard<std::mutex> lock{ framePacketMutex };
+    }
+    framePacketPublished.notify_one();
+}
+
+void MainApp::finish()
+{
+    stopRenderThread();
+    Application::finish();
+}
+
+void MainApp::simulateFrame(FramePacket &packet)
+{
+    const std::shared_ptr<Camera> camera = cameraController->getCamera();
+
+    // The render extent changes on the render stage when the swapchain is recreated, the camera only follows it here so the render stage never touches it
+    const VkExtent2D renderExtent = getRenderStatistics().extent;
+    if (renderExtent.width != cameraExtent.width || renderExtent.height != cameraExtent.height)
+    {
+        camera->setViewport(renderExtent.width, renderExtent.height);
+        cameraExtent = renderExtent;
+    }
+
+    packet.camera.view = camera->getView();
+    packet.camera.proj = camera->getProjection();
+
+    const glm::vec3 cameraPosition = camera->getPosition();
+    const glm::vec3 viewDirection = camera->getViewDirection();
+    const float clipNear = camera->getClipNear();
+    const float depthRange = camera->getClipFar() - clipNear;
+    const Frustum frustum = Frustum::fromViewProjection(packet.camera.proj * packet.camera.view);
+
+    // Every field of the entities is an array of its own, so the passes below stream through the data they read instead of hopping between objects
+    const uint32_t entityCount{ scene.getEntityCount() };
+    const std::vector<glm::mat4> &worldTransforms = scene.getWorldTransforms();
+    const std::vector<glm::vec3> &worldBoundsMin = scene.getWorldBoundsMin();
+    const std::vector<glm::vec3> &worldBoundsMax = scene.getWorldBoundsMax();
+    const std::vector<uint32_t> &meshIds = scene.getMeshIds();
+    const std::vector<uint32_t> &materialIds = scene.getMaterialIds();
+    const std::vector<uint32_t> &entityFlags = scene.getFlags();
+    const uint32_t meshCount{ to_u32(meshTable.size()) };
+    packet.gpuCulling = useGpuCulling && buildDrawBatches(packet);
+    packet.objects.resize(entityCount);
+    packet.lodIndices.resize(entityCount);
+    packet.cullInstances.resize(packet.gpuCulling ? entityCount : 0);
+    entitySortKeys.resize(entityCount);
+    entityVisibility.resize(entityCount);
+    jobSystem->parallelFor(entityCount, MIN_OBJECTS_PER_RECORDING_TASK, [&](uint32_t firstEntity, uint32_t lastEntity) {
+        scene.updateWorldTransforms(firstEntity, lastEntity);
+
+        for (uint32_t index = firstEntity; index < lastEntity; ++index)
+        {
+            const glm::mat4 &transform = worldTransforms[index];
+            const Mesh &mesh = *meshTable[meshIds[index]];
+            const Material &material = *materialTable[materialIds[index]];
+
+            packet.objects[index].model = transform * mesh.dequantizationMatrix;
+            packet.lodIndices[index] = mesh.selectLod(transform, *camera, lodErrorThreshold);
+            if (packet.gpuCulling)
+            {
+                // The culling and sorting happen on the GPU, into the batch of the material and mesh of the entity
+                const bool visible{ (entityFlags[index] & ENTITY_FLAG_VISIBLE) != 0 };
+                const uint32_t batchIndex{ visible ? drawBatchLookup[materialIds[index] * meshCount + meshIds[index]] : INVALID_DRAW_BATCH };
+                packet.cullInstances[index] = CullInstance{ mesh.id, packet.lodIndices[index], batchIndex, 0 };
+                continue;
+            }
+
+            entityVisibility[index] = (entityFlags[index] & ENTITY_FLAG_VISIBLE) != 0 && frustum.intersects(worldBoundsMin[index], worldBoundsMax[index]);
+
+            // Front to back within the draws that share their state, by the view depth of the center of the bounds
+            glm::vec3 center = (worldBoundsMin[index] + worldBoundsMax[index]) * 0.5f;
+            float depth = (glm::dot(center - cameraPosition, viewDirection) - clipNear) / depthRange;
+            entitySortKeys[index] = RenderQueue::makeSortKey(RenderPassType::Opaque, material.pipelineId, material.id, mesh.id, depth);
+        }
+    });
+
+    if (packet.gpuCulling)
+    {
+        packet.renderQueue.resize(0);
+    }
+    else
+    {
+        packet.drawBatches.clear();
+
+        // Compacting the visible entities into the render queue is a linear pass over two small arrays, cheap enough to stay on this thread
+        uint32_t drawCount{ 0 };
+        for (uint32_t index = 0; index < entityCount; ++index)
+        {
+            drawCount += entityVisibility[index];
+        }
+
+        packet.renderQueue.resize(drawCount);
+        uint32_t drawIndex{ 0 };
+        for (uint32_t index = 0; index < entityCount; ++index)
+        {
+            if (entityVisibility[index])
+            {
+                packet.renderQueue.setDraw(drawIndex++, entitySortKeys[index], index);
+            }
+        }
+
+        packet.renderQueue.sort();
+        renderQueueStatistics = packet.renderQueue.getStatistics();
+        culledEntityCount = entityCount - drawCount;
+    }
+
+    // The requests made through the UI are handed over with the packet since the render stage owns the resources they change
+    packet.latencyProfile = requestedLatencyProfile;
+    packet.geometryDefragmentationRequestCount = geometryDefragmentationRequestCount;
+}
+
+bool MainApp::buildDrawBatches(FramePacket &packet)
+{
+    // Scenes past the fixed limits of GPU culling are culled on the CPU for as long as they exceed them, which is only worth a warning the first time
+    auto fallBackToCpuCulling = [this](const std::string &reason) {
+        if (!gpuCullingFallbackLogged)
+        {
+            LOGW("{}, objects are culled on the CPU", reason);
+            gpuCullingFallbackLogged = true;
+        }
+        return false;
+    };
+
+    packet.drawBatches.clear();
+    const uint32_t meshCount{ to_u32(meshTable.size()) };
+    if (meshCount > MAX_CULL_MESH_COUNT)
+    {
+        return fallBackToCpuCulling(fmt::format("The scene has {} meshes, GPU culling supports up to {}", meshCount, MAX_CULL_MESH_COUNT));
+    }
+
+    // Every pair of material and mesh is a batch, the lookup first counts the visible entities of each pair and then holds the index of its batch
+    const uint32_t entityCount{ scene.getEntityCount() };
+    const std::vector<uint32_t> &meshIds = scene.getMeshIds();
+    const std::vector<uint32_t> &materialIds = scene.getMaterialIds();
+    const std::vector<uint32_t> &entityFlags = scene.getFlags();
+    drawBatchLookup.assign(materialTable.size() * meshCount, 0u);
+    for (uint32_t index = 0; index < entityCount; ++index)
+    {
+        drawBatchLookup[materialIds[index] * meshCount + meshIds[index]] += (entityFlags[index] & ENTITY_FLAG_VISIBLE) != 0;
+    }
+
+    for (uint32_t pair = 0; pair < drawBatchLookup.size(); ++pair)
+    {
+        if (drawBatchLookup[pair] != 0)
+        {
+            packet.drawBatches.push_back(DrawBatch{ pair / meshCount, pair % meshCount, 0u, drawBatchLookup[pair] });
+        }
+    }
+
+    if (packet.drawBatches.size() > MAX_DRAW_BATCH_COUNT)
+    {
+        const size_t batchCount{ packet.drawBatches.size() };
+        packet.drawBatches.clear();
+        return fallBackToCpuCulling(fmt::format("The scene has {} pairs of material and mesh, GPU culling supports up to {}", batchCount, MAX_DRAW_BATCH_COUNT));
+    }
+
+    // In the same order as the render queue sorts its draws, so the pipelines and materials are bound as rarely
+    std::sort(packet.drawBatches.begin(), packet.drawBatches.end(), [this](const DrawBatch &first, const DrawBatch &second) {
+        return RenderQueue::makeSortKey(RenderPassType::Opaque, materialTable[first.materialId]->pipelineId, first.materialId, first.meshId, 0.0f) <
+            RenderQueue::makeSortKey(RenderPassType::Opaque, materialTable[second.materialId]->pipelineId, second.materialId, second.meshId, 0.0f);
+    });
+
+    const uint32_t maxDrawIndirectCount{ device->getPhysicalDevice().getProperties().limits.maxDrawIndirectCount };
+    uint32_t commandCount{ 0 };
+    for (uint32_t batchIndex = 0; batchIndex < packet.drawBatches.size(); ++batchIndex)
+    {
+        DrawBatch &batch = packet.drawBatches[batchIndex];
+        if (batch.maxDrawCount > maxDrawIndirectCount)
+        {
+            const uint32_t drawCount{ batch.maxDrawCount };
+            packet.drawBatches.clear();
+            return fallBackToCpuCulling(fmt::format("A batch of {} objects exceeds the {} draws of an indirect draw supported by the device", drawCount, maxDrawIndirectCount));
+        }
+
+        batch.firstCommand = commandCount;
+        commandCount += batch.maxDrawCount;
+        drawBatchLookup[batch.materialId * meshCount + batch.meshId] = batchIndex;
+    }
+
+    return true;
+}
+
+void MainApp::runRenderThread()
+{
+    while (true)
+    {
+        bool acquired{ false };
+        {
+            // A packet published before stopping is still rendered so the last simulated frame isn't lost
+            std::unique_lock<std::mutex> lock{ framePacketMutex };
+            framePacketPublished.wait(lock, [&]() {
+                acquired = framePackets.acquire();
+                return acquired || renderThreadStopping;
+            });
+        }
+
+        if (!acquired)
+        {
+            return;
+        }
+
+        renderFrame(framePackets.getReadBuffer());
+    }
+}
+
+void MainApp::stopRenderThread()
+{
+    if (!renderThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{ framePacketMutex };
+        renderThreadStopping = true;
+    }
+    framePacketPublished.notify_one();
+    renderThread.join();
+}
+
+void MainApp::updateRenderStatistics()
+{
+    RenderStatistics statistics{};
+    statistics.extent = getRenderExtent();
+    statistics.framesInFlight = maxFramesInFlight;
+    if (!platform.isHeadless())
+    {
+        statistics.presentMode = swapchain->getProperties().presentMode;
+    }
+    statistics.geometry = geometryArena->getStats();
+
+    std::lock_guard<std::mutex> lock{ renderStatisticsMutex };
+    renderStatistics = statistics;
+}
+
+RenderStatistics MainApp::getRenderStatistics() const
+{
+    std::lock_guard<std::mutex> lock{ renderStatisticsMutex };
+    return renderStatistics;
+}
+
+void MainApp::renderFrame(const FramePacket &packet)
+{
+    if (packet.latencyProfile != latencyProfile)
+    {
+        applyLatencyProfile(packet.latencyProfile);
+    }
+
+    // Nothing is reset, so returning early below (when the swapchain is out of date) can't leave the next wait on this frame without a signal
+    graphicsTimeline->wait(frameData.timelineValues[currentFrame]);
+    device->releaseDeferredDestructions(graphicsTimeline->getCompletedValue());
+
+    // The wait above guarantees the GPU is done with everything this frame previously allocated from the ring, unless the last attempt at this frame
+    // returned before submitting: its region is kept open then, since the transfer queue may still read the streaming uploads staged in it
+    if (!frameSubmitSkipped)
+    {
+        frameRingBuffer->beginFrame(to_u32(currentFrame));
+    }
+    frameSubmitSkipped = false;
+
+    // The wait also means the texture descriptor sets of this frame are no longer in use and can be pointed at newly resident textures
+    updateTextureLoads();
+    updateTextureDescriptorSets(to_u32(currentFrame));
+
+    if (packet.geometryDefragmentationRequestCount != completedGeometryDefragmentationRequestCount)
+    {
+        completedGeometryDefragmentationRequestCount = packet.geometryDefragmentationRequestCount;
+
+        // Submitted right away so the copies run before this frame draws with the new offsets
+        geometryArena->defragment(*uploadContext);
+        uploadContext->submit();
+    }
+
+    // The batch of a defragmentation holds the old arena buffers, which are freed as soon as it has completed
+    uploadContext->retireCompleted();
+    updateRenderStatistics();
+
+    // Now that the commands of this frame finished executing, its pools are reset as a whole and hand the same command buffers out again
+    frameData.commandPools[currentFrame]->reset();
+    frameData.commandBuffers[currentFrame] = frameData.commandPools[currentFrame]->requestCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    for (uint32_t slot = 0; slot < frameData.secondaryCommandPools[currentFrame].size(); ++slot)
+    {
+        frameData.secondaryCommandPools[currentFrame][slot]->reset();
+        frameData.secondaryCommandBuffers[currentFrame][slot] = frameData.secondaryCommandPools[currentFrame][slot]->requestCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    }
 
-    //now that we are sure that the commands finished executing, we can safely reset the command buffer to begin recording again.
-    frameData.commandBuffers[currentFrame]->reset();
+    if (platform.isHeadless())
+    {
+        // The offscreen ring has one render target per frame in flight so the timeline value we just waited on guarantees that it's no longer in use
+        recordAndSubmitFrame(packet, to_u32(currentFrame));
+        currentFrame = (currentFrame + 1) % maxFramesInFlight;
+        return;
+    }
 
     uint32_t swapchainImageIndex;
     VkResult result = vkAcquireNextImageKHR(device->getHandle(), swapchain->getHandle(), std::numeric_limits<uint64_t>::max(), frameData.imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &swapchainImageIndex);
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
+        frameSubmitSkipped = true;
         recreateSwapchain();
         return;
     }
@@ -195,27 +668,70 @@ void MainApp::update()
         LOGEANDABORT("Failed to acquire swap chain image");
     }
 
-    if (imagesInFlight[swapchainImageIndex] != VK_NULL_HANDLE)
+    // The image may have been acquired ahead of the frame that last rendered to it completing (when there are more images than frames in flight)
+    graphicsTimeline->wait(imagesInFlight[swapchainImageIndex]);
+
+    recordAndSubmitFrame(packet, swapchainImageIndex);
+    imagesInFlight[swapchainImageIndex] = frameData.timelineValues[currentFrame];
+
+    std::array<VkSemaphore, 1> signalSemaphores{ frameData.renderingFinishedSemaphores[currentFrame] };
+
+    VkPresentInfoKHR presentInfo{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
+    presentInfo.waitSemaphoreCount = to_u32(signalSemaphores.size());
+    presentInfo.pWaitSemaphores = signalSemaphores.data();
+
+    std::array<VkSwapchainKHR, 1> swapchains{ swapchain->getHandle() };
+    presentInfo.swapchainCount = to_u32(swapchains.size());
+    presentInfo.pSwapchains = swapchains.data();
+
+    presentInfo.pImageIndices = &swapchainImageIndex;
+
+    result = vkQueuePresentKHR(presentQueue, &presentInfo);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
     {
-        // TODO: enabling this check causes errors on swapchain recreation, will need to eventually resolve this for correctness
-        // fencePool->wait(&imagesInFlight[swapchainImageIndex]);
+        recreateSwapchain();
+    }
+    else if (result != VK_SUCCESS)
+    {
+        LOGEANDABORT("Failed to present swap chain image!");
     }
-    imagesInFlight[swapchainImageIndex] = frameData.inFlightFences[currentFrame];
 
-    drawImGuiInterface();
+    currentFrame = (currentFrame + 1) % maxFramesInFlight;
+}
 
+void MainApp::recordAndSubmitFrame(const FramePacket &packet, uint32_t renderTargetIndex)
+{
     std::vector<VkClearValue> clearValues;
     clearValues.resize(2);
     clearValues[0].color = { 0.0f, 0.0f, 0.0f, 1.0f };
     clearValues[1].depthStencil = { 1.0f, 0u };
 
     frameData.commandBuffers[currentFrame]->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
-    frameData.commandBuffers[currentFrame]->beginRenderPass(*renderPass, *(swapchainFramebuffers[swapchainImageIndex]), swapchain->getProperties().imageExtent, clearValues, VK_SUBPASS_CONTENTS_INLINE);
+
+    // The culling shader runs before the render pass, since it can't be dispatched inside one
+    updateObjectBuffer(packet);
+    if (packet.gpuCulling)
+    {
+        dispatchCulling(packet, *frameData.commandBuffers[currentFrame]);
+    }
+
+    frameData.commandBuffers[currentFrame]->beginRenderPass(*renderPass, *(framebuffers[renderTargetIndex]), getRenderExtent(), clearValues, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+
+    // Everything inside the render pass is recorded into secondary command buffers, which the primary command buffer executes in order
+    std::vector<std::shared_ptr<CommandBuffer>> secondaryCommandBuffers;
     // Render scene
-    drawObjects();
+    drawObjects(packet, secondaryCommandBuffers);
     // Render UI
-    ImGui::Render();
-    ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), frameData.commandBuffers[currentFrame]->getHandle());
+    if (packet.userInterfaceDrawData.Valid)
+    {
+        const std::shared_ptr<CommandBuffer> &uiCommandBuffer = frameData.secondaryCommandBuffers[currentFrame].back();
+        uiCommandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, frameData.commandBuffers[currentFrame].get());
+        // The backend takes a non-const pointer but only reads the draw data
+        ImGui_ImplVulkan_RenderDrawData(const_cast<ImDrawData *>(&packet.userInterfaceDrawData), uiCommandBuffer->getHandle());
+        uiCommandBuffer->end();
+        secondaryCommandBuffers.push_back(uiCommandBuffer);
+    }
+    frameData.commandBuffers[currentFrame]->executeCommands(secondaryCommandBuffers);
     frameData.commandBuffers[currentFrame]->endRenderPass();
     frameData.commandBuffers[currentFrame]->end();
 
@@ -223,64 +739,67 @@ void MainApp::update()
     // hence I don't need to set the wait stages to VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT 
     std::array<VkPipelineStageFlags, 1> waitStages{ VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     std::array<VkSemaphore, 1> waitSemaphores{ frameData.imageAvailableSemaphores[currentFrame] };
-    std::array<VkSemaphore, 1> signalSemaphores{ frameData.renderingFinishedSemaphores[currentFrame] };
+
+    // The binary semaphore ignores its value, the timeline one is last so headless frames can signal it alone
+    frameData.timelineValues[currentFrame] = graphicsTimeline->advance();
+    std::array<VkSemaphore, 2> signalSemaphores{ frameData.renderingFinishedSemaphores[currentFrame], graphicsTimeline->getHandle() };
+    std::array<uint64_t, 2> signalValues{ 0, frameData.timelineValues[currentFrame] };
+
+    VkTimelineSemaphoreSubmitInfoKHR timelineSubmitInfo{ VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR };
+    timelineSubmitInfo.signalSemaphoreValueCount = to_u32(signalValues.size());
+    timelineSubmitInfo.pSignalSemaphoreValues = signalValues.data();
 
     VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.waitSemaphoreCount = to_u32(waitSemaphores.size());
-    submitInfo.pWaitSemaphores = waitSemaphores.data();
-    submitInfo.pWaitDstStageMask = waitStages.data();
+    submitInfo.pNext = &timelineSubmitInfo;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &frameData.commandBuffers[currentFrame]->getHandle();
     submitInfo.signalSemaphoreCount = to_u32(signalSemaphores.size());
     submitInfo.pSignalSemaphores = signalSemaphores.data();
 
-    VK_CHECK(vkQueueSubmit(graphicsQueue, 1, &submitInfo, frameData.inFlightFences[currentFrame]));
-
-    VkPresentInfoKHR presentInfo{ VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
-    presentInfo.waitSemaphoreCount = to_u32(signalSemaphores.size());
-    presentInfo.pWaitSemaphores = signalSemaphores.data();
-
-    std::array<VkSwapchainKHR, 1> swapchains{ swapchain->getHandle() };
-    presentInfo.swapchainCount = to_u32(swapchains.size());
-    presentInfo.pSwapchains = swapchains.data();
-
-    presentInfo.pImageIndices = &swapchainImageIndex;
-
-    result = vkQueuePresentKHR(presentQueue, &presentInfo);
-    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR)
+    // There is no presentation engine to synchronize with when rendering headless
+    if (!platform.isHeadless())
     {
-        recreateSwapchain();
+        submitInfo.waitSemaphoreCount = to_u32(waitSemaphores.size());
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
     }
-    else if (result != VK_SUCCESS)
+    else
     {
-        LOGEANDABORT("Failed to present swap chain image!");
+        timelineSubmitInfo.signalSemaphoreValueCount = 1;
+        timelineSubmitInfo.pSignalSemaphoreValues = &signalValues[1];
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &signalSemaphores[1];
     }
 
-    currentFrame = (currentFrame + 1) % maxFramesInFlight;
+    VK_CHECK(vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE));
 }
 
 void MainApp::recreateSwapchain()
 {
-    // TODO: update window width and high variables on window resize callback??
-    // TODO: enable the imagesInFlight check in the update() function and resolve the swapchain recreation bug
-    device->waitIdle();
+    Timer resizeTimer;
+    resizeTimer.start();
+
+    // Nothing waits for the GPU here, the objects of the old swapchain are destroyed once the frames in flight that use them have completed
     cleanupSwapchain();
 
-    createSwapchain();
+    // The new swapchain keeps the surface format of the old one, so the render pass and pipelines stay compatible
+    std::unique_ptr<Swapchain> retiredSwapchain = std::move(swapchain);
+    swapchain = std::make_unique<Swapchain>(*retiredSwapchain, getLatencyProfilePresentModes(latencyProfile));
+
+    // Its images can still be queued for presentation behind the last submitted frame, those presents are queued before the first frame rendered to the new swapchain
+    device->deferDestruction(std::move(retiredSwapchain), graphicsTimeline->getPendingValue() + 1);
+
     createSwapchainImageViews();
-    setupCamera();
-    createRenderPass();
-    createGraphicsPipelines();
     createDepthResources();
     createFramebuffers();
-    createCommandBuffers();
-    createUniformBuffers();
-    createSSBOs();
-    createDescriptorPool();
-    createDescriptorSets();
-    createScene();
 
-    imagesInFlight.resize(swapChainImageViews.size(), VK_NULL_HANDLE);
+    // The camera viewport follows the new extent once the simulation stage sees it in the render statistics
+    VkExtent2D extent = getRenderExtent();
+
+    // None of the images of the new swapchain were rendered to yet, whatever the frames that rendered to the old one
+    imagesInFlight.assign(swapChainImageViews.size(), 0);
+
+    LOGI("Recreated the swapchain at {}x{} in {:.2f} ms", extent.width, extent.height, resizeTimer.stop<Timer::Milliseconds>());
 }
 
 void MainApp::handleInputEvents(const InputEvent &inputEvent)
@@ -293,7 +812,7 @@ void MainApp::handleInputEvents(const InputEvent &inputEvent)
 
 /* Private methods start here */
 
-void MainApp::drawImGuiInterface()
+void MainApp::drawImGuiInterface(const FramePacket &packet)
 {
     ImGui_ImplVulkan_NewFrame();
     ImGui_ImplGlfw_NewFrame();
@@ -342,6 +861,66 @@ void MainApp::drawImGuiInterface()
 
         if (ImGui::BeginTabItem("Extra"))
         {
+            ImGui::Text("Latency Profile");
+            ImGui::SameLine();
+            const char *latencyProfileNames[]{ getLatencyProfileName(LatencyProfile::LowLatency), getLatencyProfileName(LatencyProfile::Throughput), getLatencyProfileName(LatencyProfile::Vsync) };
+            const RenderStatistics statistics = getRenderStatistics();
+            int latencyProfileIndex = static_cast<int>(requestedLatencyProfile);
+            if (ImGui::Combo("##LatencyProfile", &latencyProfileIndex, latencyProfileNames, IM_ARRAYSIZE(latencyProfileNames)))
+            {
+                requestedLatencyProfile = static_cast<LatencyProfile>(latencyProfileIndex);
+            }
+            ImGui::Text("%u frame(s) in flight, %s", statistics.framesInFlight, to_string(statistics.presentMode).c_str());
+
+            ImGui::Text("LOD Error Threshold");
+            ImGui::SameLine();
+            ImGui::DragFloat("##LodErrorThreshold", &lodErrorThreshold, 0.1f, 0.0f, 100.0f, "%.1f px", 0);
+
+            const GeometryArenaStats &geometryStats = statistics.geometry;
+            ImGui::Text("Geometry arena: %u allocations", geometryStats.allocationCount);
+            ImGui::Text("Vertices: %.1f / %.1f MB, %u free ranges, %.0f%% fragmented", geometryStats.vertexBytesUsed / (1024.0f * 1024.0f), geometryStats.vertexBytesCapacity / (1024.0f * 1024.0f), geometryStats.vertexFreeRangeCount, geometryStats.vertexFragmentation * 100.0f);
+            ImGui::Text("Indices: %.1f / %.1f MB, %u free ranges, %.0f%% fragmented", geometryStats.indexBytesUsed / (1024.0f * 1024.0f), geometryStats.indexBytesCapacity / (1024.0f * 1024.0f), geometryStats.indexFreeRangeCount, geometryStats.indexFragmentation * 100.0f);
+            if (ImGui::Button("Defragment Geometry"))
+            {
+                ++geometryDefragmentationRequestCount;
+            }
+
+            const uint32_t unsortedChanges{ renderQueueStatistics.unsortedPipelineChanges + renderQueueStatistics.unsortedMaterialChanges + renderQueueStatistics.unsortedMeshChanges };
+            const uint32_t sortedChanges{ renderQueueStatistics.pipelineChanges + renderQueueStatistics.materialChanges + renderQueueStatistics.meshChanges };
+            ImGui::Text("Render queue: %u draws, %u pipeline / %u material / %u mesh changes", renderQueueStatistics.drawCount, renderQueueStatistics.pipelineChanges, renderQueueStatistics.materialChanges, renderQueueStatistics.meshChanges);
+            ImGui::Text("Sorting saved %u of %u state changes", unsortedChanges - sortedChanges, unsortedChanges);
+            if (gpuCullingAvailable)
+            {
+                ImGui::Checkbox("GPU Culling", &useGpuCulling);
+            }
+            if (packet.gpuCulling)
+            {
+                ImGui::Text("Scene: %u entities culled on the GPU, %u indirect draws%s", scene.getEntityCount(), to_u32(packet.drawBatches.size()), drawIndirectCountSupported ? "" : " without draw count");
+            }
+            else
+            {
+                ImGui::Text("Scene: %u entities, %u culled", scene.getEntityCount(), culledEntityCount);
+            }
+
+            for (const auto &[name, mesh] : meshes)
+            {
+                if (ImGui::TreeNode(name.c_str()))
+                {
+                    for (uint32_t lodIndex = 0; lodIndex < mesh->lods.size(); ++lodIndex)
+                    {
+                        uint32_t objectCount{ 0 };
+                        const std::vector<uint32_t> &meshIds = scene.getMeshIds();
+                        for (uint32_t entityIndex = 0; entityIndex < meshIds.size(); ++entityIndex)
+                        {
+                            objectCount += meshIds[entityIndex] == mesh->id && packet.lodIndices[entityIndex] == lodIndex;
+                        }
+
+                        const MeshLod &lod = mesh->lods[lodIndex];
+                        ImGui::Text("LOD %u: %u triangles, error %.4f, drawn by %u objects", lodIndex, lod.indexCount / 3, lod.error, objectCount);
+                    }
+                    ImGui::TreePop();
+                }
+            }
             ImGui::EndTabItem();
         }
         ImGui::EndTabBar();
@@ -349,74 +928,293 @@ void MainApp::drawImGuiInterface()
     // ImGui::End();
 
     // ImGui::ShowDemoWindow();
+
+    ImGui::Render();
 }
 
 // TODO: as opposed to doing slot based binding of descriptor sets which leads to multiple vkCmdBindDescriptorSets calls per drawcall, you can use
 // frequency based descriptor sets and use dynamicOffsetCount: see https://zeux.io/2020/02/27/writing-an-efficient-vulkan-renderer/, or just bindless
 // decriptors altogether
-void MainApp::drawObjects()
+void MainApp::drawObjects(const FramePacket &packet, std::vector<std::shared_ptr<CommandBuffer>> &recordedCommandBuffers)
 {
     // Update camera buffer
-    CameraData cameraData{};
-    cameraData.view = cameraController->getCamera()->getView();
-    cameraData.proj = cameraController->getCamera()->getProjection();
+    RingAllocation cameraAllocation;
+    if (!frameRingBuffer->allocate(sizeof(CameraData), uniformBufferAlignment, cameraAllocation))
+    {
+        LOGEANDABORT("The frame ring buffer is out of space for the camera data");
+    }
+    memcpy(cameraAllocation.mappedData, &packet.camera, sizeof(CameraData));
+    frameRingBuffer->flush(cameraAllocation);
 
-    void *mappedData = frameData.globalBuffers[currentFrame]->map();
-    memcpy(mappedData, &cameraData, sizeof(cameraData));
-    frameData.globalBuffers[currentFrame]->unmap();
+    uint32_t cameraOffset{ to_u32(cameraAllocation.offset) };
+    uint32_t objectOffset{ to_u32(objectBuffer->regionSize * currentFrame) };
 
-    // Update object buffer
-    mappedData = frameData.objectBuffers[currentFrame]->map();
-    ObjectData *objectSSBO = (ObjectData *)mappedData;
-    for (int index = 0; index < renderables.size(); index++)
+    if (packet.gpuCulling)
     {
-        objectSSBO[index].model = renderables[index].transformMatrix;
+        // A handful of indirect draws cover the whole scene, so a single recording slot records it however many objects there are
+        const std::shared_ptr<CommandBuffer> &commandBuffer = frameData.secondaryCommandBuffers[currentFrame].front();
+        recordIndirectDraws(packet, *commandBuffer, cameraOffset, objectOffset);
+        recordedCommandBuffers.push_back(commandBuffer);
+        return;
     }
-    frameData.objectBuffers[currentFrame]->unmap();
 
-    // Draw renderables
-    std::shared_ptr<Mesh> lastMesh = nullptr;
-    std::shared_ptr<Material> lastMaterial = nullptr;
-    for (int index = 0; index < renderables.size(); index++)
+    // Large scenes are split into contiguous ranges of the sorted draws that are recorded in parallel, every range goes into the secondary command buffer of its own recording slot
+    const uint32_t drawCount{ packet.renderQueue.getDrawCount() };
+    const uint32_t taskCount{ std::clamp((drawCount + MIN_OBJECTS_PER_RECORDING_TASK - 1) / MIN_OBJECTS_PER_RECORDING_TASK, 1u, jobSystem->getThreadCount()) };
+    const uint32_t drawsPerTask{ std::max((drawCount + taskCount - 1) / taskCount, 1u) };
+    for (uint32_t firstDraw = 0; firstDraw < drawCount; firstDraw += drawsPerTask)
     {
-        RenderObject object = renderables[index];
+        recordedCommandBuffers.push_back(frameData.secondaryCommandBuffers[currentFrame][firstDraw / drawsPerTask]);
+    }
 
-        // Bind the pipeline if it doesn't match with the already bound one
-        if (object.material != lastMaterial)
-        {
+    jobSystem->parallelFor(drawCount, drawsPerTask, [&](uint32_t firstDraw, uint32_t lastDraw) {
+        recordObjects(packet, *frameData.secondaryCommandBuffers[currentFrame][firstDraw / drawsPerTask], firstDraw, lastDraw, cameraOffset, objectOffset);
+    });
+}
 
-            vkCmdBindPipeline(frameData.commandBuffers[currentFrame]->getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, object.material->pipeline->getHandle());
-            lastMaterial = object.material;
+void MainApp::recordObjects(const FramePacket &packet, CommandBuffer &commandBuffer, uint32_t firstDraw, uint32_t lastDraw, uint32_t cameraOffset, uint32_t objectOffset)
+{
+    commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, frameData.commandBuffers[currentFrame].get());
+
+    // Neither the dynamic state nor the bound buffers are inherited from the primary command buffer
+    setDynamicRenderState(commandBuffer.getHandle());
+
+    // Every mesh lives in the geometry arena so its buffers are only bound once
+    geometryArena->bind(commandBuffer.getHandle());
+
+    // The state changes follow the ids in the sorted keys, materials and meshes are looked up in the tables so no reference counts are touched
+    // They don't change after the scene is created so the simulation stage can run alongside
+    const std::vector<uint64_t> &sortKeys = packet.renderQueue.getSortKeys();
+    const std::vector<uint32_t> &objectIndices = packet.renderQueue.getObjectIndices();
+    uint32_t lastPipelineId{ std::numeric_limits<uint32_t>::max() };
+    uint32_t lastMaterialId{ std::numeric_limits<uint32_t>::max() };
+    uint32_t lastMeshId{ std::numeric_limits<uint32_t>::max() };
+    for (uint32_t drawIndex = firstDraw; drawIndex < lastDraw; drawIndex++)
+    {
+        const uint64_t sortKey{ sortKeys[drawIndex] };
+        const uint32_t objectIndex{ objectIndices[drawIndex] };
+        const uint32_t pipelineId{ RenderQueue::getPipelineId(sortKey) };
+        const uint32_t materialId{ RenderQueue::getMaterialId(sortKey) };
+        const uint32_t meshId{ RenderQueue::getMeshId(sortKey) };
+        const Material &material = *materialTable[materialId];
+        const Mesh &mesh = *meshTable[meshId];
+        const VkPipelineLayout pipelineLayout = material.pipelineState->getPipelineLayout().getHandle();
+
+        bool pipelineChanged{ pipelineId != lastPipelineId };
+        if (pipelineChanged)
+        {
+            vkCmdBindPipeline(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, material.pipeline->getHandle());
+            lastPipelineId = pipelineId;
 
             // Camera data descriptor
-            vkCmdBindDescriptorSets(frameData.commandBuffers[currentFrame]->getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, object.material->pipelineState->getPipelineLayout().getHandle(), 0, 1, &frameData.globalDescriptorSets[currentFrame]->getHandle(), 0, nullptr);
+            vkCmdBindDescriptorSets(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &globalDescriptorSet->getHandle(), 1, &cameraOffset);
 
             // Object data descriptor
-            vkCmdBindDescriptorSets(frameData.commandBuffers[currentFrame]->getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, object.material->pipelineState->getPipelineLayout().getHandle(), 1, 1, &frameData.objectDescriptorSets[currentFrame]->getHandle(), 0, nullptr);
+            vkCmdBindDescriptorSets(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &objectBuffer->descriptorSet->getHandle(), 1, &objectOffset);
+        }
+
+        // A different pipeline always comes with a different material
+        if (materialId != lastMaterialId)
+        {
+            lastMaterialId = materialId;
 
-            if (object.material->textureDescriptorSet != VK_NULL_HANDLE)
+            if (!material.textureDescriptorSets.empty())
             {
                 // Texture descriptor
-                vkCmdBindDescriptorSets(frameData.commandBuffers[currentFrame]->getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, object.material->pipelineState->getPipelineLayout().getHandle(), 2, 1, &object.material->textureDescriptorSet->getHandle(), 0, nullptr);
-
+                vkCmdBindDescriptorSets(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 2, 1, &material.textureDescriptorSets[currentFrame]->getHandle(), 0, nullptr);
             }
         }
 
-        // Bind the mesh if it's a different one from last one
-        if (object.mesh != lastMesh)
+        bool meshChanged{ meshId != lastMeshId };
+        lastMeshId = meshId;
+
+        if (useQuantizedVertices && (pipelineChanged || meshChanged))
         {
-            VkBuffer vertexBuffers[] = { object.mesh->vertexBuffer->getHandle() };
-            VkDeviceSize offsets[] = { 0 };
-            vkCmdBindVertexBuffers(frameData.commandBuffers[currentFrame]->getHandle(), 0, 1, vertexBuffers, offsets);
-            vkCmdBindIndexBuffer(frameData.commandBuffers[currentFrame]->getHandle(), object.mesh->indexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
+            vkCmdPushConstants(commandBuffer.getHandle(), pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::vec4), &mesh.textureCoordinateTransform);
+        }
+
+        // The object index is the instance index, which the shaders use to read the model matrix
+        const MeshLod &lod = mesh.lods[packet.lodIndices[objectIndex]];
+        const GeometryAllocation &geometry = geometryArena->getAllocation(mesh.geometry);
+        vkCmdDrawIndexed(commandBuffer.getHandle(), lod.indexCount, 1, geometry.firstIndex + lod.firstIndex, geometry.vertexOffset, objectIndex);
+    }
+
+    commandBuffer.end();
+}
 
-            lastMesh = object.mesh;
+void MainApp::updateObjectBuffer(const FramePacket &packet)
+{
+    // Replaced with a buffer twice as large when the scene outgrew it
+    const uint32_t objectCount{ to_u32(packet.objects.size()) };
+    if (objectCount > objectBuffer->capacity)
+    {
+        uint32_t capacity{ objectBuffer->capacity };
+        while (capacity < objectCount)
+        {
+            capacity *= 2;
         }
+        createObjectBuffer(capacity);
+    }
 
-        vkCmdDrawIndexed(frameData.commandBuffers[currentFrame]->getHandle(), to_u32(object.mesh->indices.size()), 1, 0, 0, index);
+    objectBuffer->buffer->update(reinterpret_cast<const uint8_t *>(packet.objects.data()), sizeof(ObjectData) * objectCount, objectBuffer->regionSize * currentFrame);
+    if (packet.gpuCulling)
+    {
+        objectBuffer->cullInstanceBuffer->update(reinterpret_cast<const uint8_t *>(packet.cullInstances.data()), sizeof(CullInstance) * objectCount, objectBuffer->cullInstanceRegionSize * currentFrame);
     }
 }
 
+void MainApp::dispatchCulling(const FramePacket &packet, CommandBuffer &commandBuffer)
+{
+    // The first command of every batch and the bounds and LODs of every mesh, rewritten every frame since defragmenting the geometry arena moves the LODs
+    RingAllocation cullAllocation;
+    if (!frameRingBuffer->allocate(MAX_DRAW_BATCH_COUNT * sizeof(uint32_t) + MAX_CULL_MESH_COUNT * sizeof(CullMesh), storageBufferAlignment, cullAllocation))
+    {
+        LOGEANDABORT("The frame ring buffer is out of space for the culling data");
+    }
+
+    uint32_t *batchFirstCommands = static_cast<uint32_t *>(cullAllocation.mappedData);
+    for (uint32_t batchIndex = 0; batchIndex < packet.drawBatches.size(); ++batchIndex)
+    {
+        batchFirstCommands[batchIndex] = packet.drawBatches[batchIndex].firstCommand;
+    }
+
+    CullMesh *cullMeshes = reinterpret_cast<CullMesh *>(batchFirstCommands + MAX_DRAW_BATCH_COUNT);
+    for (const Mesh *mesh : meshTable)
+    {
+        // The model matrices include the dequantization, so the bounds are taken into the space of the quantized vertices
+        const glm::mat4 quantizationMatrix = glm::inverse(mesh->dequantizationMatrix);
+        glm::vec3 center = glm::vec3{ quantizationMatrix * glm::vec4{ (mesh->boundsMin + mesh->boundsMax) * 0.5f, 1.0f } };
+        glm::vec3 halfSize = (mesh->boundsMax - mesh->boundsMin) * 0.5f;
+        glm::vec3 extent{ 0.0f };
+        for (int column = 0; column < 3; ++column)
+        {
+            extent += glm::abs(glm::vec3{ quantizationMatrix[column] }) * halfSize[column];
+        }
+
+        CullMesh &cullMesh = cullMeshes[mesh->id];
+        cullMesh.boundsCenter = glm::vec4{ center, 0.0f };
+        cullMesh.boundsExtent = glm::vec4{ extent, 0.0f };
+
+        const GeometryAllocation &geometry = geometryArena->getAllocation(mesh->geometry);
+        for (uint32_t lodIndex = 0; lodIndex < mesh->lods.size(); ++lodIndex)
+        {
+            const MeshLod &lod = mesh->lods[lodIndex];
+            cullMesh.lods[lodIndex] = glm::uvec4{ lod.indexCount, geometry.firstIndex + lod.firstIndex, static_cast<uint32_t>(geometry.vertexOffset), 0u };
+        }
+    }
+    frameRingBuffer->flush(cullAllocation);
+
+    // The draw counts start at zero, and without a draw count every command is drawn so the ones the shader doesn't write must draw nothing
+    const VkCommandBuffer handle = commandBuffer.getHandle();
+    const VkDeviceSize drawOffset{ objectBuffer->drawRegionSize * currentFrame };
+    VkDeviceSize clearSize{ MAX_DRAW_BATCH_COUNT * sizeof(uint32_t) };
+    if (!drawIndirectCountSupported && !packet.drawBatches.empty())
+    {
+        clearSize += (packet.drawBatches.back().firstCommand + packet.drawBatches.back().maxDrawCount) * sizeof(VkDrawIndexedIndirectCommand);
+    }
+    vkCmdFillBuffer(handle, objectBuffer->drawBuffer->getHandle(), drawOffset, clearSize, 0u);
+
+    VkMemoryBarrier clearBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(handle, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+    CullConstants constants{};
+    const Frustum frustum = Frustum::fromViewProjection(packet.camera.proj * packet.camera.view);
+    std::copy(frustum.planes.begin(), frustum.planes.end(), constants.frustumPlanes);
+    constants.objectCount = to_u32(packet.cullInstances.size());
+
+    // In the order of the bindings: objects, cull instances, culling data and draws
+    std::array<uint32_t, 4> dynamicOffsets{
+        to_u32(objectBuffer->regionSize * currentFrame),
+        to_u32(objectBuffer->cullInstanceRegionSize * currentFrame),
+        to_u32(cullAllocation.offset),
+        to_u32(drawOffset)
+    };
+    vkCmdBindPipeline(handle, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipeline->getHandle());
+    vkCmdBindDescriptorSets(handle, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout->getHandle(), 0, 1, &objectBuffer->cullDescriptorSet->getHandle(), to_u32(dynamicOffsets.size()), dynamicOffsets.data());
+    vkCmdPushConstants(handle, cullPipelineLayout->getHandle(), VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants), &constants);
+    vkCmdDispatch(handle, (constants.objectCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+
+    VkMemoryBarrier cullBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+    cullBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    cullBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(handle, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &cullBarrier, 0, nullptr, 0, nullptr);
+}
+
+void MainApp::recordIndirectDraws(const FramePacket &packet, CommandBuffer &commandBuffer, uint32_t cameraOffset, uint32_t objectOffset)
+{
+    commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, frameData.commandBuffers[currentFrame].get());
+    setDynamicRenderState(commandBuffer.getHandle());
+    geometryArena->bind(commandBuffer.getHandle());
+
+    // The draw counts come first in the region of this frame, followed by the commands of every batch
+    const VkBuffer drawBuffer = objectBuffer->drawBuffer->getHandle();
+    const VkDeviceSize drawOffset{ objectBuffer->drawRegionSize * currentFrame };
+    const VkDeviceSize commandsOffset{ drawOffset + MAX_DRAW_BATCH_COUNT * sizeof(uint32_t) };
+    uint32_t lastPipelineId{ std::numeric_limits<uint32_t>::max() };
+    uint32_t lastMaterialId{ std::numeric_limits<uint32_t>::max() };
+    uint32_t lastMeshId{ std::numeric_limits<uint32_t>::max() };
+    for (uint32_t batchIndex = 0; batchIndex < packet.drawBatches.size(); ++batchIndex)
+    {
+        const DrawBatch &batch = packet.drawBatches[batchIndex];
+        const Material &material = *materialTable[batch.materialId];
+        const Mesh &mesh = *meshTable[batch.meshId];
+        const VkPipelineLayout pipelineLayout = material.pipelineState->getPipelineLayout().getHandle();
+
+        // The same state changes as recordObjects, only once per batch instead of once per object
+        bool pipelineChanged{ material.pipelineId != lastPipelineId };
+        if (pipelineChanged)
+        {
+            vkCmdBindPipeline(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, material.pipeline->getHandle());
+            lastPipelineId = material.pipelineId;
+
+            vkCmdBindDescriptorSets(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &globalDescriptorSet->getHandle(), 1, &cameraOffset);
+            vkCmdBindDescriptorSets(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 1, 1, &objectBuffer->descriptorSet->getHandle(), 1, &objectOffset);
+        }
+
+        if (batch.materialId != lastMaterialId)
+        {
+            lastMaterialId = batch.materialId;
+
+            if (!material.textureDescriptorSets.empty())
+            {
+                vkCmdBindDescriptorSets(commandBuffer.getHandle(), VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 2, 1, &material.textureDescriptorSets[currentFrame]->getHandle(), 0, nullptr);
+            }
+        }
+
+        bool meshChanged{ batch.meshId != lastMeshId };
+        lastMeshId = batch.meshId;
+
+        if (useQuantizedVertices && (pipelineChanged || meshChanged))
+        {
+            vkCmdPushConstants(commandBuffer.getHandle(), pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::vec4), &mesh.textureCoordinateTransform);
+        }
+
+        const VkDeviceSize commandOffset{ commandsOffset + batch.firstCommand * sizeof(VkDrawIndexedIndirectCommand) };
+        if (drawIndirectCountSupported)
+        {
+            vkCmdDrawIndexedIndirectCountKHR(commandBuffer.getHandle(), drawBuffer, commandOffset, drawBuffer, drawOffset + batchIndex * sizeof(uint32_t), batch.maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+        }
+        else
+        {
+            vkCmdDrawIndexedIndirect(commandBuffer.getHandle(), drawBuffer, commandOffset, batch.maxDrawCount, sizeof(VkDrawIndexedIndirectCommand));
+        }
+    }
+
+    commandBuffer.end();
+}
+
+void MainApp::setDynamicRenderState(VkCommandBuffer commandBuffer) const
+{
+    // The pipelines are created with a dynamic viewport and scissor so they don't have to be recreated when the render extent changes
+    VkExtent2D extent = getRenderExtent();
+    VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    VkRect2D scissor{ { 0, 0 }, extent };
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
+
 void MainApp::setupTimer()
 {
     drawingTimer = std::make_unique<Timer>();
@@ -425,7 +1223,7 @@ void MainApp::setupTimer()
 
 void MainApp::createInstance()
 {
-    instance = std::make_unique<Instance>(getName());
+    instance = std::make_unique<Instance>(getName(), platform.getWindow().getRequiredSurfaceExtensions());
     g_instance = instance->getHandle();
 }
 
@@ -437,19 +1235,40 @@ void MainApp::createSurface()
 
 void MainApp::createDevice()
 {
+    std::unique_ptr<PhysicalDevice> physicalDevice = instance->getSuitablePhysicalDevice();
+
     VkPhysicalDeviceFeatures deviceFeatures{};
     deviceFeatures.samplerAnisotropy = VK_TRUE;
+    // Textures are uploaded block compressed when available and fall back to RGBA8 otherwise
+    deviceFeatures.textureCompressionBC = physicalDevice->getFeatures().textureCompressionBC;
+    // GPU culling writes an indirect command per visible object, with the object index as its first instance, and draws a batch of them at once
+    deviceFeatures.multiDrawIndirect = physicalDevice->getFeatures().multiDrawIndirect;
+    deviceFeatures.drawIndirectFirstInstance = physicalDevice->getFeatures().drawIndirectFirstInstance;
 
-    std::unique_ptr<PhysicalDevice> physicalDevice = instance->getSuitablePhysicalDevice();
     physicalDevice->setRequestedFeatures(deviceFeatures);
 
+    if (!platform.isHeadless())
+    {
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+    // Frames are paced with a timeline semaphore instead of a fence per frame in flight
+    deviceExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+
     device = std::make_unique<Device>(std::move(physicalDevice), surface, deviceExtensions);
+
+    gpuCullingAvailable = useGpuCulling && deviceFeatures.multiDrawIndirect && deviceFeatures.drawIndirectFirstInstance;
+    if (useGpuCulling && !gpuCullingAvailable)
+    {
+        LOGW("The device doesn't support multi draw indirect with a first instance, objects are culled on the CPU");
+        useGpuCulling = false;
+    }
+    drawIndirectCountSupported = device->isExtensionEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
 }
 
 void MainApp::createSwapchain()
 {
     const std::set<VkImageUsageFlagBits> imageUsageFlags{ VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT };
-    swapchain = std::make_unique<Swapchain>(*device, surface, VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR, VK_PRESENT_MODE_FIFO_KHR, imageUsageFlags);
+    swapchain = std::make_unique<Swapchain>(*device, surface, VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR, getLatencyProfilePresentModes(latencyProfile), imageUsageFlags);
 }
 
 void MainApp::createSwapchainImageViews()
@@ -461,10 +1280,26 @@ void MainApp::createSwapchainImageViews()
     }
 }
 
+void MainApp::createOffscreenRenderTargets()
+{
+    VkExtent2D windowExtent = Window::getWindowExtent();
+    VkExtent3D extent{ windowExtent.width, windowExtent.height, 1u };
+
+    offscreenImages.reserve(maxFramesInFlight);
+    offscreenImageViews.reserve(maxFramesInFlight);
+    for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+    {
+        offscreenImages.emplace_back(std::make_unique<Image>(*device, offscreenColorFormat, extent, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_GPU_ONLY /* default values for remaining params */));
+        offscreenImageViews.emplace_back(std::make_unique<ImageView>(*offscreenImages[i], VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, offscreenColorFormat));
+    }
+}
+
 void MainApp::setupCamera()
 {
-    cameraController = std::make_unique<CameraController>(swapchain->getProperties().imageExtent.width, swapchain->getProperties().imageExtent.height);
-    cameraController->getCamera()->setPerspectiveProjection(45.0f, swapchain->getProperties().imageExtent.width / (float)swapchain->getProperties().imageExtent.height, 0.1f, 100.0f);
+    VkExtent2D extent = getRenderExtent();
+    cameraController = std::make_unique<CameraController>(extent.width, extent.height);
+    cameraExtent = extent;
+    cameraController->getCamera()->setPerspectiveProjection(45.0f, extent.width / (float)extent.height, 0.1f, 100.0f);
     cameraController->getCamera()->setView(glm::vec3(2.0f, 2.0f, 2.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 }
 
@@ -472,14 +1307,15 @@ void MainApp::createRenderPass()
 {
     std::vector<Attachment> attachments;
     Attachment colorAttachment{};
-    colorAttachment.format = swapchain->getProperties().surfaceFormat.format;
+    colorAttachment.format = getRenderFormat();
     colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Offscreen targets are left ready to be copied out since there is nothing to present them to
+    colorAttachment.finalLayout = platform.isHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
     attachments.push_back(colorAttachment);
 
     VkAttachmentReference colorAttachmentRef{};
@@ -529,7 +1365,7 @@ void MainApp::createDescriptorSetLayouts()
     // Global descriptor set layout
     VkDescriptorSetLayoutBinding uboLayoutBinding{};
     uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     uboLayoutBinding.descriptorCount = 1;
     uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     uboLayoutBinding.pImmutableSamplers = nullptr; // Optional
@@ -541,7 +1377,7 @@ void MainApp::createDescriptorSetLayouts()
     VkDescriptorSetLayoutBinding objectLayoutBinding{};
     objectLayoutBinding.binding = 0;
     objectLayoutBinding.descriptorCount = 1;
-    objectLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    objectLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
     objectLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
     objectLayoutBinding.pImmutableSamplers = nullptr;
 
@@ -558,6 +1394,23 @@ void MainApp::createDescriptorSetLayouts()
 
     std::vector<VkDescriptorSetLayoutBinding> textureDescriptorSetLayoutBindings{ samplerLayoutBinding };
     singleTextureDescriptorSetLayout = std::make_unique<DescriptorSetLayout>(*device, textureDescriptorSetLayoutBindings);
+
+    if (gpuCullingAvailable)
+    {
+        // Culling descriptor set layout: objects, cull instances, culling data and draws, all in per frame regions
+        std::vector<VkDescriptorSetLayoutBinding> cullDescriptorSetLayoutBindings;
+        for (uint32_t binding = 0; binding < 4; ++binding)
+        {
+            VkDescriptorSetLayoutBinding cullLayoutBinding{};
+            cullLayoutBinding.binding = binding;
+            cullLayoutBinding.descriptorCount = 1;
+            cullLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            cullLayoutBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+            cullLayoutBinding.pImmutableSamplers = nullptr;
+            cullDescriptorSetLayoutBindings.push_back(cullLayoutBinding);
+        }
+        cullDescriptorSetLayout = std::make_unique<DescriptorSetLayout>(*device, cullDescriptorSetLayoutBindings);
+    }
 }
 
 std::shared_ptr<Material> MainApp::createMaterial(std::shared_ptr<GraphicsPipeline> pipeline, std::shared_ptr<PipelineState> pipelineState, const std::string &name)
@@ -565,63 +1418,72 @@ std::shared_ptr<Material> MainApp::createMaterial(std::shared_ptr<GraphicsPipeli
     std::shared_ptr<Material> material = std::make_shared<Material>();
     material->pipeline = pipeline;
     material->pipelineState = pipelineState;
+
+    material->id = to_u32(materialTable.size());
+    auto samePipeline = std::find_if(materialTable.begin(), materialTable.end(), [&](const Material *other) { return other->pipeline == pipeline; });
+    material->pipelineId = samePipeline != materialTable.end() ? (*samePipeline)->pipelineId : pipelineCount++;
+    if (material->id >> RenderQueue::MATERIAL_BITS != 0 || material->pipelineId >> RenderQueue::PIPELINE_BITS != 0)
+    {
+        LOGEANDABORT("There are more materials or pipelines than the render queue sort keys can address");
+    }
+    materialTable.push_back(material.get());
+
     materials[name] = material;
     return material;
 }
 
+void MainApp::addMesh(const std::string &name, std::shared_ptr<Mesh> mesh)
+{
+    mesh->id = to_u32(meshTable.size());
+    if (mesh->id >> RenderQueue::MESH_BITS != 0)
+    {
+        LOGEANDABORT("There are more meshes than the render queue sort keys can address");
+    }
+    meshTable.push_back(mesh.get());
+
+    meshes[name] = mesh;
+}
+
 void MainApp::createGraphicsPipelines()
 {
-    // Setup pipeline
-    VertexInputState vertexInputState{};
-    vertexInputState.bindingDescriptions.reserve(1);
-    vertexInputState.attributeDescriptions.reserve(3);
-
-    VkVertexInputBindingDescription bindingDescription{};
-    bindingDescription.binding = 0;
-    bindingDescription.stride = sizeof(Vertex);
-    bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-    vertexInputState.bindingDescriptions.emplace_back(bindingDescription);
-
-    // Position at location 0
-    VkVertexInputAttributeDescription positionAttributeDescription;
-    positionAttributeDescription.binding = 0;
-    positionAttributeDescription.location = 0;
-    positionAttributeDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-    positionAttributeDescription.offset = offsetof(Vertex, position);
-    // Normal at location 1
-    VkVertexInputAttributeDescription normalAttributeDescription;
-    normalAttributeDescription.binding = 0;
-    normalAttributeDescription.location = 1;
-    normalAttributeDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-    normalAttributeDescription.offset = offsetof(Vertex, normal);
-    // Color at location 2
-    VkVertexInputAttributeDescription colorAttributeDescription;
-    colorAttributeDescription.binding = 0;
-    colorAttributeDescription.location = 2;
-    colorAttributeDescription.format = VK_FORMAT_R32G32B32_SFLOAT;
-    colorAttributeDescription.offset = offsetof(Vertex, color);
-    // TexCoord at location 3
-    VkVertexInputAttributeDescription textureCoordinateAttributeDescription;
-    textureCoordinateAttributeDescription.binding = 0;
-    textureCoordinateAttributeDescription.location = 3;
-    textureCoordinateAttributeDescription.format = VK_FORMAT_R32G32_SFLOAT;
-    textureCoordinateAttributeDescription.offset = offsetof(Vertex, textureCoordinate);
-
-    vertexInputState.attributeDescriptions.emplace_back(positionAttributeDescription);
-    vertexInputState.attributeDescriptions.emplace_back(normalAttributeDescription);
-    vertexInputState.attributeDescriptions.emplace_back(colorAttributeDescription);
-    vertexInputState.attributeDescriptions.emplace_back(textureCoordinateAttributeDescription);
+    // Setup pipeline, the attribute locations are position 0, normal 1, color 2 and texture coordinate 3
+    VertexLayout vertexLayout;
+    uint32_t vertexSize;
+    if (useQuantizedVertices)
+    {
+        vertexLayout.addAttribute(0, VK_FORMAT_R16G16B16A16_SNORM)
+            .addAttribute(1, VK_FORMAT_R16G16_SNORM)
+            .addAttribute(3, VK_FORMAT_R16G16_UNORM);
+        vertexSize = sizeof(QuantizedVertex);
+    }
+    else
+    {
+        vertexLayout.addAttribute(0, VK_FORMAT_R32G32B32_SFLOAT)
+            .addAttribute(1, VK_FORMAT_R32G32B32_SFLOAT)
+            .addAttribute(2, VK_FORMAT_R32G32B32_SFLOAT)
+            .addAttribute(3, VK_FORMAT_R32G32_SFLOAT);
+        vertexSize = sizeof(Vertex);
+    }
+
+    if (vertexLayout.getStride() != vertexSize)
+    {
+        LOGEANDABORT("The vertex layout stride {} doesn't match the vertex size {}", vertexLayout.getStride(), vertexSize);
+    }
+
+    VertexInputState vertexInputState = vertexLayout.createVertexInputState();
 
     InputAssemblyState inputAssemblyState{};
     inputAssemblyState.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
     inputAssemblyState.primitiveRestartEnable = VK_FALSE;
 
+    // The viewport and scissor are dynamic, these only set their counts and the initial extent
     ViewportState viewportState{};
-    VkViewport viewport{ 0.0f, 0.0f, swapchain->getProperties().imageExtent.width, swapchain->getProperties().imageExtent.height, 0.0f, 1.0f };
+    VkExtent2D extent = getRenderExtent();
+    VkViewport viewport{ 0.0f, 0.0f, static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f };
     viewportState.viewports.emplace_back(viewport);
     VkRect2D scissor{};
     scissor.offset = { 0, 0 };
-    scissor.extent = swapchain->getProperties().imageExtent;
+    scissor.extent = extent;
     viewportState.scissors.emplace_back(scissor);
 
     RasterizationState rasterizationState{};
@@ -664,7 +1526,7 @@ void MainApp::createGraphicsPipelines()
     colorBlendState.blendConstants[2] = 0.0f;
     colorBlendState.blendConstants[3] = 0.0f;
 
-    std::shared_ptr<ShaderSource> vertexShader = std::make_shared<ShaderSource>("../../../src/shaders/main.vert.spv");
+    std::shared_ptr<ShaderSource> vertexShader = std::make_shared<ShaderSource>(useQuantizedVertices ? "../../../src/shaders/main_quantized.vert.spv" : "../../../src/shaders/main.vert.spv");
     std::shared_ptr<ShaderSource> defaultFragmentShader = std::make_shared<ShaderSource>("../../../src/shaders/default.frag.spv");
     std::shared_ptr<ShaderSource> texturedFragmentShader = std::make_shared<ShaderSource>("../../../src/shaders/textured.frag.spv");
 
@@ -677,6 +1539,11 @@ void MainApp::createGraphicsPipelines()
         objectDescriptorSetLayout->getHandle()
     };
     std::vector<VkPushConstantRange> pushConstantRangeHandles;
+    if (useQuantizedVertices)
+    {
+        // Texture coordinate dequantization transform of the bound mesh
+        pushConstantRangeHandles.push_back({ VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(glm::vec4) });
+    }
 
     // Create default mesh materials
     std::shared_ptr<PipelineState> defaultMeshPipelineState = std::make_shared<PipelineState>(
@@ -722,193 +1589,323 @@ void MainApp::createGraphicsPipelines()
     createMaterial(texturedMeshPipeline, texturedMeshPipelineState, "texturedmesh");
 }
 
+void MainApp::createComputePipelines()
+{
+    if (!gpuCullingAvailable)
+    {
+        return;
+    }
+
+    std::shared_ptr<ShaderSource> cullShader = std::make_shared<ShaderSource>("../../../src/shaders/cull.comp.spv");
+    cullShaderModules.emplace_back(*device, VK_SHADER_STAGE_COMPUTE_BIT, cullShader);
+
+    std::vector<VkDescriptorSetLayout> descriptorSetLayoutHandles{ cullDescriptorSetLayout->getHandle() };
+    std::vector<VkPushConstantRange> pushConstantRangeHandles{ { VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullConstants) } };
+    cullPipelineLayout = std::make_unique<PipelineLayout>(*device, cullShaderModules, descriptorSetLayoutHandles, pushConstantRangeHandles);
+    cullPipeline = std::make_unique<ComputePipeline>(*device, *cullPipelineLayout, nullptr);
+}
+
 void MainApp::createFramebuffers()
 {
-    swapchainFramebuffers.reserve(swapchain->getImages().size());
-    for (uint32_t i = 0; i < swapchain->getImages().size(); ++i)
+    const std::vector<std::unique_ptr<ImageView>> &colorImageViews = platform.isHeadless() ? offscreenImageViews : swapChainImageViews;
+
+    framebuffers.reserve(colorImageViews.size());
+    for (uint32_t i = 0; i < colorImageViews.size(); ++i)
+    {
+        std::vector<VkImageView> attachments{ colorImageViews[i]->getHandle(), depthImageView->getHandle() };
+
+        framebuffers.emplace_back(std::make_unique<Framebuffer>(*device, getRenderExtent(), *renderPass, attachments));
+    }
+}
+
+// Logs the cost per job of scheduling and running empty jobs, which is the overhead every parallel loop pays on top of its work
+static void logJobSchedulingOverhead(JobSystem &jobSystem)
+{
+    const uint32_t jobCount{ 100000 };
+    Timer timer;
+
+    ThreadPool threadPool{ jobSystem.getThreadCount() };
+    std::vector<std::future<void>> futures;
+    futures.reserve(jobCount);
+    timer.start();
+    for (uint32_t i = 0; i < jobCount; ++i)
+    {
+        futures.push_back(threadPool.push([]() {}));
+    }
+    for (std::future<void> &future : futures)
     {
-        std::vector<VkImageView> attachments{ swapChainImageViews[i]->getHandle(), depthImageView->getHandle() };
+        future.get();
+    }
+    double threadPoolTime = timer.stop<Timer::Nanoseconds>() / jobCount;
 
-        swapchainFramebuffers.emplace_back(std::make_unique<Framebuffer>(*device, *swapchain, *renderPass, attachments));
+    JobCounter counter;
+    timer.start();
+    for (uint32_t i = 0; i < jobCount; ++i)
+    {
+        jobSystem.schedule([]() {}, &counter);
+    }
+    jobSystem.wait(counter);
+    double jobSystemTime = timer.stop<Timer::Nanoseconds>() / jobCount;
+
+    std::atomic<uint32_t> rangeCount{ 0 };
+    timer.start();
+    jobSystem.parallelFor(jobCount, 1, [&rangeCount](uint32_t first, uint32_t last) { rangeCount.fetch_add(last - first, std::memory_order_relaxed); });
+    double parallelForTime = timer.stop<Timer::Nanoseconds>() / jobCount;
+
+    LOGI("Scheduling overhead per job: thread pool {:.0f} ns, job system {:.0f} ns, parallel for {:.0f} ns", threadPoolTime, jobSystemTime, parallelForTime);
+}
+
+void MainApp::createJobSystem()
+{
+    jobSystem = std::make_unique<JobSystem>();
+    LOGI("Running jobs on {} threads", jobSystem->getThreadCount());
+    if (benchmarkJobSystem)
+    {
+        logJobSchedulingOverhead(*jobSystem);
     }
 }
 
 void MainApp::createCommandPools()
 {
+    // One slot per recording thread plus the one of the main thread
+    const uint32_t recordingSlotCount{ jobSystem->getThreadCount() + 1 };
+
+    // Only the pools of frames that don't have one yet are created, so this also grows the pools when the number of frames in flight increases
+    frameData.commandPools.resize(maxFramesInFlight);
+    frameData.secondaryCommandPools.resize(maxFramesInFlight);
     for (uint32_t i = 0; i < maxFramesInFlight; ++i)
     {
-        frameData.commandPools[i] = std::make_unique<CommandPool>(*device, device->getOptimalGraphicsQueue().getFamilyIndex(), VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+        if (frameData.commandPools[i])
+        {
+            continue;
+        }
+        // The command buffers are rerecorded every frame and reset through their pool once the frame completes
+        frameData.commandPools[i] = std::make_unique<CommandPool>(*device, device->getOptimalGraphicsQueue().getFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT);
+
+        for (uint32_t slot = 0; slot < recordingSlotCount; ++slot)
+        {
+            frameData.secondaryCommandPools[i].push_back(std::make_unique<CommandPool>(*device, device->getOptimalGraphicsQueue().getFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT));
+        }
     }
 }
 
 void MainApp::createCommandBuffers()
 {
+    frameData.commandBuffers.resize(maxFramesInFlight);
     for (uint32_t i = 0; i < maxFramesInFlight; ++i)
     {
-        frameData.commandBuffers[i] = std::make_unique<CommandBuffer>(*frameData.commandPools[i], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        if (frameData.commandBuffers[i])
+        {
+            continue;
+        }
+        frameData.commandBuffers[i] = frameData.commandPools[i]->requestCommandBuffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     }
-}
-
-// TODO create a new command pool and allocate the command buffer using requestCommandBuffer
-void MainApp::transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
-{
-    std::unique_ptr<CommandBuffer> commandBuffer = std::make_unique<CommandBuffer>(*frameData.commandPools[currentFrame], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
-
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags sourceStage;
-    VkPipelineStageFlags destinationStage;
 
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
-    {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-        sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    }
-    else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+    frameData.secondaryCommandBuffers.resize(maxFramesInFlight);
+    for (uint32_t i = 0; i < maxFramesInFlight; ++i)
     {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+        if (!frameData.secondaryCommandBuffers[i].empty())
+        {
+            continue;
+        }
 
-        sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-    else
-    {
-        LOGEANDABORT("unsupported layout transition!");
+        for (const std::unique_ptr<CommandPool> &secondaryCommandPool : frameData.secondaryCommandPools[i])
+        {
+            frameData.secondaryCommandBuffers[i].push_back(secondaryCommandPool->requestCommandBuffer(VK_COMMAND_BUFFER_LEVEL_SECONDARY));
+        }
     }
-
-    vkCmdPipelineBarrier(
-        commandBuffer->getHandle(),
-        sourceStage, destinationStage,
-        0,
-        0, nullptr,
-        0, nullptr,
-        1, &barrier
-    );
-
-    commandBuffer->end();
-
-    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer->getHandle();
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
 }
 
-// TODO create a new command pool and allocate the command buffer using requestCommandBuffer
-void MainApp::copyBufferToImage(const Buffer &srcBuffer, const Image &dstImage, uint32_t width, uint32_t height)
+void MainApp::createUploadContext()
 {
-    std::unique_ptr<CommandBuffer> commandBuffer = std::make_unique<CommandBuffer>(*frameData.commandPools[currentFrame], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
-
-    VkBufferImageCopy region{};
-    region.bufferOffset = 0;
-    region.bufferRowLength = 0;
-    region.bufferImageHeight = 0;
-    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    region.imageSubresource.mipLevel = 0;
-    region.imageSubresource.baseArrayLayer = 0;
-    region.imageSubresource.layerCount = 1;
-    region.imageOffset = { 0, 0, 0 };
-    region.imageExtent = { width, height, 1 };
-
-    vkCmdCopyBufferToImage(commandBuffer->getHandle(), srcBuffer.getHandle(), dstImage.getHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-    commandBuffer->end();
-
-    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer->getHandle();
+    uploadContext = std::make_unique<UploadContext>(*device, device->getOptimalGraphicsQueue());
 
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    const Queue &transferQueue = device->getDedicatedTransferQueue();
+    streamingUploadContext = std::make_unique<UploadContext>(*device, transferQueue, device->getOptimalGraphicsQueue());
+    if (streamingUploadContext->transfersOwnership())
+    {
+        LOGI("Streaming textures through the dedicated transfer queue family {}", transferQueue.getFamilyIndex());
+    }
 }
 
 void MainApp::createDepthResources()
 {
     VkFormat depthFormat = getSupportedDepthFormat(device->getPhysicalDevice().getHandle());
 
-    VkExtent3D extent{ swapchain->getProperties().imageExtent.width, swapchain->getProperties().imageExtent.height, 1 };
+    VkExtent3D extent{ getRenderExtent().width, getRenderExtent().height, 1 };
     // TODO: a single depth buffer may not be correct... https://stackoverflow.com/questions/62371266/why-is-a-single-depth-buffer-sufficient-for-this-vulkan-swapchain-render-loop
     // TODO: understand why I don't need to use a staging buffer here to access the depth buffer
     depthImage = std::make_unique<Image>(*device, depthFormat, extent, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VMA_MEMORY_USAGE_GPU_ONLY /* default values for remaining params */);
     depthImageView = std::make_unique<ImageView>(*depthImage, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_DEPTH_BIT, depthFormat);
 }
 
-std::unique_ptr<Image> MainApp::createTextureImage(const char *filename)
+void MainApp::createTextureLoader()
 {
-    int texWidth, texHeight, texChannels;
+    textureLoaderThreadPool = std::make_unique<ThreadPool>();
 
-    stbi_uc *pixels = stbi_load(filename, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
-    if (!pixels) {
-        LOGEANDABORT("failed to load texture image!");
-    }
+    // Textures that aren't block compressed are uploaded as RGBA8
+    const PhysicalDevice &physicalDevice = device->getPhysicalDevice();
+    const bool generateMipmapsOnGpu{ streamingUploadContext->canGenerateMipmaps(VK_FORMAT_R8G8B8A8_SRGB) };
+    textureDecoder = std::make_unique<TextureDecoder>(physicalDevice.getHandle(), physicalDevice.getRequestedFeatures().textureCompressionBC == VK_TRUE, generateMipmapsOnGpu, TEXTURE_DECODE_BUFFER_POOL_SIZE);
+}
 
-    VkDeviceSize imageSize{ static_cast<VkDeviceSize>(texWidth * texHeight * 4) };
-    VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.size = imageSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+std::unique_ptr<Image> MainApp::createTextureImage(const DecodedTexture &decodedTexture)
+{
+    const bool generateMipmaps{ decodedTexture.levels.size() < decodedTexture.mipLevelCount };
 
-    VmaAllocationCreateInfo memoryInfo{};
-    memoryInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    VkImageUsageFlags imageUsage{ VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT };
+    if (generateMipmaps)
+    {
+        // The mip levels are blitted from one another
+        imageUsage |= VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+    }
 
-    std::unique_ptr<Buffer> stagingBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+    std::unique_ptr<Image> textureImage = std::make_unique<Image>(*device, decodedTexture.format, decodedTexture.extent, imageUsage, VMA_MEMORY_USAGE_GPU_ONLY, decodedTexture.mipLevelCount);
 
-    void *mappedData = stagingBuffer->map();
-    memcpy(mappedData, pixels, static_cast<size_t>(imageSize));
-    stagingBuffer->unmap();
+    VkDeviceSize stagingOffset{ 0 };
+    const Buffer &stagingBuffer = stageUpload(*streamingUploadContext, decodedTexture.data.data(), decodedTexture.data.size(), stagingOffset);
 
-    stbi_image_free(pixels);
+    std::vector<VkBufferImageCopy> regions(decodedTexture.levels.size());
+    for (uint32_t level = 0; level < to_u32(decodedTexture.levels.size()); ++level)
+    {
+        regions[level].bufferOffset = stagingOffset + decodedTexture.levels[level].offset;
+        regions[level].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        regions[level].imageSubresource.mipLevel = level;
+        regions[level].imageSubresource.baseArrayLayer = 0;
+        regions[level].imageSubresource.layerCount = 1;
+        regions[level].imageExtent = { decodedTexture.levels[level].width, decodedTexture.levels[level].height, 1u };
+    }
 
-    VkExtent3D extent{ to_u32(texWidth), to_u32(texHeight), 1u };
-    std::unique_ptr<Image> textureImage = std::make_unique<Image>(*device, VK_FORMAT_R8G8B8A8_SRGB, extent, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VMA_MEMORY_USAGE_GPU_ONLY /* default values for remaining params */);
+    streamingUploadContext->transitionImageLayout(*textureImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    streamingUploadContext->copyBufferToImage(stagingBuffer, *textureImage, regions);
 
-    transitionImageLayout(textureImage->getHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    copyBufferToImage(*stagingBuffer, *textureImage, to_u32(texWidth), to_u32(texHeight));
-    transitionImageLayout(textureImage->getHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    if (generateMipmaps)
+    {
+        streamingUploadContext->generateMipmaps(*textureImage);
+    }
+    else
+    {
+        // On a dedicated transfer queue this also hands the image over to the graphics queue
+        streamingUploadContext->transitionImageLayout(*textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
 
     return textureImage;
 }
 
 std::unique_ptr<ImageView> MainApp::createTextureImageView(const Image &textureImage)
 {
-    return std::make_unique<ImageView>(textureImage, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, VK_FORMAT_R8G8B8A8_SRGB);
+    return std::make_unique<ImageView>(textureImage, VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_ASPECT_COLOR_BIT, textureImage.getFormat());
+}
+
+void MainApp::createPlaceholderTexture()
+{
+    // A single grey texel stands in for every texture that is still loading
+    DecodedTexture decodedTexture;
+    decodedTexture.format = VK_FORMAT_R8G8B8A8_SRGB;
+    decodedTexture.extent = { 1u, 1u, 1u };
+    decodedTexture.levels = { MipLevel{ 0, 1u, 1u } };
+    decodedTexture.data = { 128, 128, 128, 255 };
+
+    placeholderTexture = std::make_shared<Texture>();
+    placeholderTexture->image = createTextureImage(decodedTexture);
+    placeholderTexture->imageview = createTextureImageView(*(placeholderTexture->image));
+    // Part of the startup batch, which is flushed before the first frame
+    placeholderTexture->resident = true;
+}
+
+void MainApp::loadTextureAsync(const std::string &name, const std::string &filename)
+{
+    textures[name] = std::make_shared<Texture>();
+    pendingTextureLoads.push_back(PendingTextureLoad{ name, textureLoaderThreadPool->push([this, filename]() { return textureDecoder->decode(filename); }) });
 }
 
 void MainApp::loadTextures()
 {
-    std::shared_ptr<Texture> empireTexture = std::make_shared<Texture>();
-    empireTexture->image = createTextureImage(TEXTURE_PATH.c_str());
-    empireTexture->imageview = createTextureImageView(*(empireTexture->image));
+    loadTextureAsync("empire_diffuse", TEXTURE_PATH);
+}
+
+void MainApp::updateTextureLoads()
+{
+    // Every decode that finished since the last frame is uploaded in a single batch
+    std::vector<std::shared_ptr<Texture>> uploadedTextures;
+    for (auto it = pendingTextureLoads.begin(); it != pendingTextureLoads.end();)
+    {
+        if (it->decode.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            ++it;
+            continue;
+        }
+
+        DecodedTexture decodedTexture = it->decode.get();
+        std::shared_ptr<Texture> texture = textures[it->name];
+        texture->image = createTextureImage(decodedTexture);
+        texture->imageview = createTextureImageView(*(texture->image));
+        uploadedTextures.push_back(texture);
+
+        // The data has been copied to the staging memory, so the buffer can take the next decode
+        textureDecoder->release(decodedTexture);
+        it = pendingTextureLoads.erase(it);
+    }
+
+    if (!uploadedTextures.empty())
+    {
+        const UploadTicket ticket{ streamingUploadContext->submit() };
+        for (std::shared_ptr<Texture> &texture : uploadedTextures)
+        {
+            texture->uploadTicket = ticket;
+        }
+    }
+
+    for (const auto &[name, texture] : textures)
+    {
+        if (texture->image && !texture->resident && streamingUploadContext->isComplete(texture->uploadTicket))
+        {
+            texture->resident = true;
+            LOGI("Texture {} is resident", name);
+        }
+    }
+}
+
+void MainApp::updateTextureDescriptorSets(uint32_t frameIndex)
+{
+    for (const auto &[name, material] : materials)
+    {
+        if (!material->texture || frameIndex >= material->textureDescriptorSets.size())
+        {
+            continue;
+        }
 
-    textures["empire_diffuse"] = empireTexture;
+        const Texture &texture = material->texture->resident ? *(material->texture) : *placeholderTexture;
+        if (material->boundImageViews[frameIndex] == texture.imageview->getHandle())
+        {
+            continue;
+        }
+
+        VkDescriptorImageInfo textureImageInfo{};
+        textureImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        textureImageInfo.imageView = texture.imageview->getHandle();
+        textureImageInfo.sampler = textureSampler->getHandle();
+
+        VkWriteDescriptorSet descriptorWriteCombinedImageSampler{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+        descriptorWriteCombinedImageSampler.dstSet = material->textureDescriptorSets[frameIndex]->getHandle();
+        descriptorWriteCombinedImageSampler.dstBinding = 0;
+        descriptorWriteCombinedImageSampler.dstArrayElement = 0;
+        descriptorWriteCombinedImageSampler.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptorWriteCombinedImageSampler.descriptorCount = 1;
+        descriptorWriteCombinedImageSampler.pImageInfo = &textureImageInfo;
+
+        vkUpdateDescriptorSets(device->getHandle(), 1, &descriptorWriteCombinedImageSampler, 0, nullptr);
+        material->boundImageViews[frameIndex] = texture.imageview->getHandle();
+    }
 }
 
 void MainApp::createTextureSampler()
 {
     VkSamplerCreateInfo samplerInfo{};
     samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    // Magnification keeps the blocky look of the textures, minification filters trilinearly across the mip levels
     samplerInfo.magFilter = VK_FILTER_NEAREST;
-    samplerInfo.minFilter = VK_FILTER_NEAREST;
+    samplerInfo.minFilter = VK_FILTER_LINEAR;
     samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
     samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
@@ -921,280 +1918,432 @@ void MainApp::createTextureSampler()
     samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
     samplerInfo.mipLodBias = 0.0f;
     samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
+    // Textures are still loading when the sampler is created, so it doesn't limit their mip chains
+    samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
 
     textureSampler = std::make_unique<Sampler>(*device, samplerInfo);
 }
 
-void MainApp::copyBufferToBuffer(const Buffer &srcBuffer, const Buffer &dstBuffer, VkDeviceSize size)
+void MainApp::createGeometryArena(const std::vector<std::shared_ptr<Mesh>> &startupMeshes)
 {
-    // TODO: move this elsewhere?
-    std::unique_ptr<CommandBuffer> commandBuffer = std::make_unique<CommandBuffer>(*frameData.commandPools[currentFrame], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    uint64_t vertexCount{ 0 };
+    uint64_t indexCount{ 0 };
+    for (const std::shared_ptr<Mesh> &mesh : startupMeshes)
+    {
+        vertexCount += mesh->vertexCount;
+        indexCount += mesh->indexCount;
+    }
 
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
+    const VkDeviceSize vertexStride{ useQuantizedVertices ? sizeof(QuantizedVertex) : sizeof(Vertex) };
+    const uint32_t vertexCapacity{ static_cast<uint32_t>(std::max<uint64_t>(static_cast<uint64_t>(vertexCount * GEOMETRY_ARENA_HEADROOM), 1)) };
+    const uint32_t indexCapacity{ static_cast<uint32_t>(std::max<uint64_t>(static_cast<uint64_t>(indexCount * GEOMETRY_ARENA_HEADROOM), 1)) };
+    geometryArena = std::make_unique<GeometryArena>(*device, vertexStride, vertexCapacity, indexCapacity);
+}
 
-    VkBufferCopy copyRegion{};
-    copyRegion.size = size;
-    vkCmdCopyBuffer(commandBuffer->getHandle(), srcBuffer.getHandle(), dstBuffer.getHandle(), 1, &copyRegion);
+void MainApp::uploadMeshGeometry(std::shared_ptr<Mesh> mesh)
+{
+    const void *vertexData = mesh->getVertexData();
+    VkDeviceSize vertexDataSize{ sizeof(Vertex) * mesh->vertexCount };
 
-    commandBuffer->end();
+    std::vector<QuantizedVertex> quantizedVertices;
+    if (useQuantizedVertices)
+    {
+        quantizedVertices = mesh->quantizeVertices();
+        vertexData = quantizedVertices.data();
+        vertexDataSize = sizeof(QuantizedVertex) * mesh->vertexCount;
+    }
 
-    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer->getHandle();
+    if (!geometryArena->allocate(mesh->vertexCount, mesh->indexCount, mesh->geometry))
+    {
+        LOGEANDABORT("The geometry arena doesn't have room for a mesh with {} vertices and {} indices", mesh->vertexCount, mesh->indexCount);
+    }
 
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    VkDeviceSize stagingOffset{ 0 };
+    const Buffer &vertexStagingBuffer = stageUpload(*uploadContext, vertexData, vertexDataSize, stagingOffset);
+    geometryArena->uploadVertices(*uploadContext, mesh->geometry, vertexStagingBuffer, stagingOffset);
+
+    const Buffer &indexStagingBuffer = stageUpload(*uploadContext, mesh->getIndexData(), sizeof(uint32_t) * mesh->indexCount, stagingOffset);
+    geometryArena->uploadIndices(*uploadContext, mesh->geometry, indexStagingBuffer, stagingOffset);
 }
 
-void MainApp::createVertexBuffer(std::shared_ptr<Mesh> mesh)
+void MainApp::createFrameRingBuffer()
 {
-    VkDeviceSize bufferSize{ sizeof(mesh->vertices[0]) * mesh->vertices.size() };
-
-    VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.size = bufferSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-
-    VmaAllocationCreateInfo memoryInfo{};
-    memoryInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-    std::unique_ptr<Buffer> stagingBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
-    memoryInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-    mesh->vertexBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+    const VkPhysicalDeviceLimits &limits = device->getPhysicalDevice().getProperties().limits;
+    uniformBufferAlignment = limits.minUniformBufferOffsetAlignment;
+    storageBufferAlignment = limits.minStorageBufferOffsetAlignment;
+
+    VkBufferUsageFlags usage{ VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT };
+    // The streaming uploads read their staging copies from the ring on the transfer queue. Its regions are still recycled with the frame timeline values, since
+    // every streaming batch ends with an acquisition on the graphics queue that waits for the transfer to complete
+    std::vector<uint32_t> queueFamilyIndices{ device->getOptimalGraphicsQueue().getFamilyIndex() };
+    if (streamingUploadContext->transfersOwnership())
+    {
+        queueFamilyIndices.push_back(device->getDedicatedTransferQueue().getFamilyIndex());
+    }
 
-    void *mappedData = stagingBuffer->map();
-    memcpy(mappedData, mesh->vertices.data(), static_cast<size_t>(bufferSize));
-    stagingBuffer->unmap();
-    copyBufferToBuffer(*stagingBuffer, *(mesh->vertexBuffer), bufferSize);
+    frameRingBuffer = std::make_unique<RingBuffer>(*device, FRAME_RING_BUFFER_SIZE, usage, maxFramesInFlight, queueFamilyIndices);
 }
 
-void MainApp::createIndexBuffer(std::shared_ptr<Mesh> mesh)
+const Buffer &MainApp::stageUpload(UploadContext &context, const void *data, VkDeviceSize size, VkDeviceSize &stagingOffset)
 {
-    VkDeviceSize bufferSize{ sizeof(mesh->indices[0]) * mesh->indices.size() };
+    RingAllocation allocation;
+    if (frameRingBuffer->allocate(size, STAGING_BUFFER_ALIGNMENT, allocation))
+    {
+        memcpy(allocation.mappedData, data, static_cast<size_t>(size));
+        frameRingBuffer->flush(allocation);
+
+        stagingOffset = allocation.offset;
+        return frameRingBuffer->getBuffer();
+    }
 
+    // Uploads that don't fit in the ring get a dedicated staging buffer that lives until the upload batch completes
     VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.size = bufferSize;
+    bufferInfo.size = size;
     bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
     VmaAllocationCreateInfo memoryInfo{};
     memoryInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+    memoryInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
 
     std::unique_ptr<Buffer> stagingBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+    stagingBuffer->update(static_cast<const uint8_t *>(data), static_cast<size_t>(size));
 
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
-    memoryInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-
-    mesh->indexBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+    const Buffer &dedicatedBuffer = *stagingBuffer;
+    context.retainStagingBuffer(std::move(stagingBuffer));
 
-    void *mappedData = stagingBuffer->map();
-    memcpy(mappedData, mesh->indices.data(), static_cast<size_t>(bufferSize));
-    stagingBuffer->unmap();
-    copyBufferToBuffer(*stagingBuffer, *(mesh->indexBuffer), bufferSize);
+    stagingOffset = 0;
+    return dedicatedBuffer;
 }
 
-// TODO use push constants to pass in mvp matrix information to the vertext shader
-void MainApp::createUniformBuffers()
+void MainApp::createDescriptorPool()
 {
-    VkDeviceSize bufferSize{ sizeof(CameraData) };
+    std::vector<VkDescriptorPoolSize> poolSizes{};
+    poolSizes.resize(2);
+    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSizes[0].descriptorCount = 1;
+    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSizes[1].descriptorCount = MAX_FRAMES_IN_FLIGHT;
 
-    VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.size = bufferSize;
-    bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    descriptorPool = std::make_unique<DescriptorPool>(*device, poolSizes, 10u, 0);
+}
 
-    VmaAllocationCreateInfo memoryInfo{};
-    memoryInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
+void MainApp::createDescriptorSets()
+{
+    // The camera data is sub-allocated from the frame ring buffer every frame, so a single set bound with a dynamic offset covers every frame in flight
+    // Global Descriptor Set
+    VkDescriptorSetAllocateInfo globalDescriptorSetAllocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    globalDescriptorSetAllocateInfo.descriptorPool = descriptorPool->getHandle();
+    globalDescriptorSetAllocateInfo.descriptorSetCount = 1;
+    globalDescriptorSetAllocateInfo.pSetLayouts = &globalDescriptorSetLayout->getHandle();
+    globalDescriptorSet = std::make_unique<DescriptorSet>(*device, globalDescriptorSetAllocateInfo);
+
+    VkDescriptorBufferInfo cameraBufferInfo{};
+    cameraBufferInfo.buffer = frameRingBuffer->getBuffer().getHandle();
+    cameraBufferInfo.offset = 0;
+    cameraBufferInfo.range = sizeof(CameraData);
+
+    VkWriteDescriptorSet descriptorWriteUniformBuffer{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    descriptorWriteUniformBuffer.dstSet = globalDescriptorSet->getHandle();
+    descriptorWriteUniformBuffer.dstBinding = 0;
+    descriptorWriteUniformBuffer.dstArrayElement = 0;
+    descriptorWriteUniformBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    descriptorWriteUniformBuffer.descriptorCount = 1;
+    descriptorWriteUniformBuffer.pBufferInfo = &cameraBufferInfo;
+    descriptorWriteUniformBuffer.pImageInfo = nullptr; // Optional
+    descriptorWriteUniformBuffer.pTexelBufferView = nullptr; // Optional
+
+    vkUpdateDescriptorSets(device->getHandle(), 1, &descriptorWriteUniformBuffer, 0, nullptr);
+
+    createTextureDescriptorSets();
+}
 
-    for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+void MainApp::createObjectBuffer(uint32_t capacity)
+{
+    const VkDeviceSize objectDataSize{ sizeof(ObjectData) * capacity };
+    if (objectDataSize > device->getPhysicalDevice().getProperties().limits.maxStorageBufferRange)
     {
-        frameData.globalBuffers[i] = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+        LOGEANDABORT("The object data of {} objects exceeds the storage buffer range supported by the device", capacity);
     }
-}
 
-void MainApp::createSSBOs()
-{
-    VkDeviceSize bufferSize{ sizeof(ObjectData) * MAX_OBJECT_COUNT };
+    std::unique_ptr<ObjectBuffer> newObjectBuffer = std::make_unique<ObjectBuffer>();
+    newObjectBuffer->capacity = capacity;
+    newObjectBuffer->regionSize = (objectDataSize + storageBufferAlignment - 1) & ~(storageBufferAlignment - 1);
 
+    // Sized for the most frames in flight so switching latency profiles never needs a new buffer
     VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
-    bufferInfo.size = bufferSize;
+    bufferInfo.size = newObjectBuffer->regionSize * MAX_FRAMES_IN_FLIGHT;
     bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
     VmaAllocationCreateInfo memoryInfo{};
-    memoryInfo.usage = VMA_MEMORY_USAGE_CPU_ONLY;
-
-    for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+    memoryInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+    memoryInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    newObjectBuffer->buffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+
+    // The culling set has four more descriptors
+    std::vector<VkDescriptorPoolSize> poolSizes{ { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, gpuCullingAvailable ? 5u : 1u } };
+    newObjectBuffer->descriptorPool = std::make_unique<DescriptorPool>(*device, poolSizes, gpuCullingAvailable ? 2u : 1u, 0);
+
+    VkDescriptorSetAllocateInfo objectDescriptorSetAllocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+    objectDescriptorSetAllocateInfo.descriptorPool = newObjectBuffer->descriptorPool->getHandle();
+    objectDescriptorSetAllocateInfo.descriptorSetCount = 1;
+    objectDescriptorSetAllocateInfo.pSetLayouts = &objectDescriptorSetLayout->getHandle();
+    newObjectBuffer->descriptorSet = std::make_unique<DescriptorSet>(*device, objectDescriptorSetAllocateInfo);
+
+    VkDescriptorBufferInfo objectBufferInfo{};
+    objectBufferInfo.buffer = newObjectBuffer->buffer->getHandle();
+    objectBufferInfo.offset = 0;
+    objectBufferInfo.range = objectDataSize;
+
+    VkWriteDescriptorSet objectWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    objectWrite.dstSet = newObjectBuffer->descriptorSet->getHandle();
+    objectWrite.dstBinding = 0;
+    objectWrite.dstArrayElement = 0;
+    objectWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    objectWrite.descriptorCount = 1;
+    objectWrite.pBufferInfo = &objectBufferInfo;
+    vkUpdateDescriptorSets(device->getHandle(), 1, &objectWrite, 0, nullptr);
+
+    if (gpuCullingAvailable)
     {
-        frameData.objectBuffers[i] = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+        const VkDeviceSize cullInstanceDataSize{ sizeof(CullInstance) * capacity };
+        newObjectBuffer->cullInstanceRegionSize = (cullInstanceDataSize + storageBufferAlignment - 1) & ~(storageBufferAlignment - 1);
+        bufferInfo.size = newObjectBuffer->cullInstanceRegionSize * MAX_FRAMES_IN_FLIGHT;
+        newObjectBuffer->cullInstanceBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+
+        // Every object has at most one command, in the batch of its material and mesh
+        const VkDeviceSize drawDataSize{ MAX_DRAW_BATCH_COUNT * sizeof(uint32_t) + sizeof(VkDrawIndexedIndirectCommand) * capacity };
+        newObjectBuffer->drawRegionSize = (drawDataSize + storageBufferAlignment - 1) & ~(storageBufferAlignment - 1);
+        bufferInfo.size = newObjectBuffer->drawRegionSize * MAX_FRAMES_IN_FLIGHT;
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        memoryInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+        memoryInfo.flags = 0;
+        newObjectBuffer->drawBuffer = std::make_unique<Buffer>(*device, bufferInfo, memoryInfo);
+
+        VkDescriptorSetAllocateInfo cullDescriptorSetAllocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
+        cullDescriptorSetAllocateInfo.descriptorPool = newObjectBuffer->descriptorPool->getHandle();
+        cullDescriptorSetAllocateInfo.descriptorSetCount = 1;
+        cullDescriptorSetAllocateInfo.pSetLayouts = &cullDescriptorSetLayout->getHandle();
+        newObjectBuffer->cullDescriptorSet = std::make_unique<DescriptorSet>(*device, cullDescriptorSetAllocateInfo);
+
+        std::array<VkDescriptorBufferInfo, 4> cullBufferInfos{};
+        cullBufferInfos[0] = objectBufferInfo;
+        cullBufferInfos[1] = { newObjectBuffer->cullInstanceBuffer->getHandle(), 0, cullInstanceDataSize };
+        cullBufferInfos[2] = { frameRingBuffer->getBuffer().getHandle(), 0, MAX_DRAW_BATCH_COUNT * sizeof(uint32_t) + MAX_CULL_MESH_COUNT * sizeof(CullMesh) };
+        cullBufferInfos[3] = { newObjectBuffer->drawBuffer->getHandle(), 0, drawDataSize };
+
+        std::array<VkWriteDescriptorSet, 4> cullWrites{};
+        for (uint32_t binding = 0; binding < cullWrites.size(); ++binding)
+        {
+            cullWrites[binding] = { VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+            cullWrites[binding].dstSet = newObjectBuffer->cullDescriptorSet->getHandle();
+            cullWrites[binding].dstBinding = binding;
+            cullWrites[binding].dstArrayElement = 0;
+            cullWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+            cullWrites[binding].descriptorCount = 1;
+            cullWrites[binding].pBufferInfo = &cullBufferInfos[binding];
+        }
+        vkUpdateDescriptorSets(device->getHandle(), to_u32(cullWrites.size()), cullWrites.data(), 0, nullptr);
     }
-}
-
-void MainApp::createDescriptorPool()
-{
-    std::vector<VkDescriptorPoolSize> poolSizes{};
-    poolSizes.resize(3);
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = maxFramesInFlight;
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[1].descriptorCount = maxFramesInFlight;
-    poolSizes[2].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[2].descriptorCount = 1;
-
-    descriptorPool = std::make_unique<DescriptorPool>(*device, poolSizes, 10u, 0);
-}
 
-void MainApp::createDescriptorSets()
-{
-    for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+    // The frames in flight may still read the object data from the buffer being replaced
+    if (objectBuffer)
     {
-        // Global Descriptor Set
-        VkDescriptorSetAllocateInfo globalDescriptorSetAllocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
-        globalDescriptorSetAllocateInfo.descriptorPool = descriptorPool->getHandle();
-        globalDescriptorSetAllocateInfo.descriptorSetCount = 1;
-        globalDescriptorSetAllocateInfo.pSetLayouts = &globalDescriptorSetLayout->getHandle();
-        frameData.globalDescriptorSets[i] = std::make_unique<DescriptorSet>(*device, globalDescriptorSetAllocateInfo);
-
-        VkDescriptorBufferInfo cameraBufferInfo{};
-        cameraBufferInfo.buffer = frameData.globalBuffers[i]->getHandle();
-        cameraBufferInfo.offset = 0;
-        cameraBufferInfo.range = sizeof(CameraData); // can also use VK_WHOLE_SIZE in this case
-
-        VkWriteDescriptorSet descriptorWriteUniformBuffer{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-        descriptorWriteUniformBuffer.dstSet = frameData.globalDescriptorSets[i]->getHandle();
-        descriptorWriteUniformBuffer.dstBinding = 0;
-        descriptorWriteUniformBuffer.dstArrayElement = 0;
-        descriptorWriteUniformBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWriteUniformBuffer.descriptorCount = 1;
-        descriptorWriteUniformBuffer.pBufferInfo = &cameraBufferInfo;
-        descriptorWriteUniformBuffer.pImageInfo = nullptr; // Optional
-        descriptorWriteUniformBuffer.pTexelBufferView = nullptr; // Optional
-
-        // Object Descriptor Set
-        VkDescriptorSetAllocateInfo objectDescriptorSetAllocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
-        objectDescriptorSetAllocateInfo.descriptorPool = descriptorPool->getHandle();
-        objectDescriptorSetAllocateInfo.descriptorSetCount = 1;
-        objectDescriptorSetAllocateInfo.pSetLayouts = &objectDescriptorSetLayout->getHandle();
-        frameData.objectDescriptorSets[i] = std::make_unique<DescriptorSet>(*device, objectDescriptorSetAllocateInfo);
-
-        VkDescriptorBufferInfo objectBufferInfo{};
-        objectBufferInfo.buffer = frameData.objectBuffers[i]->getHandle();
-        objectBufferInfo.offset = 0;
-        objectBufferInfo.range = sizeof(ObjectData) * MAX_OBJECT_COUNT; // can also use VK_WHOLE_SIZE in this case
-
-        VkWriteDescriptorSet objectWrite{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-        objectWrite.dstSet = frameData.objectDescriptorSets[i]->getHandle();
-        objectWrite.dstBinding = 0;
-        objectWrite.dstArrayElement = 0;
-        objectWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        objectWrite.descriptorCount = 1;
-        objectWrite.pBufferInfo = &objectBufferInfo;
-        objectWrite.pImageInfo = nullptr; // Optional
-        objectWrite.pTexelBufferView = nullptr; // Optional
-
-        // Write descriptor sets
-        std::array<VkWriteDescriptorSet, 2> writeDescriptorSets{ descriptorWriteUniformBuffer, objectWrite };
-        vkUpdateDescriptorSets(device->getHandle(), to_u32(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+        device->deferDestruction(std::move(objectBuffer), graphicsTimeline->getPendingValue());
+        LOGI("Grew the object buffer to {} objects", capacity);
     }
+    objectBuffer = std::move(newObjectBuffer);
+}
 
+void MainApp::createTextureDescriptorSets()
+{
     // TODO refactor this hardcoded bit so that we can actually support more than one texture
-    // Texture Descriptor Set
     std::shared_ptr<Material> texturedMeshMaterial = getMaterial("texturedmesh");
+    texturedMeshMaterial->texture = textures["empire_diffuse"];
 
+    // The pool doesn't allow freeing sets, so the sets of frames that are dropped when switching to fewer frames in flight are kept for later
     VkDescriptorSetAllocateInfo textureDescriptorSetAllocateInfo = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO };
     textureDescriptorSetAllocateInfo.descriptorPool = descriptorPool->getHandle();
     textureDescriptorSetAllocateInfo.descriptorSetCount = 1;
     textureDescriptorSetAllocateInfo.pSetLayouts = &singleTextureDescriptorSetLayout->getHandle();
-    texturedMeshMaterial->textureDescriptorSet = std::make_unique<DescriptorSet>(*device, textureDescriptorSetAllocateInfo);
-
-    VkDescriptorImageInfo textureImageInfo{};
-    textureImageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    textureImageInfo.imageView = textures["empire_diffuse"]->imageview->getHandle();
-    textureImageInfo.sampler = textureSampler->getHandle();
-
-    VkWriteDescriptorSet descriptorWriteCombinedImageSampler{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
-    descriptorWriteCombinedImageSampler.dstSet = texturedMeshMaterial->textureDescriptorSet->getHandle();
-    descriptorWriteCombinedImageSampler.dstBinding = 0;
-    descriptorWriteCombinedImageSampler.dstArrayElement = 0;
-    descriptorWriteCombinedImageSampler.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    descriptorWriteCombinedImageSampler.descriptorCount = 1;
-    descriptorWriteCombinedImageSampler.pImageInfo = &textureImageInfo;
-    descriptorWriteCombinedImageSampler.pBufferInfo = nullptr; // Optional
-    descriptorWriteCombinedImageSampler.pTexelBufferView = nullptr; // Optional
+    for (uint32_t i = to_u32(texturedMeshMaterial->textureDescriptorSets.size()); i < maxFramesInFlight; ++i)
+    {
+        texturedMeshMaterial->textureDescriptorSets.push_back(std::make_unique<DescriptorSet>(*device, textureDescriptorSetAllocateInfo));
+        texturedMeshMaterial->boundImageViews.push_back(VK_NULL_HANDLE);
+    }
 
-    std::array<VkWriteDescriptorSet, 1> writeDescriptorSets{ descriptorWriteCombinedImageSampler };
-    vkUpdateDescriptorSets(device->getHandle(), to_u32(writeDescriptorSets.size()), writeDescriptorSets.data(), 0, nullptr);
+    // No frame is in flight when the sets are created, so all of them can be written now; they start out with the placeholder unless the texture is already resident
+    for (uint32_t i = 0; i < maxFramesInFlight; ++i)
+    {
+        updateTextureDescriptorSets(i);
+    }
 }
 
-void MainApp::createSemaphoreAndFencePools()
+void MainApp::createSynchronizationPrimitives()
 {
     semaphorePool = std::make_unique<SemaphorePool>(*device);
-    fencePool = std::make_unique<FencePool>(*device);
+    graphicsTimeline = std::make_unique<TimelineSemaphore>(*device);
 }
 
 void MainApp::setupSynchronizationObjects()
 {
-    imagesInFlight.resize(swapchain->getImages().size(), VK_NULL_HANDLE);
+    if (!platform.isHeadless())
+    {
+        imagesInFlight.resize(swapchain->getImages().size(), 0);
+    }
 
+    // Only the frames that don't have semaphores yet get them, so this also covers an increase of the number of frames in flight
+    frameData.imageAvailableSemaphores.resize(maxFramesInFlight, VK_NULL_HANDLE);
+    frameData.renderingFinishedSemaphores.resize(maxFramesInFlight, VK_NULL_HANDLE);
+    frameData.timelineValues.resize(maxFramesInFlight);
     for (size_t i = 0; i < maxFramesInFlight; ++i) {
-        frameData.imageAvailableSemaphores[i] = semaphorePool->requestSemaphore();
-        frameData.renderingFinishedSemaphores[i] = semaphorePool->requestSemaphore();
-        frameData.inFlightFences[i] = fencePool->requestFence();
+        if (frameData.imageAvailableSemaphores[i] == VK_NULL_HANDLE)
+        {
+            frameData.imageAvailableSemaphores[i] = semaphorePool->requestSemaphore();
+            frameData.renderingFinishedSemaphores[i] = semaphorePool->requestSemaphore();
+        }
+        frameData.timelineValues[i] = 0;
+    }
+}
+
+void MainApp::applyLatencyProfile(LatencyProfile profile)
+{
+    // Switching profiles is rare, so the device is idled instead of tracking which per frame resources are still in use
+    device->waitIdle();
+
+    latencyProfile = profile;
+    maxFramesInFlight = getLatencyProfileFramesInFlight(profile);
+    LOGI("Switching to the {} latency profile with {} frame(s) in flight", getLatencyProfileName(profile), maxFramesInFlight);
+
+    // Shrinking drops the command buffers of the removed frames before their pools
+    frameData.commandBuffers.resize(maxFramesInFlight);
+    frameData.secondaryCommandBuffers.resize(maxFramesInFlight);
+    frameData.commandPools.resize(maxFramesInFlight);
+    frameData.secondaryCommandPools.resize(maxFramesInFlight);
+    createCommandPools();
+    createCommandBuffers();
+
+    // Every semaphore is unsignaled now that the device is idle, the ones of the removed frames go back to the pool
+    for (size_t i = maxFramesInFlight; i < frameData.imageAvailableSemaphores.size(); ++i)
+    {
+        semaphorePool->releaseSemaphore(frameData.imageAvailableSemaphores[i]);
+        semaphorePool->releaseSemaphore(frameData.renderingFinishedSemaphores[i]);
+    }
+    setupSynchronizationObjects();
+    currentFrame = 0;
+
+    frameRingBuffer->setFrameCount(maxFramesInFlight);
+    createTextureDescriptorSets();
+
+    if (!platform.isHeadless())
+    {
+        // The present mode is part of the swapchain
+        recreateSwapchain();
+    }
+}
+
+// Parses the file with both loaders before the mesh cache is consulted, so the comparison also runs when the meshes are cached
+static void compareObjLoaderOutput(const std::string &filename)
+{
+    ObjData parallelData;
+    ObjData tinyObjData;
+    Timer timer;
+
+    // Read the file once beforehand so neither loader pays for the first read from disk
+    loadObjFile(filename, parallelData);
+
+    timer.start();
+    const bool parallelLoaded = loadObjFile(filename, parallelData);
+    const double parallelLoadTime = timer.stop<Timer::Milliseconds>();
+
+    timer.start();
+    const bool tinyObjLoaded = loadObjFileWithTinyObj(filename, tinyObjData);
+    const double tinyObjLoadTime = timer.stop<Timer::Milliseconds>();
+
+    LOGI("{}: parallel loader {:.2f} ms, tinyobjloader {:.2f} ms, {} triangles", filename, parallelLoadTime, tinyObjLoadTime, parallelData.indices.size() / 3);
+
+    auto indicesMatch = [](const ObjIndex &a, const ObjIndex &b) { return a.position == b.position && a.texcoord == b.texcoord && a.normal == b.normal; };
+    if (!parallelLoaded || !tinyObjLoaded || parallelData.positions != tinyObjData.positions || parallelData.normals != tinyObjData.normals || parallelData.texcoords != tinyObjData.texcoords ||
+        !std::equal(parallelData.indices.begin(), parallelData.indices.end(), tinyObjData.indices.begin(), tinyObjData.indices.end(), indicesMatch))
+    {
+        LOGW("{}: the parallel loader output doesn't match tinyobjloader", filename);
     }
 }
 
 void MainApp::loadMeshes()
 {
+    const std::string monkeyFilename{ "../../../assets/models/monkey_smooth.obj" };
+    const std::string empireFilename{ "../../../assets/models/lost_empire.obj" };
+    if (compareObjLoaders)
+    {
+        compareObjLoaderOutput(monkeyFilename);
+        compareObjLoaderOutput(empireFilename);
+    }
+
     // TODO resolve warning messages saying that mtl files are not found
     std::shared_ptr<Mesh> monkeyMesh = std::make_shared<Mesh>();
-    monkeyMesh->loadFromObjFile("../../../assets/models/monkey_smooth.obj");
+    monkeyMesh->loadFromObjFile(monkeyFilename.c_str());
 
     std::shared_ptr<Mesh> empireMesh = std::make_shared<Mesh>();
-    empireMesh->loadFromObjFile("../../../assets/models/lost_empire.obj");
+    empireMesh->loadFromObjFile(empireFilename.c_str());
 
-    createVertexBuffer(monkeyMesh);
-    createIndexBuffer(monkeyMesh);
-    createVertexBuffer(empireMesh);
-    createIndexBuffer(empireMesh);
+    createGeometryArena({ monkeyMesh, empireMesh });
+    uploadMeshGeometry(monkeyMesh);
+    uploadMeshGeometry(empireMesh);
 
-    meshes["monkey"] = monkeyMesh;
-    meshes["empire"] = empireMesh;
+    // The mesh data has been copied into staging memory so the cache mappings are no longer needed
+    monkeyMesh->cache.reset();
+    empireMesh->cache.reset();
+
+    addMesh("monkey", monkeyMesh);
+    addMesh("empire", empireMesh);
 }
 
 void MainApp::createScene()
 {
-    RenderObject monkey;
-    monkey.mesh = getMesh("monkey");
-    monkey.material = getMaterial("defaultmesh");
-    monkey.transformMatrix = glm::translate(glm::mat4{ 1.0 }, glm::vec3(1, 0, 0));
-    renderables.push_back(monkey);
-
-    RenderObject map;
-    map.mesh = getMesh("empire");
-    map.material = getMaterial("texturedmesh");
-    map.transformMatrix = glm::translate(glm::mat4{ 1.0 }, glm::vec3{ 5,-10,0 });
-    renderables.push_back(map);
+    std::shared_ptr<Mesh> monkeyMesh = getMesh("monkey");
+    std::shared_ptr<Material> defaultMaterial = getMaterial("defaultmesh");
+    scene.createEntity(glm::translate(glm::mat4{ 1.0 }, glm::vec3(1, 0, 0)), monkeyMesh->boundsMin, monkeyMesh->boundsMax, monkeyMesh->id, defaultMaterial->id);
+
+    std::shared_ptr<Mesh> empireMesh = getMesh("empire");
+    std::shared_ptr<Material> texturedMaterial = getMaterial("texturedmesh");
+    scene.createEntity(glm::translate(glm::mat4{ 1.0 }, glm::vec3{ 5,-10,0 }), empireMesh->boundsMin, empireMesh->boundsMax, empireMesh->id, texturedMaterial->id);
     return; // TODO delete this
 
+    std::shared_ptr<Mesh> triangleMesh = getMesh("triangle");
     for (int x = -20; x <= 20; x++)
     {
         for (int y = -20; y <= 20; y++)
         {
-
-            RenderObject tri;
-            tri.mesh = getMesh("triangle");
-            tri.material = getMaterial("defaultmesh");
             glm::mat4 translation = glm::translate(glm::mat4{ 1.0 }, glm::vec3(x, 0, y));
             glm::mat4 scale = glm::scale(glm::mat4{ 1.0 }, glm::vec3(0.2, 0.2, 0.2));
-            tri.transformMatrix = translation * scale;
-
-            renderables.push_back(tri);
+            scene.createEntity(translation * scale, triangleMesh->boundsMin, triangleMesh->boundsMax, triangleMesh->id, defaultMaterial->id);
         }
     }
 }
 
+VkExtent2D MainApp::getRenderExtent() const
+{
+    if (platform.isHeadless())
+    {
+        return Window::getWindowExtent();
+    }
+
+    return swapchain->getProperties().imageExtent;
+}
+
+VkFormat MainApp::getRenderFormat() const
+{
+    if (platform.isHeadless())
+    {
+        return offscreenColorFormat;
+    }
+
+    return swapchain->getProperties().surfaceFormat.format;
+}
+
 std::shared_ptr<Material> MainApp::getMaterial(const std::string &name)
 {
     auto it = materials.find(name);
@@ -1218,82 +2367,6 @@ std::shared_ptr<Mesh> MainApp::getMesh(const std::string &name)
     return it->second;
 }
 
-void Mesh::loadFromObjFile(const char *filename)
-{
-    // Attrib will contain the vertex arrays of the file
-    tinyobj::attrib_t attrib;
-    // Shapes contains the info for each separate object in the file
-    std::vector<tinyobj::shape_t> shapes;
-    // Materials contains the information about the material of each shape, but we wont use it.
-    std::vector<tinyobj::material_t> materials;
-
-    // Error and warning output from the load function
-    std::string warn;
-    std::string err;
-
-    // Load the OBJ file
-    tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename, nullptr);
-    if (!warn.empty())
-    {
-        LOGW(warn);
-    }
-
-    // This happens if the file cant be found or is malformed
-    if (!err.empty())
-    {
-        LOGEANDABORT(err);
-    }
-
-    std::unordered_map<Vertex, uint32_t> uniqueVertices{};
-
-    // Loop over shapes
-    for (size_t s = 0; s < shapes.size(); s++)
-    {
-        // Loop over faces(polygon)
-        size_t index_offset = 0;
-        for (size_t f = 0; f < shapes[s].mesh.num_face_vertices.size(); f++)
-        {
-            // Hardcode loading to triangles
-            int fv = 3;
-
-            // Loop over vertices in the face.
-            for (size_t v = 0; v < fv; v++)
-            {
-                // Access to vertex
-                tinyobj::index_t idx = shapes[s].mesh.indices[index_offset + v];
-
-                // Vertex position
-                tinyobj::real_t vx = attrib.vertices[3 * idx.vertex_index + 0];
-                tinyobj::real_t vy = attrib.vertices[3 * idx.vertex_index + 1];
-                tinyobj::real_t vz = attrib.vertices[3 * idx.vertex_index + 2];
-                // Vertex normal
-                tinyobj::real_t nx = attrib.normals[3 * idx.normal_index + 0];
-                tinyobj::real_t ny = attrib.normals[3 * idx.normal_index + 1];
-                tinyobj::real_t nz = attrib.normals[3 * idx.normal_index + 2];
-                // Texture coordinates
-                tinyobj::real_t ux = attrib.texcoords[2 * idx.texcoord_index + 0];
-                tinyobj::real_t uy = attrib.texcoords[2 * idx.texcoord_index + 1];
-
-                // Create a new vertex entry
-                Vertex newVertex;
-                newVertex.position = { vx, vy, vz };
-                newVertex.normal = { nx, ny, nz };
-                newVertex.color = { nx, ny, nz }; // Set the colour as the normal values for now
-                newVertex.textureCoordinate = { ux, 1 - uy };
-
-                if (uniqueVertices.count(newVertex) == 0)
-                {
-                    uniqueVertices[newVertex] = to_u32(vertices.size());
-                    vertices.push_back(newVertex);
-                }
-
-                indices.push_back(uniqueVertices[newVertex]);
-            }
-            index_offset += fv;
-        }
-    }
-}
-
 void MainApp::initializeImGui()
 {
     // Create descriptor pool for imgui
@@ -1322,7 +2395,7 @@ void MainApp::initializeImGui()
     ImGui::StyleColorsClassic();
 
     // Initialize imgui for glfw
-    ImGui_ImplGlfw_InitForVulkan(platform.getWindow().getHandle(), true);
+    ImGui_ImplGlfw_InitForVulkan(static_cast<const GlfwWindow &>(platform.getWindow()).getHandle(), true);
 
     // Initilialize imgui for Vulkan
     ImGui_ImplVulkan_InitInfo initInfo = {};
@@ -1343,19 +2416,8 @@ void MainApp::initializeImGui()
     ImGui_ImplVulkan_LoadFunctions(loadFunction); // TODO figure out how to integrate with volk
     ImGui_ImplVulkan_Init(&initInfo, renderPass->getHandle());
 
-    std::unique_ptr<CommandBuffer> commandBuffer = std::make_unique<CommandBuffer>(*frameData.commandPools[currentFrame], VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
-
-    ImGui_ImplVulkan_CreateFontsTexture(commandBuffer->getHandle());
-
-    commandBuffer->end();
-
-    VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer->getHandle();
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
+    ImGui_ImplVulkan_CreateFontsTexture(uploadContext->getCommandBuffer());
+    uploadContext->flush();
 
     // Clear font data on CPU
     ImGui_ImplVulkan_DestroyFontUploadObjects();
@@ -1363,12 +2425,72 @@ void MainApp::initializeImGui()
 
 } // namespace vulkr
 
-int main()
+int main(int argc, char *argv[])
 {
+    // Usage: app [--headless] [--frames=<count>] [--quantize-vertices] [--latency-profile=<low-latency|throughput|vsync>] [--pipelined] [--gpu-culling] [--compare-obj-loaders] [--benchmark-job-system]
+    bool headless{ false };
+    bool quantizeVertices{ false };
+    bool pipelined{ false };
+    bool gpuCulling{ false };
+    bool compareObjLoaders{ false };
+    bool benchmarkJobSystem{ false };
+    vulkr::LatencyProfile latencyProfile{ vulkr::LatencyProfile::Vsync };
+    uint32_t headlessFrameCount{ 0u };
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string argument{ argv[i] };
+        if (argument == "--headless")
+        {
+            headless = true;
+        }
+        else if (argument.rfind("--frames=", 0) == 0)
+        {
+            headlessFrameCount = static_cast<uint32_t>(std::stoul(argument.substr(std::string("--frames=").size())));
+        }
+        else if (argument == "--quantize-vertices")
+        {
+            quantizeVertices = true;
+        }
+        else if (argument == "--latency-profile=low-latency")
+        {
+            latencyProfile = vulkr::LatencyProfile::LowLatency;
+        }
+        else if (argument == "--latency-profile=throughput")
+        {
+            latencyProfile = vulkr::LatencyProfile::Throughput;
+        }
+        else if (argument == "--latency-profile=vsync")
+        {
+            latencyProfile = vulkr::LatencyProfile::Vsync;
+        }
+        else if (argument == "--pipelined")
+        {
+            pipelined = true;
+        }
+        else if (argument == "--gpu-culling")
+        {
+            gpuCulling = true;
+        }
+        else if (argument == "--compare-obj-loaders")
+        {
+            compareObjLoaders = true;
+        }
+        else if (argument == "--benchmark-job-system")
+        {
+            benchmarkJobSystem = true;
+        }
+    }
+
     vulkr::Platform platform;
     std::unique_ptr<vulkr::MainApp> app = std::make_unique<vulkr::MainApp>(platform, "Vulkan App");
-
-    platform.initialize(std::move(app));
+    app->setUseQuantizedVertices(quantizeVertices);
+    app->setLatencyProfile(latencyProfile);
+    app->setPipelined(pipelined);
+    app->setUseGpuCulling(gpuCulling);
+    app->setCompareObjLoaders(compareObjLoaders);
+    app->setBenchmarkJobSystem(benchmarkJobSystem);
+
+    platform.initialize(std::move(app), headless, headlessFrameCount);
     platform.prepareApplication();
 
     platform.runMainProcessingLoop();
@@ -36,6 +36,14 @@
 #include "rendering/subpass.h"
 #include "rendering/shader_module.h"
 #include "rendering/pipeline_state.h"
+#include "rendering/mesh.h"
+#include "rendering/obj_loader.h"
+#include "rendering/vertex_layout.h"
+#include "rendering/mipmap_generator.h"
+#include "rendering/texture_decoder.h"
+#include "rendering/render_queue.h"
+#include "rendering/scene_store.h"
+#include "rendering/frustum.h"
 #include "core/pipeline_layout.h"
 #include "core/pipeline.h"
 #include "core/framebuffer.h"
@@ -45,58 +53,40 @@
 #include "core/buffer.h"
 #include "core/image.h"
 #include "core/sampler.h"
+#include "core/upload_context.h"
+#include "core/ring_buffer.h"
+#include "core/geometry_arena.h"
 
 #include "common/semaphore_pool.h"
-#include "common/fence_pool.h"
+#include "common/timeline_semaphore.h"
 #include "common/helpers.h"
+#include "common/strings.h"
 #include "common/timer.h"
+#include "common/thread_pool.h"
+#include "common/job_system.h"
+#include "common/triple_buffer.h"
+#include "common/host_buffer_pool.h"
 
 #include "platform/application.h"
 #include "platform/input_event.h"
 
-#define TINYOBJLOADER_IMPLEMENTATION
-#include <tiny_obj_loader.h>
-
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE // don't use the OpenGL default depth range of -1.0 to 1.0 and use 0.0 to 1.0
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
-#define GLM_ENABLE_EXPERIMENTAL
-#include <glm/gtx/hash.hpp>
-
+#include <algorithm>
 #include <chrono>
-
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
+#include <condition_variable>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
 
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_vulkan.h>
 
-struct Vertex {
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec3 color;
-    glm::vec2 textureCoordinate;
-
-    bool operator==(const Vertex &other) const {
-    return position == other.position && color == other.color &&
-            textureCoordinate == other.textureCoordinate;
-    }
-};
-
-namespace std {
-    template <> struct hash<Vertex> {
-        size_t operator()(Vertex const &vertex) const {
-        return ((hash<glm::vec3>()(vertex.position) ^
-                    (hash<glm::vec3>()(vertex.color) << 1)) >>
-                1) ^
-                (hash<glm::vec2>()(vertex.textureCoordinate) << 1);
-        }
-    };
-} // namespace std
-
 // Required for imgui integration, might be able to remove this if there's an alternate integration with volk
 VkInstance g_instance;
 PFN_vkVoidFunction loadFunction(const char *function_name, void *user_data) { return vkGetInstanceProcAddr(g_instance, function_name); }
@@ -104,50 +94,117 @@ PFN_vkVoidFunction loadFunction(const char *function_name, void *user_data) { re
 namespace vulkr
 {
 
-constexpr uint32_t maxFramesInFlight{ 2 }; // Explanation on this how we got this number: https://software.intel.com/content/www/us/en/develop/articles/practical-approach-to-vulkan-part-1.html
-constexpr uint32_t MAX_OBJECT_COUNT{ 10000 };
-
-struct Mesh
+constexpr uint32_t MAX_FRAMES_IN_FLIGHT{ 3 }; // The most frames in flight of any latency profile, the descriptor pool is sized for it
+constexpr uint32_t INITIAL_OBJECT_CAPACITY{ 1024 }; // The object buffer doubles from this whenever the scene outgrows it
+constexpr VkDeviceSize FRAME_RING_BUFFER_SIZE{ 16 * 1024 * 1024 }; // Shared by the per frame uniform/SSBO data of every frame in flight and small staging uploads
+constexpr VkDeviceSize STAGING_BUFFER_ALIGNMENT{ 16 }; // Satisfies the texel size alignment required by vkCmdCopyBufferToImage for the formats we upload
+constexpr size_t TEXTURE_DECODE_BUFFER_POOL_SIZE{ 8 }; // The number of host buffers kept around for texture decodes to reuse
+constexpr uint32_t MIN_OBJECTS_PER_RECORDING_TASK{ 512 }; // Smaller scenes are simulated and recorded on the calling thread since handing them to the job system costs more than it saves
+constexpr float GEOMETRY_ARENA_HEADROOM{ 1.5f }; // The geometry arena is sized for the startup meshes times this, leaving room for meshes loaded later
+// Must match the definitions in cull.comp
+constexpr uint32_t CULL_WORKGROUP_SIZE{ 64 };
+constexpr uint32_t MAX_DRAW_BATCH_COUNT{ 256 }; // Pairs of material and mesh drawn with GPU culling
+constexpr uint32_t INVALID_DRAW_BATCH{ std::numeric_limits<uint32_t>::max() };
+constexpr uint32_t MAX_CULL_MESH_COUNT{ 1024 }; // The mesh table of the GPU culling is a fixed size allocation from the frame ring buffer
+
+/* Trades latency for throughput through the number of frames in flight and the present mode, see https://software.intel.com/content/www/us/en/develop/articles/practical-approach-to-vulkan-part-1.html */
+enum class LatencyProfile
 {
-    std::vector<Vertex> vertices;
-    std::vector<uint32_t> indices;
-    std::unique_ptr<Buffer> vertexBuffer;
-    std::unique_ptr<Buffer> indexBuffer;
+    LowLatency, // A single frame in flight presented with MAILBOX or IMMEDIATE
+    Throughput, // Three frames in flight presented with IMMEDIATE or MAILBOX so the CPU can run further ahead of the GPU
+    Vsync // Two frames in flight presented with FIFO
+};
 
-    void loadFromObjFile(const char *fileName);
+struct Texture
+{
+    std::unique_ptr<Image> image;
+    std::unique_ptr<ImageView> imageview;
+    UploadTicket uploadTicket{ 0 }; // The upload batch that writes the image
+    bool resident{ false }; // Whether the upload batch has completed, until then the placeholder texture is bound in its place
 };
 
 struct Material
 {
-    std::shared_ptr<DescriptorSet> textureDescriptorSet;
+    uint32_t id{ 0 }; // The index in the material table, which the render queue sort keys refer to
+    uint32_t pipelineId{ 0 }; // Shared by the materials that use the same pipeline
+    // One set per frame in flight, so the set of a frame can be rewritten once that frame has completed when the texture becomes resident
+    std::vector<std::shared_ptr<DescriptorSet>> textureDescriptorSets;
+    std::vector<VkImageView> boundImageViews;
+    std::shared_ptr<Texture> texture;
     std::shared_ptr<GraphicsPipeline> pipeline;
     std::shared_ptr<PipelineState> pipelineState;
 };
 
-struct Texture
+struct CameraData
 {
-    std::unique_ptr<Image> image;
-    std::unique_ptr<ImageView> imageview;
+    alignas(16) glm::mat4 view;
+    alignas(16) glm::mat4 proj;
 };
 
-struct RenderObject
+struct ObjectData
 {
-    std::shared_ptr<Mesh> mesh;
+    alignas(16) glm::mat4 model;
+};
 
-    std::shared_ptr<Material> material;
+/* The input of the culling shader for every object, see cull.comp */
+struct CullInstance
+{
+    uint32_t meshId;
+    uint32_t lodIndex;
+    uint32_t batchIndex; // INVALID_DRAW_BATCH for hidden objects
+    uint32_t padding;
+};
 
-    glm::mat4 transformMatrix;
+struct CullMesh
+{
+    glm::vec4 boundsCenter; // In the space of the vertices, which the model matrix transforms
+    glm::vec4 boundsExtent;
+    glm::uvec4 lods[MAX_MESH_LOD_COUNT]; // Index count, first index, vertex offset
 };
 
-struct CameraData
+static_assert(sizeof(CullInstance) == 16 && sizeof(CullMesh) == 112, "The culling shader inputs must match their std430 layout");
+
+struct CullConstants
 {
-    alignas(16) glm::mat4 view;
-    alignas(16) glm::mat4 proj;
+    glm::vec4 frustumPlanes[6];
+    uint32_t objectCount;
 };
 
-struct ObjectData
+/* The objects of a material and mesh pair, drawn by a single indirect draw of the commands the culling shader writes for those that are visible */
+struct DrawBatch
 {
-    alignas(16) glm::mat4 model;
+    uint32_t materialId;
+    uint32_t meshId;
+    uint32_t firstCommand;
+    uint32_t maxDrawCount; // The number of objects in the batch, visible or not
+};
+
+/* Everything the render stage needs from the simulation stage to record and submit a frame, the render stage never reads the camera or the object transforms directly */
+struct FramePacket
+{
+    CameraData camera;
+    std::vector<ObjectData> objects; // In the order of the entities in the scene store, culled ones included so the upload is a single copy
+    std::vector<uint32_t> lodIndices;
+    RenderQueue renderQueue; // The draws of the entities that passed culling sorted by state, the instance index of a draw is the index of its object
+    bool gpuCulling{ false }; // Culls and draws through cullInstances and drawBatches instead of the render queue
+    std::vector<CullInstance> cullInstances; // In the order of the entities in the scene store
+    std::vector<DrawBatch> drawBatches; // Sorted by state like the render queue
+    LatencyProfile latencyProfile{ LatencyProfile::Vsync };
+    uint32_t geometryDefragmentationRequestCount{ 0 }; // Counts every request so one made in a packet the render stage skipped isn't lost
+
+    // A copy of the UI draw data since ImGui reuses its own as soon as the next UI frame starts, not valid when headless
+    ImDrawData userInterfaceDrawData{};
+    std::vector<std::unique_ptr<ImDrawList>> userInterfaceDrawLists; // Kept with the packet so their buffers are reused
+    std::vector<ImDrawList *> userInterfaceDrawListPointers; // What the CmdLists of the draw data point at
+};
+
+/* The state of the render stage shown by the UI and used to fit the camera to the render extent */
+struct RenderStatistics
+{
+    VkExtent2D extent{};
+    uint32_t framesInFlight{ 0 };
+    VkPresentModeKHR presentMode{ VK_PRESENT_MODE_FIFO_KHR };
+    GeometryArenaStats geometry{};
 };
 
 class MainApp : public Application
@@ -163,12 +220,45 @@ public:
 
     virtual void recreateSwapchain() override;
 
+    virtual void finish() override;
+
     virtual void handleInputEvents(const InputEvent& inputEvent) override;
+
+    /* Upload QuantizedVertex instead of Vertex, must be set before the application is prepared */
+    void setUseQuantizedVertices(bool enabled);
+
+    /* Select the latency profile used from the first frame, it can be changed later from the UI */
+    void setLatencyProfile(LatencyProfile profile);
+
+    /* Record and submit frames on a render thread while the main thread simulates the next one, must be set before the application is prepared */
+    void setPipelined(bool enabled);
+
+    /* Cull the objects in a compute shader and draw them with indirect draws, must be set before the application is prepared; the CPU path stays available from the UI */
+    void setUseGpuCulling(bool enabled);
+
+    /* Parse every model with both the parallel OBJ loader and tinyobjloader at startup, logging their times and whether their output matches */
+    void setCompareObjLoaders(bool enabled);
+
+    /* Log the scheduling overhead of the job system against the thread pool once the job system is created */
+    void setBenchmarkJobSystem(bool enabled);
 private:
     const std::string TEXTURE_PATH = "../../../assets/textures/lost_empire-RGBA.png";
-    const std::vector<const char *> deviceExtensions {
-        VK_KHR_SWAPCHAIN_EXTENSION_NAME
-    };
+    const VkFormat offscreenColorFormat{ VK_FORMAT_R8G8B8A8_SRGB };
+    std::vector<const char *> deviceExtensions;
+    bool useQuantizedVertices{ false };
+    LatencyProfile latencyProfile{ LatencyProfile::Vsync };
+    LatencyProfile requestedLatencyProfile{ LatencyProfile::Vsync }; // Handed to the render stage with the next frame packet, which applies it when it differs from the current profile
+    uint32_t maxFramesInFlight{ 2 };
+    float lodErrorThreshold{ 1.0f }; // The largest error in pixels a LOD may show on screen
+    RenderQueueStatistics renderQueueStatistics; // Of the last simulated frame
+    uint32_t culledEntityCount{ 0 }; // Of the last simulated frame
+    bool pipelined{ false };
+    bool useGpuCulling{ false }; // Switched from the UI once the GPU culling resources exist
+    bool gpuCullingAvailable{ false };
+    bool gpuCullingFallbackLogged{ false };
+    bool compareObjLoaders{ false };
+    bool benchmarkJobSystem{ false };
+    bool drawIndirectCountSupported{ false }; // Without it every indirect command of a batch is drawn, the culled ones as empty draws
 
     std::unique_ptr<Instance> instance{ nullptr };
     VkSurfaceKHR surface{ VK_NULL_HANDLE };
@@ -179,6 +269,10 @@ private:
     std::unique_ptr<Swapchain> swapchain{ nullptr };
     std::vector<std::unique_ptr<ImageView>> swapChainImageViews;
 
+    // Render targets used in place of the swapchain images when running headless
+    std::vector<std::unique_ptr<Image>> offscreenImages;
+    std::vector<std::unique_ptr<ImageView>> offscreenImageViews;
+
     std::vector<VkAttachmentReference> inputAttachments;
     std::vector<VkAttachmentReference> colorAttachments;
     std::vector<VkAttachmentReference> resolveAttachments;
@@ -190,81 +284,171 @@ private:
     std::unique_ptr<DescriptorSetLayout> globalDescriptorSetLayout{ nullptr };
     std::unique_ptr<DescriptorSetLayout> objectDescriptorSetLayout{ nullptr };
     std::unique_ptr<DescriptorSetLayout> singleTextureDescriptorSetLayout{ nullptr };
+    std::unique_ptr<DescriptorSetLayout> cullDescriptorSetLayout{ nullptr };
+    std::vector<ShaderModule> cullShaderModules;
+    std::unique_ptr<PipelineLayout> cullPipelineLayout{ nullptr };
+    std::unique_ptr<ComputePipeline> cullPipeline{ nullptr };
     std::unique_ptr<DescriptorPool> descriptorPool;
+    std::unique_ptr<DescriptorSet> globalDescriptorSet;
     std::unique_ptr<DescriptorPool> imguiPool;
 
-    std::vector<std::unique_ptr<Framebuffer>> swapchainFramebuffers;
+    std::vector<std::unique_ptr<Framebuffer>> framebuffers;
 
     std::unique_ptr<Image> depthImage{ nullptr };
     std::unique_ptr<ImageView> depthImageView{ nullptr };
     std::unique_ptr<Sampler> textureSampler{ nullptr };
 
     std::unique_ptr<SemaphorePool> semaphorePool;
-    std::unique_ptr<FencePool> fencePool;
-    std::vector<VkFence> imagesInFlight;
-
+    std::unique_ptr<TimelineSemaphore> graphicsTimeline; // Signalled by every frame submitted to the graphics queue
+    std::unique_ptr<UploadContext> uploadContext;
+    // Textures stream through the dedicated transfer queue when there is one, so large uploads overlap rendering
+    std::unique_ptr<UploadContext> streamingUploadContext;
+    std::unique_ptr<RingBuffer> frameRingBuffer;
+    std::unique_ptr<GeometryArena> geometryArena;
+    uint32_t geometryDefragmentationRequestCount{ 0 }; // Raised by the UI and handed to the render stage with every frame packet
+    uint32_t completedGeometryDefragmentationRequestCount{ 0 }; // Owned by the render stage
+    VkDeviceSize uniformBufferAlignment{ 0 };
+    VkDeviceSize storageBufferAlignment{ 0 };
+    std::vector<uint64_t> imagesInFlight; // The graphics timeline value of the last frame that rendered to each swapchain image
+
+    std::unique_ptr<JobSystem> jobSystem; // Runs the fine grained parallel work of a frame, such as transform updates and command recording
     std::unique_ptr<CameraController> cameraController;
+    VkExtent2D cameraExtent{}; // The render extent the camera viewport was last fitted to
     std::unique_ptr<Timer> drawingTimer;
 
+    // When pipelined the main thread simulates frames and the render thread records and submits them, the packets are handed over through the triple buffer
+    // The main thread never waits for the render thread, which renders the latest packet and skips the ones published in between
+    TripleBuffer<FramePacket> framePackets;
+    std::thread renderThread;
+    std::mutex framePacketMutex; // Only guards the render thread going to sleep, so it can't miss a packet published meanwhile
+    std::condition_variable framePacketPublished;
+    bool renderThreadStopping{ false };
+
+    // Written by the render stage every frame and read by the simulation stage
+    mutable std::mutex renderStatisticsMutex;
+    RenderStatistics renderStatistics;
+
     struct FrameData
     {
-        std::array<VkSemaphore, maxFramesInFlight> imageAvailableSemaphores;
-        std::array<VkSemaphore, maxFramesInFlight> renderingFinishedSemaphores;
-        std::array<VkFence, maxFramesInFlight> inFlightFences;
+        std::vector<VkSemaphore> imageAvailableSemaphores;
+        std::vector<VkSemaphore> renderingFinishedSemaphores;
+        std::vector<uint64_t> timelineValues; // The graphics timeline value signalled by the last submission of each frame
 
-        std::array<std::unique_ptr<CommandPool>, maxFramesInFlight> commandPools;
-        std::array<std::shared_ptr<CommandBuffer>, maxFramesInFlight> commandBuffers;
+        std::vector<std::unique_ptr<CommandPool>> commandPools;
+        std::vector<std::shared_ptr<CommandBuffer>> commandBuffers;
 
-        std::array<std::unique_ptr<DescriptorSet>, maxFramesInFlight> globalDescriptorSets;
-        std::array<std::unique_ptr<DescriptorSet>, maxFramesInFlight> objectDescriptorSets;
-        std::array<std::unique_ptr<Buffer>, maxFramesInFlight> globalBuffers;
-        std::array<std::unique_ptr<Buffer>, maxFramesInFlight> objectBuffers;
+        // A pool per recording slot of each frame, so every recording thread allocates and records its secondary command buffer without synchronizing; the last slot is used by the main thread for the UI
+        std::vector<std::vector<std::unique_ptr<CommandPool>>> secondaryCommandPools;
+        std::vector<std::vector<std::shared_ptr<CommandBuffer>>> secondaryCommandBuffers;
     } frameData;
     size_t currentFrame{ 0 };
+    bool frameSubmitSkipped{ false }; // The last render of currentFrame returned before submitting, so its ring region is still open
+
+    // The object data of every frame in flight, each in its own region of the buffer bound with a dynamic offset
+    // Descriptor sets aren't freed from the main pool, so every object buffer has a pool for its own set that goes away with it when the buffer is outgrown
+    struct ObjectBuffer
+    {
+        uint32_t capacity{ 0 }; // In objects per frame
+        VkDeviceSize regionSize{ 0 };
+        std::unique_ptr<Buffer> buffer;
+        std::unique_ptr<DescriptorPool> descriptorPool;
+        std::unique_ptr<DescriptorSet> descriptorSet;
+
+        // Only created with GPU culling, every frame in flight again has a region of each buffer
+        VkDeviceSize cullInstanceRegionSize{ 0 };
+        std::unique_ptr<Buffer> cullInstanceBuffer;
+        VkDeviceSize drawRegionSize{ 0 };
+        std::unique_ptr<Buffer> drawBuffer; // The draw count of every batch followed by the indirect commands, written by the culling shader
+        std::unique_ptr<DescriptorSet> cullDescriptorSet;
+    };
+    std::unique_ptr<ObjectBuffer> objectBuffer;
 
-    std::vector<RenderObject> renderables;
+    SceneStore scene;
+    // Written for every entity by the parallel part of the simulation and compacted into the render queue afterwards
+    std::vector<uint64_t> entitySortKeys;
+    std::vector<uint8_t> entityVisibility;
+    std::vector<uint32_t> drawBatchLookup; // The object count and then the batch index of every material and mesh pair
     std::unordered_map<std::string, std::shared_ptr<Material>> materials;
     std::unordered_map<std::string, std::shared_ptr<Mesh>> meshes;
+    // Indexed by the ids packed into the render queue sort keys, so recording only follows plain pointers
+    std::vector<const Material *> materialTable;
+    std::vector<const Mesh *> meshTable;
+    uint32_t pipelineCount{ 0 };
     std::unordered_map<std::string, std::shared_ptr<Texture>> textures;
+    std::shared_ptr<Texture> placeholderTexture;
+
+    struct PendingTextureLoad
+    {
+        std::string name;
+        std::future<DecodedTexture> decode;
+    };
+    std::unique_ptr<ThreadPool> textureLoaderThreadPool{ nullptr };
+    std::unique_ptr<TextureDecoder> textureDecoder{ nullptr };
+    std::vector<PendingTextureLoad> pendingTextureLoads;
 
     // Subroutines
-    void drawImGuiInterface();
-    void drawObjects();
+    void simulateFrame(FramePacket &packet);
+    void renderFrame(const FramePacket &packet);
+    void runRenderThread();
+    void stopRenderThread();
+    void updateRenderStatistics();
+    RenderStatistics getRenderStatistics() const;
+    void drawImGuiInterface(const FramePacket &packet);
+    void drawObjects(const FramePacket &packet, std::vector<std::shared_ptr<CommandBuffer>> &recordedCommandBuffers);
+    void recordObjects(const FramePacket &packet, CommandBuffer &commandBuffer, uint32_t firstDraw, uint32_t lastDraw, uint32_t cameraOffset, uint32_t objectOffset);
+    bool buildDrawBatches(FramePacket &packet); // Returns false when the scene exceeds the limits of GPU culling
+    void updateObjectBuffer(const FramePacket &packet);
+    void dispatchCulling(const FramePacket &packet, CommandBuffer &commandBuffer);
+    void recordIndirectDraws(const FramePacket &packet, CommandBuffer &commandBuffer, uint32_t cameraOffset, uint32_t objectOffset);
+    void setDynamicRenderState(VkCommandBuffer commandBuffer) const;
+    void recordAndSubmitFrame(const FramePacket &packet, uint32_t renderTargetIndex);
     void cleanupSwapchain();
     void createInstance();
     void createSurface();
     void createDevice();
     void createSwapchain();
     void createSwapchainImageViews();
+    void createOffscreenRenderTargets();
     void createRenderPass();
     void createDescriptorSetLayouts();
     std::shared_ptr<Material> createMaterial(std::shared_ptr<GraphicsPipeline> pipeline, std::shared_ptr<PipelineState> pipelineState, const std::string &name);
+    void addMesh(const std::string &name, std::shared_ptr<Mesh> mesh);
     void createGraphicsPipelines();
+    void createComputePipelines();
     void createFramebuffers();
+    void createJobSystem();
     void createCommandPools();
     void createCommandBuffers();
-    void transitionImageLayout(VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout);
-    void copyBufferToImage(const Buffer &srcBuffer, const Image &dstImage, uint32_t width, uint32_t height);
+    void createUploadContext();
     void createDepthResources();
-    std::unique_ptr<Image> createTextureImage(const char *filename);
+    void createTextureLoader();
+    std::unique_ptr<Image> createTextureImage(const DecodedTexture &decodedTexture);
     std::unique_ptr<ImageView> createTextureImageView(const Image &image);
+    void createPlaceholderTexture();
+    void loadTextureAsync(const std::string &name, const std::string &filename);
     void loadTextures();
+    void updateTextureLoads();
+    void updateTextureDescriptorSets(uint32_t frameIndex);
     void createTextureSampler();
-    void copyBufferToBuffer(const Buffer &srcBuffer, const Buffer &dstBuffer, VkDeviceSize size);
-    void createVertexBuffer(std::shared_ptr<Mesh> mesh);
-    void createIndexBuffer(std::shared_ptr<Mesh> mesh);
-    void createUniformBuffers();
-    void createSSBOs();
+    void createGeometryArena(const std::vector<std::shared_ptr<Mesh>> &startupMeshes);
+    void uploadMeshGeometry(std::shared_ptr<Mesh> mesh);
+    void createFrameRingBuffer();
+    const Buffer &stageUpload(UploadContext &context, const void *data, VkDeviceSize size, VkDeviceSize &stagingOffset);
     void createDescriptorPool();
     void createDescriptorSets();
+    void createObjectBuffer(uint32_t capacity);
+    void createTextureDescriptorSets();
     void loadMeshes();
     void createScene();
-    void createSemaphoreAndFencePools();
+    void createSynchronizationPrimitives();
     void setupSynchronizationObjects();
+    void applyLatencyProfile(LatencyProfile profile);
     void setupTimer();
     void setupCamera();
     void initializeImGui();
 
+    VkExtent2D getRenderExtent() const;
+    VkFormat getRenderFormat() const;
     std::shared_ptr<Material> getMaterial(const std::string &name);
     std::shared_ptr<Mesh> getMesh(const std::string &name);
 };
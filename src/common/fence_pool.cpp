@@ -22,6 +22,8 @@
 
 #include "fence_pool.h"
 
+#include <algorithm>
+
 namespace vulkr
 {
 
@@ -60,6 +62,22 @@ VkFence FencePool::requestFence()
 	return fences.back();
 }
 
+void FencePool::releaseFence(VkFence fence)
+{
+	// The active fences are kept at the front, so the released one swaps places with the last active one
+	auto activeEnd = fences.begin() + activeFenceCount;
+	auto it = std::find(fences.begin(), activeEnd, fence);
+	if (it == activeEnd)
+	{
+		LOGEANDABORT("Attempting to release a fence that isn't active in the pool");
+	}
+
+	VK_CHECK(vkResetFences(device.getHandle(), 1, &fence));
+
+	std::iter_swap(it, activeEnd - 1);
+	--activeFenceCount;
+}
+
 void FencePool::wait(VkFence *fence, uint64_t timeout) const
 {
 	VK_CHECK(vkWaitForFences(device.getHandle(), 1, fence, VK_TRUE, timeout));
@@ -41,6 +41,9 @@ public:
 
 	VkFence requestFence();
 
+	/* Return a single fence to the pool so it can be handed out again before the next resetAll, it's reset and must not be in use anymore */
+	void releaseFence(VkFence fence);
+
 	void wait(VkFence *fence, uint64_t timeout = std::numeric_limits<uint64_t>::max()) const;
 
 	void reset(VkFence *fence);
@@ -22,6 +22,10 @@
 
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
 #include <type_traits>
 
 namespace vulkr
@@ -40,6 +44,52 @@ constexpr uint32_t to_u32(T value)
 	return static_cast<uint32_t>(value);
 }
 
+/* Finalizer with good avalanche behaviour, every input bit affects every output bit */
+inline uint64_t mix64(uint64_t value)
+{
+	value ^= value >> 30;
+	value *= 0xBF58476D1CE4E5B9ull;
+	value ^= value >> 27;
+	value *= 0x94D049BB133111EBull;
+	value ^= value >> 31;
+	return value;
+}
+
+/* Hash raw bytes a 64 bit word at a time */
+inline uint64_t hashBytes(const void *data, size_t size)
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>(data);
+	uint64_t hash{ 0x9E3779B97F4A7C15ull ^ size };
+
+	size_t i{ 0 };
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		memcpy(&word, bytes + i, sizeof(word));
+		hash = (hash ^ mix64(word)) * 0x9E3779B97F4A7C15ull;
+	}
+
+	if (i < size)
+	{
+		uint64_t tail{ 0 };
+		memcpy(&tail, bytes + i, size - i);
+		hash ^= mix64(tail);
+	}
+
+	return mix64(hash);
+}
+
+/* The amount of levels in a full mip chain, down to and including the 1x1 level */
+inline uint32_t getMipLevelCount(uint32_t width, uint32_t height)
+{
+	uint32_t levelCount{ 1 };
+	for (uint32_t size = width > height ? width : height; size > 1; size >>= 1)
+	{
+		++levelCount;
+	}
+	return levelCount;
+}
+
 template <typename T>
 constexpr int sgn(T val)
 {
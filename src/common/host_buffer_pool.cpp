@@ -0,0 +1,88 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "host_buffer_pool.h"
+
+#include <utility>
+
+namespace vulkr
+{
+
+HostBufferPool::HostBufferPool(size_t maxFreeBuffers) :
+	maxFreeBuffers{ maxFreeBuffers }
+{
+}
+
+std::vector<uint8_t> HostBufferPool::acquire(size_t size)
+{
+	std::vector<uint8_t> buffer;
+	{
+		std::lock_guard<std::mutex> lock{ mutex };
+
+		size_t bestIndex{ freeBuffers.size() };
+		for (size_t i = 0; i < freeBuffers.size(); ++i)
+		{
+			const size_t capacity{ freeBuffers[i].capacity() };
+			if (bestIndex == freeBuffers.size())
+			{
+				bestIndex = i;
+				continue;
+			}
+
+			const size_t bestCapacity{ freeBuffers[bestIndex].capacity() };
+			const bool fits{ capacity >= size };
+			const bool bestFits{ bestCapacity >= size };
+			if ((fits && (!bestFits || capacity < bestCapacity)) || (!fits && !bestFits && capacity > bestCapacity))
+			{
+				bestIndex = i;
+			}
+		}
+
+		if (bestIndex < freeBuffers.size())
+		{
+			buffer = std::move(freeBuffers[bestIndex]);
+			freeBuffers[bestIndex] = std::move(freeBuffers.back());
+			freeBuffers.pop_back();
+		}
+	}
+
+	// Resizing within the capacity doesn't allocate; the contents are about to be overwritten so the value initialization is the only cost
+	buffer.resize(size);
+	return buffer;
+}
+
+void HostBufferPool::release(std::vector<uint8_t> &&buffer)
+{
+	if (buffer.capacity() == 0)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock{ mutex };
+	if (freeBuffers.size() < maxFreeBuffers)
+	{
+		buffer.clear();
+		freeBuffers.push_back(std::move(buffer));
+	}
+}
+
+} // namespace vulkr
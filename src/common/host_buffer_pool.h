@@ -0,0 +1,57 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace vulkr
+{
+
+/* A thread safe free list of host memory blocks, so that repeated work such as decoding images reuses its allocations instead of going back to the heap */
+class HostBufferPool
+{
+public:
+	/* At most maxFreeBuffers released buffers are kept, any more are freed */
+	HostBufferPool(size_t maxFreeBuffers);
+	~HostBufferPool() = default;
+
+	HostBufferPool(const HostBufferPool &) = delete;
+	HostBufferPool(HostBufferPool &&) = delete;
+	HostBufferPool &operator=(const HostBufferPool &) = delete;
+	HostBufferPool &operator=(HostBufferPool &&) = delete;
+
+	/* Get a buffer of the requested size, reusing the smallest free buffer that is large enough, or growing the largest one if none is */
+	std::vector<uint8_t> acquire(size_t size);
+
+	/* Return a buffer to the pool once its contents are no longer needed */
+	void release(std::vector<uint8_t> &&buffer);
+private:
+	std::mutex mutex;
+	std::vector<std::vector<uint8_t>> freeBuffers;
+	size_t maxFreeBuffers;
+};
+
+} // namespace vulkr
@@ -0,0 +1,368 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "job_system.h"
+#include "helpers.h"
+#include "logger.h"
+
+#include <algorithm>
+
+namespace vulkr
+{
+
+// The job system a worker thread belongs to and the index of its deque
+static thread_local const JobSystem *workerJobSystem{ nullptr };
+static thread_local int32_t workerDequeIndex{ -1 };
+
+bool JobCounter::isComplete() const
+{
+	return count.load(std::memory_order_acquire) == 0;
+}
+
+WorkStealingDeque::WorkStealingDeque(uint32_t capacity) :
+	jobs(capacity),
+	mask{ static_cast<int64_t>(capacity) - 1 }
+{
+	if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+	{
+		LOGEANDABORT("The capacity of a work stealing deque must be a power of two, {} was requested", capacity);
+	}
+}
+
+bool WorkStealingDeque::push(Job *job)
+{
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_acquire);
+	if (b - t > mask)
+	{
+		return false;
+	}
+
+	jobs[b & mask].store(job, std::memory_order_relaxed);
+	// Releases the job to thieves, which acquire the bottom before reading it
+	bottom.store(b + 1, std::memory_order_release);
+
+	return true;
+}
+
+Job *WorkStealingDeque::pop()
+{
+	int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		// Empty
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job *job = jobs[b & mask].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		// The last job, race the thieves for it
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+		{
+			job = nullptr;
+		}
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	return job;
+}
+
+Job *WorkStealingDeque::steal()
+{
+	int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom.load(std::memory_order_acquire);
+
+	if (t >= b)
+	{
+		return nullptr;
+	}
+
+	Job *job = jobs[t & mask].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+	{
+		return nullptr;
+	}
+
+	return job;
+}
+
+JobSystem::JobSystem(uint32_t workerCount) :
+	ownerThreadId{ std::this_thread::get_id() }
+{
+	if (workerCount == 0u)
+	{
+		workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1u;
+	}
+
+	deques.reserve(workerCount + 1);
+	for (uint32_t i = 0; i < workerCount + 1; ++i)
+	{
+		deques.emplace_back(std::make_unique<WorkStealingDeque>(DEQUE_CAPACITY));
+	}
+
+	workers.reserve(workerCount);
+	for (uint32_t i = 0; i < workerCount; ++i)
+	{
+		workers.emplace_back(&JobSystem::run, this, i + 1);
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	const int32_t dequeIndex = getDequeIndex();
+	while (queuedJobCount.load() > 0)
+	{
+		Job *job = findJob(dequeIndex);
+		if (job)
+		{
+			execute(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	{
+		std::lock_guard<std::mutex> lock{ sleepMutex };
+		stopping = true;
+	}
+	jobAvailable.notify_all();
+
+	for (std::thread &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+void JobSystem::schedule(std::function<void()> function, JobCounter *counter, JobCounter *dependency)
+{
+	Job *job = new Job{ std::move(function), counter };
+	if (counter)
+	{
+		counter->count.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	if (dependency)
+	{
+		// Checked under the mutex so the job can't be added after the dependency released its dependent jobs
+		std::lock_guard<std::mutex> lock{ dependency->mutex };
+		if (!dependency->isComplete())
+		{
+			dependency->dependentJobs.push_back(job);
+			return;
+		}
+	}
+
+	enqueue(job);
+}
+
+void JobSystem::wait(const JobCounter &counter)
+{
+	const int32_t dequeIndex = getDequeIndex();
+	while (!counter.isComplete())
+	{
+		Job *job = findJob(dequeIndex);
+		if (job)
+		{
+			execute(job);
+			continue;
+		}
+
+		// Nothing left to run, the remaining jobs are running on other threads, so sleep until one of them completes the counter or queues more work
+		std::unique_lock<std::mutex> lock{ sleepMutex };
+		sleepingThreadCount.fetch_add(1);
+		jobAvailable.wait(lock, [this, &counter]() { return counter.count.load() == 0 || queuedJobCount.load() > 0; });
+		sleepingThreadCount.fetch_sub(1);
+	}
+
+	// Wait for the job that completed the counter to let go of it
+	std::lock_guard<std::mutex> lock{ counter.mutex };
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t first, uint32_t last)> &function)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	grainSize = std::max(grainSize, 1u);
+	if (count <= grainSize)
+	{
+		function(0, count);
+		return;
+	}
+
+	// The function outlives the jobs since this only returns once they have all run
+	JobCounter counter;
+	for (uint32_t first = 0; first < count; first += grainSize)
+	{
+		const uint32_t last = std::min(first + grainSize, count);
+		schedule([&function, first, last]() { function(first, last); }, &counter);
+	}
+	wait(counter);
+}
+
+uint32_t JobSystem::getThreadCount() const
+{
+	return to_u32(deques.size());
+}
+
+int32_t JobSystem::getDequeIndex() const
+{
+	if (std::this_thread::get_id() == ownerThreadId)
+	{
+		return 0;
+	}
+
+	return workerJobSystem == this ? workerDequeIndex : -1;
+}
+
+void JobSystem::enqueue(Job *job)
+{
+	const int32_t dequeIndex = getDequeIndex();
+	if (dequeIndex < 0 || !deques[dequeIndex]->push(job))
+	{
+		std::lock_guard<std::mutex> lock{ sharedJobsMutex };
+		sharedJobs.push_back(job);
+	}
+
+	// The count is raised before checking for sleeping threads, and they check it after announcing that they sleep, so a wake up can't be missed
+	queuedJobCount.fetch_add(1);
+	if (sleepingThreadCount.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ sleepMutex };
+		}
+		jobAvailable.notify_one();
+	}
+}
+
+Job *JobSystem::findJob(int32_t dequeIndex)
+{
+	Job *job{ nullptr };
+	if (dequeIndex >= 0)
+	{
+		job = deques[dequeIndex]->pop();
+	}
+
+	if (!job)
+	{
+		std::lock_guard<std::mutex> lock{ sharedJobsMutex };
+		if (!sharedJobs.empty())
+		{
+			job = sharedJobs.front();
+			sharedJobs.pop_front();
+		}
+	}
+
+	// Start stealing after our own deque so the workers don't all go for the same victim
+	const uint32_t dequeCount = to_u32(deques.size());
+	for (uint32_t i = 1; !job && i <= dequeCount; ++i)
+	{
+		uint32_t victim = (static_cast<uint32_t>(std::max(dequeIndex, 0)) + i) % dequeCount;
+		if (static_cast<int32_t>(victim) != dequeIndex)
+		{
+			job = deques[victim]->steal();
+		}
+	}
+
+	if (job)
+	{
+		queuedJobCount.fetch_sub(1);
+	}
+
+	return job;
+}
+
+void JobSystem::execute(Job *job)
+{
+	job->function();
+
+	JobCounter *counter = job->counter;
+	delete job;
+
+	if (!counter)
+	{
+		return;
+	}
+
+	std::vector<Job *> dependentJobs;
+	{
+		// Decremented under the mutex so jobs that depend on the counter are either released here or see it complete when scheduled
+		std::lock_guard<std::mutex> lock{ counter->mutex };
+		if (counter->count.fetch_sub(1) != 1)
+		{
+			return;
+		}
+		dependentJobs.swap(counter->dependentJobs);
+	}
+
+	// The count is lowered before checking for sleeping threads, and waiters check it after announcing that they sleep, so a wake up can't be missed
+	if (sleepingThreadCount.load() > 0)
+	{
+		{
+			std::lock_guard<std::mutex> lock{ sleepMutex };
+		}
+		jobAvailable.notify_all();
+	}
+
+	for (Job *dependentJob : dependentJobs)
+	{
+		enqueue(dependentJob);
+	}
+}
+
+void JobSystem::run(uint32_t dequeIndex)
+{
+	workerJobSystem = this;
+	workerDequeIndex = static_cast<int32_t>(dequeIndex);
+
+	while (true)
+	{
+		Job *job = findJob(static_cast<int32_t>(dequeIndex));
+		if (job)
+		{
+			execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock{ sleepMutex };
+		sleepingThreadCount.fetch_add(1);
+		jobAvailable.wait(lock, [this]() { return stopping || queuedJobCount.load() > 0; });
+		sleepingThreadCount.fetch_sub(1);
+		if (stopping)
+		{
+			return;
+		}
+	}
+}
+
+} // namespace vulkr
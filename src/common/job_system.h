@@ -0,0 +1,170 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vulkr
+{
+
+class JobSystem;
+struct Job;
+
+/*
+ * Counts the jobs that are still outstanding, it's incremented when a job is scheduled with it and decremented once the job has run.
+ * Jobs that depend on a counter are held back until it reaches zero. A counter must not be destroyed before JobSystem::wait returned for it.
+ */
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	~JobCounter() = default;
+
+	JobCounter(const JobCounter &) = delete;
+	JobCounter(JobCounter &&) = delete;
+	JobCounter &operator=(const JobCounter &) = delete;
+	JobCounter &operator=(JobCounter &&) = delete;
+
+	bool isComplete() const;
+private:
+	friend class JobSystem;
+
+	std::atomic<uint32_t> count{ 0 };
+
+	// Jobs waiting for the counter to reach zero, guarded by the mutex so they can't be added while it's being released
+	// The last decrement also happens under it, so a waiter that locks it once the count is zero knows no job touches the counter anymore
+	mutable std::mutex mutex;
+	std::vector<Job *> dependentJobs;
+};
+
+struct Job
+{
+	std::function<void()> function;
+	JobCounter *counter{ nullptr };
+};
+
+/*
+ * A fixed size Chase-Lev work stealing deque of jobs, see "Correct and Efficient Work-Stealing for Weak Memory Models" (Le et al. 2013).
+ * Only the owning thread pushes and pops at the bottom, any thread can steal from the top.
+ */
+class WorkStealingDeque
+{
+public:
+	/* The capacity must be a power of two */
+	WorkStealingDeque(uint32_t capacity);
+	~WorkStealingDeque() = default;
+
+	WorkStealingDeque(const WorkStealingDeque &) = delete;
+	WorkStealingDeque(WorkStealingDeque &&) = delete;
+	WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+	WorkStealingDeque &operator=(WorkStealingDeque &&) = delete;
+
+	/* Returns false when the deque is full, owner only */
+	bool push(Job *job);
+
+	/* Returns the most recently pushed job or nullptr, owner only */
+	Job *pop();
+
+	/* Returns the oldest job or nullptr, also when losing a race with another thief or the owner */
+	Job *steal();
+private:
+	std::atomic<int64_t> top{ 0 };
+	std::atomic<int64_t> bottom{ 0 };
+	std::vector<std::atomic<Job *>> jobs;
+	const int64_t mask;
+};
+
+/*
+ * A work stealing scheduler for short, fine grained jobs such as culling, command recording and transform updates; blocking work like file IO belongs on a ThreadPool.
+ * Every worker and the thread that created the job system own a deque, jobs scheduled from other threads go through a shared queue.
+ * Waiting threads run jobs until the counter they wait on completes, and only sleep once every remaining job is running elsewhere.
+ */
+class JobSystem
+{
+public:
+	/* A worker count of 0 creates one worker per hardware thread besides the calling one */
+	JobSystem(uint32_t workerCount = 0);
+
+	/* Runs the jobs that are still queued before stopping the workers, jobs held back by a dependency that never completes are dropped */
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem(JobSystem &&) = delete;
+	JobSystem &operator=(const JobSystem &) = delete;
+	JobSystem &operator=(JobSystem &&) = delete;
+
+	/**
+	 * Queue a job
+	 * @param counter Incremented right away and decremented once the job has run, optional
+	 * @param dependency The job only becomes runnable once this counter reaches zero, optional
+	 */
+	void schedule(std::function<void()> function, JobCounter *counter = nullptr, JobCounter *dependency = nullptr);
+
+	/* Run jobs on the calling thread until the counter reaches zero */
+	void wait(const JobCounter &counter);
+
+	/**
+	 * Split [0, count) into ranges of grainSize elements and run them in parallel, returns once every range has run
+	 * @param function Called with the first and one past the last index of each range, a single range runs on the calling thread
+	 */
+	void parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t first, uint32_t last)> &function);
+
+	/* The number of threads running jobs, including the thread that created the job system */
+	uint32_t getThreadCount() const;
+private:
+	static constexpr uint32_t DEQUE_CAPACITY{ 4096 };
+
+	// The deque of the creating thread comes first, followed by one per worker
+	std::vector<std::unique_ptr<WorkStealingDeque>> deques;
+	std::vector<std::thread> workers;
+	std::thread::id ownerThreadId;
+
+	// Jobs scheduled from threads without a deque of their own, and those that didn't fit in a full deque
+	std::mutex sharedJobsMutex;
+	std::deque<Job *> sharedJobs;
+
+	// Idle workers sleep until jobs are queued, producers only take the mutex to wake them when some are sleeping
+	std::mutex sleepMutex;
+	std::condition_variable jobAvailable;
+	std::atomic<int64_t> queuedJobCount{ 0 };
+	std::atomic<uint32_t> sleepingThreadCount{ 0 };
+	std::atomic<bool> stopping{ false };
+
+	/* Returns the index of the deque owned by the calling thread or -1 */
+	int32_t getDequeIndex() const;
+
+	void enqueue(Job *job);
+	Job *findJob(int32_t dequeIndex);
+	void execute(Job *job);
+	void run(uint32_t dequeIndex);
+};
+
+} // namespace vulkr
@@ -0,0 +1,166 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mapped_file.h"
+#include "logger.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace vulkr
+{
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string &filename)
+{
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(file, &fileSize))
+	{
+		LOGW("Failed to query the size of {}", filename);
+		return;
+	}
+
+	size = static_cast<size_t>(fileSize.QuadPart);
+	if (size == 0)
+	{
+		// Zero sized files cannot be mapped
+		mapped = true;
+		return;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping == nullptr)
+	{
+		LOGW("Failed to create a file mapping for {}", filename);
+		return;
+	}
+	mappingHandle = mapping;
+
+	data = static_cast<const char *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+	mapped = data != nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+	if (data)
+	{
+		UnmapViewOfFile(data);
+	}
+
+	if (mappingHandle)
+	{
+		CloseHandle(static_cast<HANDLE>(mappingHandle));
+	}
+
+	if (fileHandle)
+	{
+		CloseHandle(static_cast<HANDLE>(fileHandle));
+	}
+}
+
+#else
+
+MappedFile::MappedFile(const std::string &filename)
+{
+	fileDescriptor = open(filename.c_str(), O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		return;
+	}
+
+	struct stat fileStatus{};
+	if (fstat(fileDescriptor, &fileStatus) != 0)
+	{
+		LOGW("Failed to query the size of {}", filename);
+		return;
+	}
+
+	size = static_cast<size_t>(fileStatus.st_size);
+	if (size == 0)
+	{
+		// Zero sized files cannot be mapped
+		mapped = true;
+		return;
+	}
+
+	void *mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	if (mapping == MAP_FAILED)
+	{
+		LOGW("Failed to memory map {}", filename);
+		return;
+	}
+
+	// The file is read front to back by the loaders, let the kernel read ahead aggressively
+	madvise(mapping, size, MADV_SEQUENTIAL);
+
+	data = static_cast<const char *>(mapping);
+	mapped = true;
+}
+
+MappedFile::~MappedFile()
+{
+	if (data)
+	{
+		munmap(const_cast<char *>(data), size);
+	}
+
+	if (fileDescriptor >= 0)
+	{
+		close(fileDescriptor);
+	}
+}
+
+#endif
+
+bool MappedFile::isMapped() const
+{
+	return mapped;
+}
+
+const char *MappedFile::getData() const
+{
+	return data;
+}
+
+size_t MappedFile::getSize() const
+{
+	return size;
+}
+
+} // namespace vulkr
@@ -0,0 +1,61 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <string>
+
+namespace vulkr
+{
+
+/* Read-only memory mapping of a whole file, the mapping is released when the object is destroyed */
+class MappedFile
+{
+public:
+	MappedFile(const std::string &filename);
+	~MappedFile();
+
+	MappedFile(MappedFile &&) = delete;
+	MappedFile(const MappedFile &) = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+	MappedFile &operator=(MappedFile &&) = delete;
+
+	/* Whether the file could be opened and mapped; empty files are considered mapped with a null data pointer */
+	bool isMapped() const;
+
+	const char *getData() const;
+
+	size_t getSize() const;
+private:
+	const char *data{ nullptr };
+	size_t size{ 0 };
+	bool mapped{ false };
+
+#ifdef _WIN32
+	void *fileHandle{ nullptr };
+	void *mappingHandle{ nullptr };
+#else
+	int fileDescriptor{ -1 };
+#endif
+};
+
+} // namespace vulkr
@@ -0,0 +1,172 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "offset_allocator.h"
+#include "logger.h"
+
+#include <iterator>
+
+namespace vulkr
+{
+
+OffsetAllocator::OffsetAllocator(uint64_t size) :
+	size{ size }
+{
+	reset();
+}
+
+bool OffsetAllocator::allocate(uint64_t allocationSize, uint64_t &offset)
+{
+	if (allocationSize == 0)
+	{
+		return false;
+	}
+
+	auto bestFit = freeRangesBySize.lower_bound(allocationSize);
+	if (bestFit == freeRangesBySize.end())
+	{
+		return false;
+	}
+
+	const uint64_t rangeOffset{ bestFit->second };
+	const uint64_t rangeSize{ bestFit->first };
+	eraseFreeRange(freeRangesByOffset.find(rangeOffset));
+
+	// The allocation takes the start of the range and the rest stays free
+	if (rangeSize > allocationSize)
+	{
+		insertFreeRange(rangeOffset + allocationSize, rangeSize - allocationSize);
+	}
+
+	usedSize += allocationSize;
+	offset = rangeOffset;
+
+	return true;
+}
+
+void OffsetAllocator::free(uint64_t offset, uint64_t rangeSize)
+{
+	if (rangeSize == 0 || offset + rangeSize > size)
+	{
+		LOGEANDABORT("Freeing the range [{}, {}) which is outside of the allocator of size {}", offset, offset + rangeSize, size);
+	}
+
+	auto next = freeRangesByOffset.lower_bound(offset);
+	if (next != freeRangesByOffset.end() && next->first < offset + rangeSize)
+	{
+		LOGEANDABORT("Freeing the range [{}, {}) which is already partly free", offset, offset + rangeSize);
+	}
+
+	usedSize -= rangeSize;
+
+	if (next != freeRangesByOffset.begin())
+	{
+		auto previous = std::prev(next);
+		if (previous->first + previous->second > offset)
+		{
+			LOGEANDABORT("Freeing the range [{}, {}) which is already partly free", offset, offset + rangeSize);
+		}
+
+		// Merge with the free range ending where this one starts
+		if (previous->first + previous->second == offset)
+		{
+			offset = previous->first;
+			rangeSize += previous->second;
+			eraseFreeRange(previous);
+		}
+	}
+
+	// Merge with the free range starting where this one ends
+	if (next != freeRangesByOffset.end() && next->first == offset + rangeSize)
+	{
+		rangeSize += next->second;
+		eraseFreeRange(next);
+	}
+
+	insertFreeRange(offset, rangeSize);
+}
+
+void OffsetAllocator::reset()
+{
+	freeRangesByOffset.clear();
+	freeRangesBySize.clear();
+	usedSize = 0;
+
+	if (size > 0)
+	{
+		insertFreeRange(0, size);
+	}
+}
+
+uint64_t OffsetAllocator::getSize() const
+{
+	return size;
+}
+
+uint64_t OffsetAllocator::getUsedSize() const
+{
+	return usedSize;
+}
+
+uint64_t OffsetAllocator::getLargestFreeRange() const
+{
+	return freeRangesBySize.empty() ? 0 : freeRangesBySize.rbegin()->first;
+}
+
+uint32_t OffsetAllocator::getFreeRangeCount() const
+{
+	return static_cast<uint32_t>(freeRangesByOffset.size());
+}
+
+float OffsetAllocator::getFragmentation() const
+{
+	const uint64_t freeSize{ size - usedSize };
+	if (freeSize == 0)
+	{
+		return 0.0f;
+	}
+
+	return 1.0f - static_cast<float>(getLargestFreeRange()) / static_cast<float>(freeSize);
+}
+
+void OffsetAllocator::insertFreeRange(uint64_t offset, uint64_t rangeSize)
+{
+	freeRangesByOffset.emplace(offset, rangeSize);
+	freeRangesBySize.emplace(rangeSize, offset);
+}
+
+void OffsetAllocator::eraseFreeRange(std::map<uint64_t, uint64_t>::iterator range)
+{
+	auto sizeRanges = freeRangesBySize.equal_range(range->second);
+	for (auto it = sizeRanges.first; it != sizeRanges.second; ++it)
+	{
+		if (it->second == range->first)
+		{
+			freeRangesBySize.erase(it);
+			break;
+		}
+	}
+
+	freeRangesByOffset.erase(range);
+}
+
+} // namespace vulkr
@@ -0,0 +1,75 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace vulkr
+{
+
+/*
+ * Hands out ranges of an abstract address space, such as elements of a GPU buffer, without touching the memory itself.
+ * Allocations take the smallest free range that fits and freed ranges are merged with their free neighbours, so the free list only fragments
+ * when live allocations are scattered between free ranges.
+ */
+class OffsetAllocator
+{
+public:
+	OffsetAllocator(uint64_t size);
+	~OffsetAllocator() = default;
+
+	OffsetAllocator(const OffsetAllocator &) = delete;
+	OffsetAllocator(OffsetAllocator &&) = delete;
+	OffsetAllocator &operator=(const OffsetAllocator &) = delete;
+	OffsetAllocator &operator=(OffsetAllocator &&) = delete;
+
+	/* Allocate a range from the smallest free range that is large enough; returns false if there is none, which may be due to fragmentation */
+	bool allocate(uint64_t size, uint64_t &offset);
+
+	/* Return a range previously handed out by allocate() */
+	void free(uint64_t offset, uint64_t size);
+
+	/* Free every allocation at once */
+	void reset();
+
+	uint64_t getSize() const;
+	uint64_t getUsedSize() const;
+	uint64_t getLargestFreeRange() const;
+	uint32_t getFreeRangeCount() const;
+
+	/* The fraction of the free space that is unusable for an allocation of the whole free size, 0 when the free space is a single range */
+	float getFragmentation() const;
+private:
+	uint64_t size;
+	uint64_t usedSize{ 0 };
+
+	/* Every free range is in both maps, by offset to find its neighbours and by size to find the best fit */
+	std::map<uint64_t, uint64_t> freeRangesByOffset;
+	std::multimap<uint64_t, uint64_t> freeRangesBySize;
+
+	void insertFreeRange(uint64_t offset, uint64_t size);
+	void eraseFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+};
+
+} // namespace vulkr
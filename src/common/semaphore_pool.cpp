@@ -22,6 +22,8 @@
 
 #include "semaphore_pool.h"
 
+#include <algorithm>
+
 namespace vulkr
 {
 
@@ -57,6 +59,20 @@ VkSemaphore SemaphorePool::requestSemaphore()
 	return semaphore;
 }
 
+void SemaphorePool::releaseSemaphore(VkSemaphore semaphore)
+{
+	// The active semaphores are kept at the front, so the released one swaps places with the last active one
+	auto activeEnd = semaphores.begin() + activeSemaphoreCount;
+	auto it = std::find(semaphores.begin(), activeEnd, semaphore);
+	if (it == activeEnd)
+	{
+		LOGEANDABORT("Attempting to release a semaphore that isn't active in the pool");
+	}
+
+	std::iter_swap(it, activeEnd - 1);
+	--activeSemaphoreCount;
+}
+
 void SemaphorePool::reset()
 {
 	activeSemaphoreCount = 0;
@@ -42,6 +42,9 @@ public:
 	/* Obtain a semaphore */
 	VkSemaphore requestSemaphore();
 
+	/* Return a single semaphore to the pool so it can be handed out again before the next reset, it must not have a pending signal or wait */
+	void releaseSemaphore(VkSemaphore semaphore);
+
 	void reset();
 
 	int32_t getActiveSemaphoreCount() const;
@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace vulkr
+{
+
+/* A fixed set of worker threads running tasks from a shared FIFO queue, for long running work such as decoding assets off the main thread */
+class ThreadPool
+{
+public:
+	/* A thread count of 0 creates one worker per hardware thread */
+	ThreadPool(uint32_t threadCount = 0);
+
+	/* Waits for the tasks that are running to finish, tasks that haven't started yet are discarded and their futures are left broken */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool(ThreadPool &&) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+	ThreadPool &operator=(ThreadPool &&) = delete;
+
+	/* Queue a task, the returned future holds its result or the exception it threw */
+	template <typename F>
+	std::future<std::invoke_result_t<F>> push(F &&function)
+	{
+		// std::function requires a copyable callable, so the move only packaged task is shared instead
+		auto task = std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(function));
+		std::future<std::invoke_result_t<F>> result = task->get_future();
+		{
+			std::lock_guard<std::mutex> lock{ mutex };
+			tasks.emplace_back([task]() { (*task)(); });
+		}
+		taskAvailable.notify_one();
+
+		return result;
+	}
+
+	uint32_t getThreadCount() const;
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable taskAvailable;
+	bool stopping{ false };
+
+	void run();
+};
+
+} // namespace vulkr
@@ -0,0 +1,94 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "timeline_semaphore.h"
+
+#include <algorithm>
+
+namespace vulkr
+{
+
+TimelineSemaphore::TimelineSemaphore(Device &device) :
+	device{ device }
+{
+	VkSemaphoreTypeCreateInfoKHR semaphoreTypeCreateInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR };
+	semaphoreTypeCreateInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+	semaphoreTypeCreateInfo.initialValue = 0;
+
+	VkSemaphoreCreateInfo semaphoreCreateInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+	semaphoreCreateInfo.pNext = &semaphoreTypeCreateInfo;
+
+	VK_CHECK(vkCreateSemaphore(device.getHandle(), &semaphoreCreateInfo, nullptr, &handle));
+}
+
+TimelineSemaphore::~TimelineSemaphore()
+{
+	if (handle != VK_NULL_HANDLE)
+	{
+		wait(pendingValue);
+		vkDestroySemaphore(device.getHandle(), handle, nullptr);
+	}
+}
+
+VkSemaphore TimelineSemaphore::getHandle() const
+{
+	return handle;
+}
+
+uint64_t TimelineSemaphore::advance()
+{
+	return ++pendingValue;
+}
+
+uint64_t TimelineSemaphore::getPendingValue() const
+{
+	return pendingValue;
+}
+
+uint64_t TimelineSemaphore::getCompletedValue()
+{
+	VK_CHECK(vkGetSemaphoreCounterValueKHR(device.getHandle(), handle, &completedValue));
+	return completedValue;
+}
+
+bool TimelineSemaphore::isComplete(uint64_t value)
+{
+	return value <= completedValue || value <= getCompletedValue();
+}
+
+void TimelineSemaphore::wait(uint64_t value, uint64_t timeout)
+{
+	if (isComplete(value))
+	{
+		return;
+	}
+
+	VkSemaphoreWaitInfoKHR waitInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR };
+	waitInfo.semaphoreCount = 1;
+	waitInfo.pSemaphores = &handle;
+	waitInfo.pValues = &value;
+
+	VK_CHECK(vkWaitSemaphoresKHR(device.getHandle(), &waitInfo, timeout));
+	completedValue = std::max(completedValue, value);
+}
+
+} // namespace vulkr
@@ -0,0 +1,71 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "vulkan_common.h"
+#include "core/device.h"
+
+namespace vulkr
+{
+
+/*
+ * A VK_KHR_timeline_semaphore counter tracking the submissions to a queue: each submission signals the next value of the counter, so the
+ * host can wait on (or poll) any earlier submission by its value without a fence per submission that has to be reset and recycled
+ */
+class TimelineSemaphore
+{
+public:
+	TimelineSemaphore(Device &device);
+	~TimelineSemaphore();
+
+	TimelineSemaphore(const TimelineSemaphore &) = delete;
+	TimelineSemaphore(TimelineSemaphore &&) = delete;
+	TimelineSemaphore &operator=(const TimelineSemaphore &) = delete;
+	TimelineSemaphore &operator=(TimelineSemaphore &&) = delete;
+
+	VkSemaphore getHandle() const;
+
+	/* Reserve the value signalled by the next submission, values are handed out in submission order */
+	uint64_t advance();
+
+	/* The value signalled by the latest submission, which the counter reaches once the queue is done with everything submitted so far */
+	uint64_t getPendingValue() const;
+
+	/* Query the value the GPU has reached */
+	uint64_t getCompletedValue();
+
+	/* Whether the GPU has reached the value, only queries the semaphore when the last value seen is behind */
+	bool isComplete(uint64_t value);
+
+	/* Block until the GPU has reached the value, returns immediately for values that were already reached (including 0) */
+	void wait(uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max());
+private:
+	Device &device;
+
+	VkSemaphore handle{ VK_NULL_HANDLE };
+
+	uint64_t pendingValue{ 0 };
+	uint64_t completedValue{ 0 };
+};
+
+} // namespace vulkr
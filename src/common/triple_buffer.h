@@ -0,0 +1,94 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace vulkr
+{
+
+/*
+ * Hands values from a single producer thread to a single consumer thread without locking, neither of them ever waits on the other.
+ * The producer fills the write buffer and publishes it, the consumer acquires the most recently published one; values published in between are skipped.
+ * The three buffers are reused, so a buffer holds whatever was last written into it when it's handed back to the producer.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() = default;
+	~TripleBuffer() = default;
+
+	TripleBuffer(const TripleBuffer &) = delete;
+	TripleBuffer(TripleBuffer &&) = delete;
+	TripleBuffer &operator=(const TripleBuffer &) = delete;
+	TripleBuffer &operator=(TripleBuffer &&) = delete;
+
+	/* The buffer the producer fills before publishing it, producer only */
+	T &getWriteBuffer()
+	{
+		return buffers[writeIndex];
+	}
+
+	/* Make the write buffer the latest value and take over the buffer it replaces, producer only */
+	void publish()
+	{
+		// The release makes the writes to the buffer visible to the consumer that takes it, the acquire does the same for the consumer's reads of the buffer we get back
+		uint8_t previous = middle.exchange(static_cast<uint8_t>(writeIndex | NEW_DATA_BIT), std::memory_order_acq_rel);
+		writeIndex = previous & INDEX_MASK;
+	}
+
+	/* Take the latest published value if there is one that wasn't acquired yet, returns whether the read buffer changed; consumer only */
+	bool acquire()
+	{
+		if ((middle.load(std::memory_order_relaxed) & NEW_DATA_BIT) == 0)
+		{
+			return false;
+		}
+
+		// Only the producer sets the bit, so it's still set here and the exchange hands back the published buffer
+		uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+		readIndex = previous & INDEX_MASK;
+		return true;
+	}
+
+	/* The buffer acquired last, consumer only */
+	const T &getReadBuffer() const
+	{
+		return buffers[readIndex];
+	}
+private:
+	static constexpr uint8_t INDEX_MASK{ 0x3 };
+	static constexpr uint8_t NEW_DATA_BIT{ 0x4 };
+
+	std::array<T, 3> buffers;
+
+	// The buffer that is owned by neither side, with NEW_DATA_BIT set when it was published and not acquired yet
+	std::atomic<uint8_t> middle{ 1 };
+	uint8_t writeIndex{ 0 }; // Owned by the producer
+	uint8_t readIndex{ 2 }; // Owned by the consumer
+};
+
+} // namespace vulkr
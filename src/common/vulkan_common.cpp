@@ -120,4 +120,21 @@ VkFormat getSupportedDepthFormat(VkPhysicalDevice physicalDeviceHandle, bool dep
 	}
 
 	throw std::runtime_error("Failed to find a supported format");
+}
+
+VkFormat getSupportedSampledFormat(VkPhysicalDevice physicalDeviceHandle, const std::vector<VkFormat> &formatPriorityList)
+{
+	for (VkFormat format : formatPriorityList)
+	{
+		VkFormatProperties properties;
+		vkGetPhysicalDeviceFormatProperties(physicalDeviceHandle, format, &properties);
+
+		const VkFormatFeatureFlags requiredFeatures{ VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT };
+		if ((properties.optimalTilingFeatures & requiredFeatures) == requiredFeatures)
+		{
+			return format;
+		}
+	}
+
+	return VK_FORMAT_UNDEFINED;
 }
\ No newline at end of file
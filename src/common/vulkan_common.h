@@ -64,4 +64,7 @@ VkFormat getSupportedDepthFormat(
 		VK_FORMAT_D32_SFLOAT_S8_UINT,
 		VK_FORMAT_D24_UNORM_S8_UINT
 	}
-);
\ No newline at end of file
+);
+
+/* Determine the first format of a priority list that optimally tiled images can be sampled from with linear filtering, VK_FORMAT_UNDEFINED if there is none */
+VkFormat getSupportedSampledFormat(VkPhysicalDevice physicalDeviceHandle, const std::vector<VkFormat> &formatPriorityList);
\ No newline at end of file
@@ -46,14 +46,16 @@ Buffer::Buffer(Buffer &&other) :
 	allocation{ other.allocation },
 	allocationInfo{ other.allocationInfo },
 	size{ other.size },
-	mappedData{ other.mappedData },
-	mapped{ other.mapped }
+	persistent{ other.persistent },
+	mapped{ other.mapped },
+	mappedData{ other.mappedData }
 {
 	other.handle = VK_NULL_HANDLE;
 	other.allocation = VK_NULL_HANDLE;
 	other.allocationInfo = {};
 	other.mappedData = nullptr;
 	other.mapped = false;
+	other.persistent = false;
 }
 
 Buffer::~Buffer()
@@ -97,6 +99,12 @@ VkDeviceSize Buffer::getSize() const
 
 void *Buffer::map()
 {
+	// Persistently mapped buffers keep their pointer for the lifetime of the allocation
+	if (persistent)
+	{
+		return mappedData;
+	}
+
 	if (!mapped)
 	{
 		VK_CHECK(vmaMapMemory(device.getMemoryAllocator(), allocation, reinterpret_cast<void **>(&mappedData)));
@@ -107,6 +115,11 @@ void *Buffer::map()
 
 void Buffer::unmap()
 {
+	if (persistent)
+	{
+		return;
+	}
+
 	if (!mapped)
 	{
 		LOGEANDABORT("Trying to unmap memory on a buffer that's not mapped");
@@ -122,6 +135,11 @@ void Buffer::flush() const
 	vmaFlushAllocation(device.getMemoryAllocator(), allocation, 0, size);
 }
 
+void Buffer::flush(VkDeviceSize offset, VkDeviceSize size) const
+{
+	vmaFlushAllocation(device.getMemoryAllocator(), allocation, offset, size);
+}
+
 void Buffer::update(const std::vector<uint8_t>& data, size_t offset)
 {
 	update(data.data(), data.size(), offset);
@@ -134,19 +152,23 @@ void Buffer::update(void* data, size_t size, size_t offset)
 
 void Buffer::update(const uint8_t *data, const size_t size, const size_t offset)
 {
-	// TODO fix this
-	//if (persistent)
-	//{
-	//	std::copy(data, data + size, mappedData + offset);
-	//	flush();
-	//}
-	//else
-	//{
-	//	map();
-	//	std::copy(data, data + size, mappedData + offset);
-	//	flush();
-	//	unmap();
-	//}
+	if (offset + size > this->size)
+	{
+		LOGEANDABORT("Buffer update of {} bytes at offset {} is out of range of the {} byte buffer", size, offset, this->size);
+	}
+
+	if (persistent)
+	{
+		std::copy(data, data + size, mappedData + offset);
+		flush(offset, size);
+	}
+	else
+	{
+		map();
+		std::copy(data, data + size, mappedData + offset);
+		flush(offset, size);
+		unmap();
+	}
 }
 
 } // namespace vulkr
\ No newline at end of file
@@ -52,19 +52,22 @@ public:
 	/* Flushes memory if it is HOST_VISIBLE and not HOST_COHERENT */
 	void flush() const;
 
+	/* Flushes a range of the memory if it is HOST_VISIBLE and not HOST_COHERENT */
+	void flush(VkDeviceSize offset, VkDeviceSize size) const;
+
 	/**
 	 * Maps vulkan memory if it isn't already mapped to an host visible address
+	 * Persistently mapped buffers (created with VMA_ALLOCATION_CREATE_MAPPED_BIT) return their existing mapping
 	 * @return Pointer to host visible memory
 	 */
 	void *map();
 
-	/* Unmaps vulkan memory from the host visible address */
+	/* Unmaps vulkan memory from the host visible address, a no-op for persistently mapped buffers */
 	void unmap();
 
 	/* Gets the size of the buffer */
 	VkDeviceSize getSize() const;
 
-	// TODO: take a look at these functions again to see if they're useful
 	/**
 		* Copies byte data into the buffer
 		* @param data The data to copy from
@@ -115,7 +118,7 @@ private:
 
 	// Whether the buffer has been mapped with vmaMapMemory
 	bool mapped{ false };
-	void *mappedData{ nullptr };
+	uint8_t *mappedData{ nullptr };
 };
 
 } // namespace vulkr
\ No newline at end of file
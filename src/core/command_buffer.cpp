@@ -98,17 +98,17 @@ void CommandBuffer::begin(VkCommandBufferUsageFlags flags, CommandBuffer *primar
 			LOGEANDABORT("Primary command buffer expected but received a secondary command buffer");
 		}
 
-		LOGEANDABORT("Secondary command buffers not handled yet. Need to implement!!"); /* TODO: Remove this eventually */
-
-		//auto render_pass_binding = primaryCommandBuffer->get_current_render_pass();
-		//current_render_pass.render_pass = render_pass_binding.render_pass;
-		//current_render_pass.framebuffer = render_pass_binding.framebuffer;
+		if (primaryCommandBuffer->currentRenderPass == nullptr)
+		{
+			LOGEANDABORT("Secondary command buffers can only be started while the primary command buffer is recording a render pass");
+		}
 
-		//inheritance.renderPass = current_render_pass.render_pass->get_handle();
-		//inheritance.framebuffer = current_render_pass.framebuffer->get_handle();
-		//inheritance.subpass = primaryCommandBuffer->get_current_subpass_index();
+		inheritance.renderPass = primaryCommandBuffer->currentRenderPass->getHandle();
+		inheritance.framebuffer = primaryCommandBuffer->currentFramebuffer->getHandle();
+		inheritance.subpass = primaryCommandBuffer->currentSubpassIndex;
 
-		//beginInfo.pInheritanceInfo = &inheritance;
+		beginInfo.flags |= VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		beginInfo.pInheritanceInfo = &inheritance;
 	}
 
 	VK_CHECK(vkBeginCommandBuffer(handle, &beginInfo));
@@ -138,18 +138,62 @@ void CommandBuffer::beginRenderPass(RenderPass &renderPass, Framebuffer &framebu
 	renderPassBeginInfo.pClearValues = clearValues.data();
 
 	vkCmdBeginRenderPass(handle, &renderPassBeginInfo, subpassContents);
+
+	currentRenderPass = &renderPass;
+	currentFramebuffer = &framebuffer;
+	currentSubpassIndex = 0;
 }
 
 void CommandBuffer::endRenderPass()
 {
 	vkCmdEndRenderPass(handle);
+
+	currentRenderPass = nullptr;
+	currentFramebuffer = nullptr;
+}
+
+void CommandBuffer::executeCommands(const std::vector<std::shared_ptr<CommandBuffer>> &secondaryCommandBuffers)
+{
+	if (level != VK_COMMAND_BUFFER_LEVEL_PRIMARY)
+	{
+		LOGEANDABORT("Secondary command buffers can only be executed from a primary command buffer");
+	}
+
+	std::vector<VkCommandBuffer> secondaryCommandBufferHandles;
+	secondaryCommandBufferHandles.reserve(secondaryCommandBuffers.size());
+	for (const std::shared_ptr<CommandBuffer> &secondaryCommandBuffer : secondaryCommandBuffers)
+	{
+		if (secondaryCommandBuffer->getLevel() != VK_COMMAND_BUFFER_LEVEL_SECONDARY || secondaryCommandBuffer->state != State::Executable)
+		{
+			LOGEANDABORT("Only secondary command buffers that have finished recording can be executed");
+		}
+		secondaryCommandBufferHandles.push_back(secondaryCommandBuffer->getHandle());
+	}
+
+	if (!secondaryCommandBufferHandles.empty())
+	{
+		vkCmdExecuteCommands(handle, to_u32(secondaryCommandBufferHandles.size()), secondaryCommandBufferHandles.data());
+	}
 }
 
 void CommandBuffer::reset()
 {
+	if ((commandPool.getFlags() & VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT) == 0)
+	{
+		LOGEANDABORT("Command buffers can only be reset individually when their pool was created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT");
+	}
+
 	VK_CHECK(vkResetCommandBuffer(handle, 0));
 
+	onPoolReset();
+}
+
+void CommandBuffer::onPoolReset()
+{
 	state = State::Initial;
+	currentRenderPass = nullptr;
+	currentFramebuffer = nullptr;
+	currentSubpassIndex = 0;
 }
 
 } // namespace vulkr
\ No newline at end of file
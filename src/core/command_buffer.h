@@ -22,6 +22,9 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "common/vulkan_common.h"
 
 namespace vulkr
@@ -60,6 +63,7 @@ public:
 
 	bool isRecording() const;
 
+	/* Secondary command buffers continue the render pass the primary command buffer is currently recording, which they inherit */
 	void begin(VkCommandBufferUsageFlags flags, CommandBuffer* primary_cmd_buf = nullptr);
 
 	void end();
@@ -68,8 +72,17 @@ public:
 
 	void endRenderPass();
 
+	/* Execute secondary command buffers that have finished recording, inside a render pass begun with VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS */
+	void executeCommands(const std::vector<std::shared_ptr<CommandBuffer>> &secondaryCommandBuffers);
+
+	/* Only allowed when the pool was created with VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, otherwise the whole pool is reset with CommandPool::reset */
 	void reset();
 private:
+	friend class CommandPool;
+
+	/* Called by the pool once it has reset all of its command buffers */
+	void onPoolReset();
+
 	VkCommandBuffer handle{ VK_NULL_HANDLE };
 
 	State state{ State::Initial };
@@ -80,6 +93,11 @@ private:
 
 	uint32_t maxPushConstantsSize;
 
+	/* The render pass being recorded, inherited by secondary command buffers */
+	const RenderPass *currentRenderPass{ nullptr };
+	const Framebuffer *currentFramebuffer{ nullptr };
+	uint32_t currentSubpassIndex{ 0 };
+
 	//std::vector<uint8_t> stored_push_constants;
 
 	//VkExtent2D last_framebuffer_extent{};
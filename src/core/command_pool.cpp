@@ -54,8 +54,11 @@ CommandPool::CommandPool(CommandPool &&other) :
 	device{ other.device },
 	handle{ other.handle },
 	queueFamilyIndex{ other.queueFamilyIndex },
+	flags{ other.flags },
 	primaryCommandBuffers{ std::move(other.primaryCommandBuffers) },
-	secondaryCommandBuffers{ std::move(other.secondaryCommandBuffers) }
+	activePrimaryCommandBufferCount{ other.activePrimaryCommandBufferCount },
+	secondaryCommandBuffers{ std::move(other.secondaryCommandBuffers) },
+	activeSecondaryCommandBufferCount{ other.activeSecondaryCommandBufferCount }
 {
 	other.handle = VK_NULL_HANDLE;
 
@@ -78,6 +81,11 @@ VkCommandPool CommandPool::getHandle() const
 	return handle;
 }
 
+VkCommandPoolCreateFlags CommandPool::getFlags() const
+{
+	return flags;
+}
+
 std::shared_ptr<CommandBuffer> CommandPool::requestCommandBuffer(VkCommandBufferLevel level)
 {
 	if (level == VK_COMMAND_BUFFER_LEVEL_PRIMARY)
@@ -108,4 +116,22 @@ std::shared_ptr<CommandBuffer> CommandPool::requestCommandBuffer(VkCommandBuffer
 	LOGEANDABORT("Unknown command buffer level type requested");
 }
 
+void CommandPool::reset()
+{
+	// A single call for the whole pool, which also lets the driver recycle the memory of the command buffers as a block
+	VK_CHECK(vkResetCommandPool(device.getHandle(), handle, 0));
+
+	for (const std::shared_ptr<CommandBuffer> &commandBuffer : primaryCommandBuffers)
+	{
+		commandBuffer->onPoolReset();
+	}
+	for (const std::shared_ptr<CommandBuffer> &commandBuffer : secondaryCommandBuffers)
+	{
+		commandBuffer->onPoolReset();
+	}
+
+	activePrimaryCommandBufferCount = 0;
+	activeSecondaryCommandBufferCount = 0;
+}
+
 } // namespace vulkr
\ No newline at end of file
@@ -48,9 +48,13 @@ public:
 
 	uint32_t getQueueFamilyIndex() const;
 
+	VkCommandPoolCreateFlags getFlags() const;
+
+	/* Hands out the command buffers allocated since the last reset before allocating new ones */
 	std::shared_ptr<CommandBuffer> requestCommandBuffer(VkCommandBufferLevel level = VK_COMMAND_BUFFER_LEVEL_PRIMARY);
 
-	// TODO: look into vkresetcommandpool and vkreset command buffers
+	/* Reset every command buffer of the pool at once, they are handed out again by requestCommandBuffer; none of them may still be in use by the device */
+	void reset();
 
 private:
 	Device &device;
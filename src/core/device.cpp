@@ -30,6 +30,8 @@
 #define VMA_IMPLEMENTATION
 #include <vk_mem_alloc.h>
 
+#include <algorithm>
+
 namespace vulkr
 {
 
@@ -64,6 +66,14 @@ Device::Device(std::unique_ptr<PhysicalDevice> &&selectedPhysicalDevice, VkSurfa
 		LOGI("Dedicated allocation enabled");
 	}
 
+	// Lets indirect draws read their draw count from a buffer written on the GPU, without it they fall back to a fixed count of draws
+	if (isExtensionSupported(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) && !isExtensionEnabled(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME))
+	{
+		enabledExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+
+		LOGI("Indirect draw count enabled");
+	}
+
 	// Prepare the device queues
 	uint32_t queueFamilyPropertiesCount{ to_u32(this->physicalDevice->getQueueFamilyProperties().size()) };
 	std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
@@ -95,6 +105,14 @@ Device::Device(std::unique_ptr<PhysicalDevice> &&selectedPhysicalDevice, VkSurfa
 	createInfo.ppEnabledExtensionNames = enabledExtensions.data();
 	createInfo.pEnabledFeatures = &requestedFeatures;
 
+	// Every implementation of the extension supports the feature, but it still has to be enabled
+	VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineSemaphoreFeatures{ VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR };
+	if (isExtensionEnabled(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME))
+	{
+		timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+		createInfo.pNext = &timelineSemaphoreFeatures;
+	}
+
 	VK_CHECK(vkCreateDevice(this->physicalDevice->getHandle(), &createInfo, nullptr, &handle));
 
 	// Create queues
@@ -158,6 +176,9 @@ Device::Device(std::unique_ptr<PhysicalDevice> &&selectedPhysicalDevice, VkSurfa
 
 Device::~Device()
 {
+	// The resources still hold their memory, so they go before the allocator
+	flushDeferredDestructions();
+
 	if (memoryAllocator != VK_NULL_HANDLE)
 	{
 		VmaStats stats;
@@ -222,6 +243,23 @@ const Queue &Device::getQueueByFlags(VkQueueFlags desiredQueueFlags)
 	LOGEANDABORT("Could not find a queue with the desired queueflags");
 }
 
+const Queue &Device::getDedicatedTransferQueue()
+{
+	for (uint32_t queueFamilyIndex = 0u; queueFamilyIndex < queues.size(); ++queueFamilyIndex)
+	{
+		Queue &firstQueueInFamily = queues[queueFamilyIndex][0];
+
+		// Every graphics or compute family supports transfers too, so only a family that can't do either is dedicated to them
+		const bool isTransferOnly{ !firstQueueInFamily.supportsQueueFlags(VK_QUEUE_GRAPHICS_BIT) && !firstQueueInFamily.supportsQueueFlags(VK_QUEUE_COMPUTE_BIT) };
+		if (firstQueueInFamily.getProperties().queueCount > 0 && firstQueueInFamily.supportsQueueFlags(VK_QUEUE_TRANSFER_BIT) && isTransferOnly)
+		{
+			return firstQueueInFamily;
+		}
+	}
+
+	return getOptimalGraphicsQueue();
+}
+
 const Queue &Device::getQueueByPresentation()
 {
 	for (uint32_t queueFamilyIndex = 0u; queueFamilyIndex < queues.size(); ++queueFamilyIndex)
@@ -273,4 +311,43 @@ uint32_t Device::getMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags pr
 	LOGEANDABORT("Failed to find suitable memory type!");
 }
 
+void Device::deferDestruction(std::shared_ptr<void> resource, uint64_t timelineValue)
+{
+	if (!resource)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock{ deferredDestructionMutex };
+
+	// Resources are almost always deferred in timeline order, so this nearly always appends
+	auto it = std::upper_bound(deferredDestructions.begin(), deferredDestructions.end(), timelineValue, [](uint64_t value, const DeferredDestruction &destruction) {
+		return value < destruction.timelineValue;
+	});
+	deferredDestructions.insert(it, DeferredDestruction{ timelineValue, std::move(resource) });
+}
+
+void Device::releaseDeferredDestructions(uint64_t completedTimelineValue)
+{
+	// The resources are destroyed once the lock is released, so their destructors can't hold up the threads deferring more
+	std::vector<std::shared_ptr<void>> completedResources;
+	{
+		std::lock_guard<std::mutex> lock{ deferredDestructionMutex };
+		while (!deferredDestructions.empty() && deferredDestructions.front().timelineValue <= completedTimelineValue)
+		{
+			completedResources.push_back(std::move(deferredDestructions.front().resource));
+			deferredDestructions.pop_front();
+		}
+	}
+}
+
+void Device::flushDeferredDestructions()
+{
+	std::deque<DeferredDestruction> remainingDestructions;
+	{
+		std::lock_guard<std::mutex> lock{ deferredDestructionMutex };
+		remainingDestructions.swap(deferredDestructions);
+	}
+}
+
 } // namespace vulkr
\ No newline at end of file
@@ -24,6 +24,10 @@
 
 #include "common/vulkan_common.h"
 
+#include <deque>
+#include <memory>
+#include <mutex>
+
 namespace vulkr
 {
 
@@ -56,6 +60,9 @@ public:
 	/* Get a queue with the desired queue flags */
 	const Queue &getQueueByFlags(VkQueueFlags desiredQueueFlags);
 
+	/* Get the first queue of a transfer only family (the copy engine of most discrete gpus), else fall back to the optimal graphics queue */
+	const Queue &getDedicatedTransferQueue();
+
 	/* Get the first available queue that supports presentation. This is only called when the graphics queue does not support presentation */
 	const Queue &getQueueByPresentation();
 
@@ -64,6 +71,22 @@ public:
 
 	/* Get the memory type for the specified memoryPropertyFlags */
 	uint32_t getMemoryType(uint32_t memoryTypeBits, VkMemoryPropertyFlags propertieFlags);
+
+	/**
+	 * Keep a resource alive until the GPU is done with it instead of idling the device to destroy it, can be called from any thread
+	 * @param resource Destroyed when its last reference goes away, so any owning pointer to a buffer, image, view, pipeline, descriptor set etc. can be handed over
+	 * @param timelineValue The graphics timeline value of the last submission that may use the resource
+	 */
+	void deferDestruction(std::shared_ptr<void> resource, uint64_t timelineValue);
+
+	/* Destroy the deferred resources whose timeline value the GPU has reached, called once per frame */
+	void releaseDeferredDestructions(uint64_t completedTimelineValue);
+
+	/* Destroy every deferred resource, the device must be idle */
+	void flushDeferredDestructions();
+
+	/* Check if an extension is enabled */
+	bool isExtensionEnabled(const char* extension) const;
 private:
 	/* The logical device handle */
 	VkDevice handle{ VK_NULL_HANDLE };
@@ -83,14 +106,21 @@ private:
 	/* Check if a specified extension is supported */
 	bool isExtensionSupported(const char *extension) const;
 
-	/* Check if an extension is enabled */
-	bool isExtensionEnabled(const char* extension) const;
-
 	/* The memory allocator */
 	VmaAllocator memoryAllocator{ VK_NULL_HANDLE };
 
+	struct DeferredDestruction
+	{
+		uint64_t timelineValue;
+		std::shared_ptr<void> resource;
+	};
+
+	/* The resources waiting for the GPU to finish with them, ordered by timeline value */
+	std::deque<DeferredDestruction> deferredDestructions;
+	std::mutex deferredDestructionMutex;
+
 	/* TODO
-	- Dedicated transfer queue is very under utilized so it can be used to defragment memeory, streaming resources or textures
+	- Dedicated transfer queue is only used to stream textures, it could also be used to defragment memory
 	- Add the command pool and the fence pool?
 	- Add a resource cache if necessary
 	*/
@@ -31,6 +31,10 @@ namespace vulkr
 {
 
 Framebuffer::Framebuffer(Device &device, const Swapchain &swapchain, const RenderPass &renderPass, std::vector<VkImageView> attachments) :
+	Framebuffer{ device, swapchain.getProperties().imageExtent, renderPass, attachments }
+{}
+
+Framebuffer::Framebuffer(Device &device, VkExtent2D extent, const RenderPass &renderPass, std::vector<VkImageView> attachments) :
 	device{ device }
 {
 	VkFramebufferCreateInfo framebufferInfo{ VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO };
@@ -38,8 +42,8 @@ Framebuffer::Framebuffer(Device &device, const Swapchain &swapchain, const Rende
 	framebufferInfo.renderPass = renderPass.getHandle();
 	framebufferInfo.attachmentCount = to_u32(attachments.size());
 	framebufferInfo.pAttachments = attachments.data(); // TODO: should we make attachments a reference to vector
-	framebufferInfo.width = swapchain.getProperties().imageExtent.width;
-	framebufferInfo.height = swapchain.getProperties().imageExtent.height;
+	framebufferInfo.width = extent.width;
+	framebufferInfo.height = extent.height;
 	framebufferInfo.layers = 1;
 
 	VK_CHECK(vkCreateFramebuffer(device.getHandle(), &framebufferInfo, nullptr, &handle));
@@ -35,6 +35,7 @@ class Framebuffer
 {
 public:
 	Framebuffer(Device &device, const Swapchain &swapchain, const RenderPass &renderPass, std::vector<VkImageView> attachments);
+	Framebuffer(Device &device, VkExtent2D extent, const RenderPass &renderPass, std::vector<VkImageView> attachments);
 	~Framebuffer();
 
 	Framebuffer(Framebuffer &&) = delete;
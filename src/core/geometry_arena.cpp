@@ -0,0 +1,247 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "geometry_arena.h"
+#include "device.h"
+#include "buffer.h"
+#include "upload_context.h"
+#include "common/helpers.h"
+
+namespace vulkr
+{
+
+GeometryArena::GeometryArena(Device &device, VkDeviceSize vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity) :
+	device{ device },
+	vertexStride{ vertexStride },
+	vertexAllocator{ vertexCapacity },
+	indexAllocator{ indexCapacity }
+{
+	if (vertexCapacity == 0 || indexCapacity == 0)
+	{
+		LOGEANDABORT("A geometry arena requires room for at least one vertex and one index");
+	}
+
+	vertexBuffer = createBuffer(vertexStride * vertexCapacity, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	indexBuffer = createBuffer(sizeof(uint32_t) * indexCapacity, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+GeometryArena::~GeometryArena()
+{
+	indexBuffer.reset();
+	vertexBuffer.reset();
+}
+
+bool GeometryArena::allocate(uint32_t vertexCount, uint32_t indexCount, GeometryHandle &handle)
+{
+	uint64_t vertexOffset{ 0 };
+	if (vertexCount > 0 && !vertexAllocator.allocate(vertexCount, vertexOffset))
+	{
+		return false;
+	}
+
+	uint64_t firstIndex{ 0 };
+	if (indexCount > 0 && !indexAllocator.allocate(indexCount, firstIndex))
+	{
+		if (vertexCount > 0)
+		{
+			vertexAllocator.free(vertexOffset, vertexCount);
+		}
+		return false;
+	}
+
+	if (freeHandles.empty())
+	{
+		freeHandles.push_back(to_u32(entries.size()));
+		entries.emplace_back();
+	}
+
+	handle = freeHandles.back();
+	freeHandles.pop_back();
+
+	Entry &entry = entries[handle];
+	entry.allocation.vertexOffset = static_cast<int32_t>(vertexOffset);
+	entry.allocation.vertexCount = vertexCount;
+	entry.allocation.firstIndex = static_cast<uint32_t>(firstIndex);
+	entry.allocation.indexCount = indexCount;
+	entry.allocated = true;
+
+	return true;
+}
+
+void GeometryArena::free(GeometryHandle handle)
+{
+	checkHandle(handle);
+	Entry &entry = entries[handle];
+
+	if (entry.allocation.vertexCount > 0)
+	{
+		vertexAllocator.free(static_cast<uint64_t>(entry.allocation.vertexOffset), entry.allocation.vertexCount);
+	}
+	if (entry.allocation.indexCount > 0)
+	{
+		indexAllocator.free(entry.allocation.firstIndex, entry.allocation.indexCount);
+	}
+
+	entry = Entry{};
+	freeHandles.push_back(handle);
+}
+
+const GeometryAllocation &GeometryArena::getAllocation(GeometryHandle handle) const
+{
+	checkHandle(handle);
+	return entries[handle].allocation;
+}
+
+void GeometryArena::uploadVertices(UploadContext &uploadContext, GeometryHandle handle, const Buffer &srcBuffer, VkDeviceSize srcOffset)
+{
+	const GeometryAllocation &allocation = getAllocation(handle);
+	uploadContext.copyBufferToBuffer(srcBuffer, *vertexBuffer, vertexStride * allocation.vertexCount, srcOffset, vertexStride * static_cast<VkDeviceSize>(allocation.vertexOffset));
+}
+
+void GeometryArena::uploadIndices(UploadContext &uploadContext, GeometryHandle handle, const Buffer &srcBuffer, VkDeviceSize srcOffset)
+{
+	const GeometryAllocation &allocation = getAllocation(handle);
+	uploadContext.copyBufferToBuffer(srcBuffer, *indexBuffer, sizeof(uint32_t) * allocation.indexCount, srcOffset, sizeof(uint32_t) * static_cast<VkDeviceSize>(allocation.firstIndex));
+}
+
+void GeometryArena::bind(VkCommandBuffer commandBuffer) const
+{
+	VkBuffer vertexBuffers[] = { vertexBuffer->getHandle() };
+	VkDeviceSize offsets[] = { 0 };
+	vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+	vkCmdBindIndexBuffer(commandBuffer, indexBuffer->getHandle(), 0, VK_INDEX_TYPE_UINT32);
+}
+
+void GeometryArena::defragment(UploadContext &uploadContext)
+{
+	if (uploadContext.transfersOwnership())
+	{
+		LOGEANDABORT("The geometry arena must be defragmented on the queue that draws it");
+	}
+
+	std::unique_ptr<Buffer> compactVertexBuffer = createBuffer(vertexStride * vertexAllocator.getSize(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+	std::unique_ptr<Buffer> compactIndexBuffer = createBuffer(sizeof(uint32_t) * indexAllocator.getSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+
+	// Allocating from empty allocators hands out consecutive ranges from the start, so every allocation ends up packed against the previous one
+	vertexAllocator.reset();
+	indexAllocator.reset();
+
+	std::vector<VkBufferCopy> vertexCopies;
+	std::vector<VkBufferCopy> indexCopies;
+	for (Entry &entry : entries)
+	{
+		if (!entry.allocated)
+		{
+			continue;
+		}
+
+		GeometryAllocation &allocation = entry.allocation;
+		if (allocation.vertexCount > 0)
+		{
+			uint64_t vertexOffset{ 0 };
+			vertexAllocator.allocate(allocation.vertexCount, vertexOffset);
+			vertexCopies.push_back({ vertexStride * static_cast<VkDeviceSize>(allocation.vertexOffset), vertexStride * vertexOffset, vertexStride * allocation.vertexCount });
+			allocation.vertexOffset = static_cast<int32_t>(vertexOffset);
+		}
+		if (allocation.indexCount > 0)
+		{
+			uint64_t firstIndex{ 0 };
+			indexAllocator.allocate(allocation.indexCount, firstIndex);
+			indexCopies.push_back({ sizeof(uint32_t) * static_cast<VkDeviceSize>(allocation.firstIndex), sizeof(uint32_t) * firstIndex, sizeof(uint32_t) * allocation.indexCount });
+			allocation.firstIndex = static_cast<uint32_t>(firstIndex);
+		}
+	}
+
+	// The uploads recorded before this, possibly into the same batch, wrote the old buffers with transfers that must land before they are copied
+	VkCommandBuffer commandBuffer = uploadContext.getCommandBuffer();
+	VkMemoryBarrier uploadBarrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+	uploadBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	uploadBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &uploadBarrier, 0, nullptr, 0, nullptr);
+
+	// The indices are relative to the vertex offset of their draw, so moving the geometry doesn't require rewriting them
+	if (!vertexCopies.empty())
+	{
+		vkCmdCopyBuffer(commandBuffer, vertexBuffer->getHandle(), compactVertexBuffer->getHandle(), to_u32(vertexCopies.size()), vertexCopies.data());
+	}
+	if (!indexCopies.empty())
+	{
+		vkCmdCopyBuffer(commandBuffer, indexBuffer->getHandle(), compactIndexBuffer->getHandle(), to_u32(indexCopies.size()), indexCopies.data());
+	}
+
+	VkMemoryBarrier barrier{ VK_STRUCTURE_TYPE_MEMORY_BARRIER };
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT;
+	vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+
+	// The old buffers are the source of the copies and may still be drawn from by the frames in flight
+	uploadContext.retainStagingBuffer(std::move(vertexBuffer));
+	uploadContext.retainStagingBuffer(std::move(indexBuffer));
+
+	vertexBuffer = std::move(compactVertexBuffer);
+	indexBuffer = std::move(compactIndexBuffer);
+}
+
+GeometryArenaStats GeometryArena::getStats() const
+{
+	GeometryArenaStats stats;
+	stats.allocationCount = to_u32(entries.size() - freeHandles.size());
+	stats.vertexBytesUsed = vertexStride * vertexAllocator.getUsedSize();
+	stats.vertexBytesCapacity = vertexStride * vertexAllocator.getSize();
+	stats.indexBytesUsed = sizeof(uint32_t) * indexAllocator.getUsedSize();
+	stats.indexBytesCapacity = sizeof(uint32_t) * indexAllocator.getSize();
+	stats.vertexFreeRangeCount = vertexAllocator.getFreeRangeCount();
+	stats.indexFreeRangeCount = indexAllocator.getFreeRangeCount();
+	stats.vertexFragmentation = vertexAllocator.getFragmentation();
+	stats.indexFragmentation = indexAllocator.getFragmentation();
+
+	return stats;
+}
+
+VkDeviceSize GeometryArena::getVertexStride() const
+{
+	return vertexStride;
+}
+
+std::unique_ptr<Buffer> GeometryArena::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) const
+{
+	// Transfer source is required to copy the contents into a new buffer when defragmenting
+	VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+	bufferInfo.size = size;
+	bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+	VmaAllocationCreateInfo memoryInfo{};
+	memoryInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	return std::make_unique<Buffer>(device, bufferInfo, memoryInfo);
+}
+
+void GeometryArena::checkHandle(GeometryHandle handle) const
+{
+	if (handle >= entries.size() || !entries[handle].allocated)
+	{
+		LOGEANDABORT("Invalid geometry handle {}", handle);
+	}
+}
+
+} // namespace vulkr
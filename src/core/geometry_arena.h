@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/vulkan_common.h"
+#include "common/offset_allocator.h"
+
+namespace vulkr
+{
+
+class Device;
+class Buffer;
+class UploadContext;
+
+/* Identifies an allocation of a GeometryArena, it stays valid when the arena is defragmented even though the offsets of the allocation change */
+using GeometryHandle = uint32_t;
+constexpr GeometryHandle INVALID_GEOMETRY_HANDLE{ ~0u };
+
+/* The location of an allocation in elements, which are passed straight to vkCmdDrawIndexed */
+struct GeometryAllocation
+{
+	int32_t vertexOffset{ 0 };
+	uint32_t vertexCount{ 0 };
+	uint32_t firstIndex{ 0 };
+	uint32_t indexCount{ 0 };
+};
+
+struct GeometryArenaStats
+{
+	uint32_t allocationCount{ 0 };
+	VkDeviceSize vertexBytesUsed{ 0 };
+	VkDeviceSize vertexBytesCapacity{ 0 };
+	VkDeviceSize indexBytesUsed{ 0 };
+	VkDeviceSize indexBytesCapacity{ 0 };
+	uint32_t vertexFreeRangeCount{ 0 };
+	uint32_t indexFreeRangeCount{ 0 };
+	float vertexFragmentation{ 0.0f };
+	float indexFragmentation{ 0.0f };
+};
+
+/*
+ * Sub-allocates the geometry of every mesh from a single device local vertex buffer and a single 32 bit index buffer, so that all of them
+ * are drawn with one bind and could be drawn with a single indirect draw
+ */
+class GeometryArena
+{
+public:
+	GeometryArena(Device &device, VkDeviceSize vertexStride, uint32_t vertexCapacity, uint32_t indexCapacity);
+	~GeometryArena();
+
+	GeometryArena(GeometryArena &&) = delete;
+	GeometryArena(const GeometryArena &) = delete;
+	GeometryArena &operator=(const GeometryArena &) = delete;
+	GeometryArena &operator=(GeometryArena &&) = delete;
+
+	/* Reserve room for the vertices and indices of a mesh; returns false if either buffer doesn't have a free range large enough */
+	bool allocate(uint32_t vertexCount, uint32_t indexCount, GeometryHandle &handle);
+
+	/* Release an allocation, the caller must make sure no frame in flight still draws it */
+	void free(GeometryHandle handle);
+
+	const GeometryAllocation &getAllocation(GeometryHandle handle) const;
+
+	/* Record the copy of the vertices (or indices) of an allocation from a staging buffer */
+	void uploadVertices(UploadContext &uploadContext, GeometryHandle handle, const Buffer &srcBuffer, VkDeviceSize srcOffset);
+	void uploadIndices(UploadContext &uploadContext, GeometryHandle handle, const Buffer &srcBuffer, VkDeviceSize srcOffset);
+
+	/* Bind the vertex and index buffers, which is all every draw from the arena needs */
+	void bind(VkCommandBuffer commandBuffer) const;
+
+	/**
+	 * Pack every allocation at the start of new buffers so the free space becomes a single range again
+	 * The copies are recorded into the upload context, which must submit to the queue drawing the geometry: the old buffers are kept alive by its batch,
+	 * so they outlive the frames in flight submitted before it. The batch must be submitted before any frame drawing with the new offsets
+	 */
+	void defragment(UploadContext &uploadContext);
+
+	GeometryArenaStats getStats() const;
+	VkDeviceSize getVertexStride() const;
+private:
+	struct Entry
+	{
+		GeometryAllocation allocation;
+		bool allocated{ false };
+	};
+
+	Device &device;
+	VkDeviceSize vertexStride;
+
+	std::unique_ptr<Buffer> vertexBuffer{ nullptr };
+	std::unique_ptr<Buffer> indexBuffer{ nullptr };
+	OffsetAllocator vertexAllocator;
+	OffsetAllocator indexAllocator;
+
+	std::vector<Entry> entries;
+	std::vector<GeometryHandle> freeHandles;
+
+	std::unique_ptr<Buffer> createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) const;
+	void checkHandle(GeometryHandle handle) const;
+};
+
+} // namespace vulkr
@@ -234,4 +234,9 @@ uint32_t Image::getArrayLayerCount() const
 	return arrayLayerCount;
 }
 
+uint32_t Image::getMipLevelCount() const
+{
+	return subresource.mipLevel;
+}
+
 } // namespace vulkr
\ No newline at end of file
@@ -88,6 +88,8 @@ public:
 
 	uint32_t getArrayLayerCount() const;
 
+	uint32_t getMipLevelCount() const;
+
 private:
 	Device &device;
 
@@ -29,7 +29,7 @@
 namespace vulkr
 {
 
-Instance::Instance(std::string applicationName)
+Instance::Instance(std::string applicationName, const std::vector<const char *> &requiredSurfaceExtensions)
 {
     VK_CHECK(volkInitialize());
 
@@ -50,7 +50,7 @@ Instance::Instance(std::string applicationName)
     VkInstanceCreateInfo createInfo{ VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO };
     createInfo.pApplicationInfo = &appInfo;
 
-    std::vector<const char*> extensions = getRequiredInstanceExtensions();
+    std::vector<const char*> extensions = getRequiredInstanceExtensions(requiredSurfaceExtensions);
     createInfo.enabledExtensionCount = to_u32(extensions.size());
     createInfo.ppEnabledExtensionNames = extensions.data();
 
@@ -121,12 +121,12 @@ bool Instance::checkValidationLayerSupport() const
     return true;
 }
 
-std::vector<const char *> Instance::getRequiredInstanceExtensions() const
+std::vector<const char *> Instance::getRequiredInstanceExtensions(const std::vector<const char *> &requiredSurfaceExtensions) const
 {
-    uint32_t glfwExtensionCount{ 0u };
-    const char **glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+    std::vector<const char *> extensions(requiredSurfaceExtensions);
 
-    std::vector<const char *> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+    // Required by VK_KHR_timeline_semaphore on a Vulkan 1.0 instance
+    extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 
 #ifdef VULKR_DEBUG
     extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -29,14 +29,13 @@
 #include "common/vulkan_common.h"
 #include "physical_device.h"
 
-#include <GLFW/glfw3.h>
 namespace vulkr 
 {
 
 class Instance 
 {
 public:
-	Instance(std::string applicationName);
+	Instance(std::string applicationName, const std::vector<const char *> &requiredSurfaceExtensions);
 	~Instance();
 	
 	Instance(const Instance &) = delete;
@@ -75,8 +74,8 @@ private:
 	/* Check if requiredValidationLayers are all available */
 	bool checkValidationLayerSupport() const;
 
-	/* Get all required instances */
-	std::vector<const char*> getRequiredInstanceExtensions() const;
+	/* Get all required instance extensions, which is the surface extensions along with any debug extensions */
+	std::vector<const char*> getRequiredInstanceExtensions(const std::vector<const char *> &requiredSurfaceExtensions) const;
 };
 
 } // namespace vulkr
\ No newline at end of file
@@ -33,7 +33,7 @@
 namespace vulkr
 {
 
-Pipeline::Pipeline(Device &device, PipelineState &pipelineState) : device{ device }, pipelineState{ pipelineState } {}
+Pipeline::Pipeline(Device &device) : device{ device } {}
 
 Pipeline::~Pipeline()
 {
@@ -42,8 +42,7 @@ Pipeline::~Pipeline()
 
 Pipeline::Pipeline(Pipeline &&other) :
 	device{ other.device },
-	handle{ other.handle },
-	pipelineState{ other.pipelineState }
+	handle{ other.handle }
 {
 	other.handle = VK_NULL_HANDLE;
 }
@@ -53,7 +52,7 @@ VkPipeline Pipeline::getHandle() const
 	return handle;
 }
 
-GraphicsPipeline::GraphicsPipeline(Device &device, PipelineState &pipelineState, VkPipelineCache pipelineCache) : Pipeline{ device, pipelineState }
+GraphicsPipeline::GraphicsPipeline(Device &device, PipelineState &pipelineState, VkPipelineCache pipelineCache) : Pipeline{ device }
 {
 	std::vector<VkShaderModule> shaderModuleHandles;
 
@@ -147,10 +146,9 @@ GraphicsPipeline::GraphicsPipeline(Device &device, PipelineState &pipelineState,
 	color_blend_state.blendConstants[2] = pipelineState.getColorBlendState().blendConstants[2];
 	color_blend_state.blendConstants[3] = pipelineState.getColorBlendState().blendConstants[3];
 
-	// TODO: update this
-	//VkPipelineDynamicStateCreateInfo dynamicState{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
-	//dynamicState.pDynamicStates = pipelineState.getDyanmicStates().data();
-	//dynamicState.dynamicStateCount = to_u32(pipelineState.getDyanmicStates().size());
+	VkPipelineDynamicStateCreateInfo dynamicState{ VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO };
+	dynamicState.pDynamicStates = pipelineState.getDyanmicStates().data();
+	dynamicState.dynamicStateCount = to_u32(pipelineState.getDyanmicStates().size());
 
 	VkGraphicsPipelineCreateInfo graphicsPipeline{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO };
 	graphicsPipeline.stageCount = to_u32(shaderStageCreateInfos.size());
@@ -162,7 +160,7 @@ GraphicsPipeline::GraphicsPipeline(Device &device, PipelineState &pipelineState,
 	graphicsPipeline.pMultisampleState = &multisampleState;
 	graphicsPipeline.pDepthStencilState = &depthStencilState;
 	graphicsPipeline.pColorBlendState = &color_blend_state;
-	//graphicsPipeline.pDynamicState = &dynamicStates; // TODO: update this when dynamic states are enabled
+	graphicsPipeline.pDynamicState = &dynamicState;
 
 	graphicsPipeline.layout = pipelineState.getPipelineLayout().getHandle();
 	graphicsPipeline.renderPass = pipelineState.getRenderPass().getHandle();
@@ -180,4 +178,31 @@ GraphicsPipeline::GraphicsPipeline(Device &device, PipelineState &pipelineState,
 	}
 }
 
+ComputePipeline::ComputePipeline(Device &device, const PipelineLayout &pipelineLayout, VkPipelineCache pipelineCache) : Pipeline{ device }
+{
+	const std::vector<ShaderModule> &shaderModules = pipelineLayout.getShaderModules();
+	if (shaderModules.size() != 1 || shaderModules[0].getStage() != VK_SHADER_STAGE_COMPUTE_BIT)
+	{
+		LOGEANDABORT("A compute pipeline requires exactly one compute shader module");
+	}
+	const ShaderModule &shaderModule = shaderModules[0];
+
+	VkShaderModuleCreateInfo shaderModuleCreateInfo{ VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+	shaderModuleCreateInfo.codeSize = shaderModule.getShaderSource().getData().size();
+	shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t *>(shaderModule.getShaderSource().getData().data());
+
+	VkComputePipelineCreateInfo computePipeline{ VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+	computePipeline.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	computePipeline.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+	computePipeline.stage.pName = shaderModule.getEntryPoint().c_str();
+	computePipeline.layout = pipelineLayout.getHandle();
+	computePipeline.basePipelineHandle = VK_NULL_HANDLE;
+	computePipeline.basePipelineIndex = -1;
+	VK_CHECK(vkCreateShaderModule(device.getHandle(), &shaderModuleCreateInfo, nullptr, &computePipeline.stage.module));
+
+	VK_CHECK(vkCreateComputePipelines(device.getHandle(), pipelineCache, 1, &computePipeline, nullptr, &handle));
+
+	vkDestroyShaderModule(device.getHandle(), computePipeline.stage.module, nullptr);
+}
+
 } // namespace vulkr
\ No newline at end of file
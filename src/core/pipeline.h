@@ -29,6 +29,7 @@ namespace vulkr
 
 class Device;
 class PipelineState;
+class PipelineLayout;
 
 class Pipeline
 {
@@ -43,10 +44,9 @@ public:
 	VkPipeline getHandle() const;
 
 protected:
-	Pipeline(Device &device, PipelineState &pipelineState);
+	Pipeline(Device &device);
 	VkPipeline handle = VK_NULL_HANDLE;
 	Device &device; 
-	PipelineState &pipelineState;
 };
 
 class GraphicsPipeline final : public Pipeline
@@ -57,5 +57,13 @@ public:
 	GraphicsPipeline(GraphicsPipeline &&) = default;
 };
 
-// TODO: create compute pipeline
+class ComputePipeline final : public Pipeline
+{
+public:
+	/* The pipeline layout must hold a single compute shader module */
+	ComputePipeline(Device &device, const PipelineLayout &pipelineLayout, VkPipelineCache pipelineCache);
+	~ComputePipeline() = default;
+	ComputePipeline(ComputePipeline &&) = default;
+};
+
 } // namespace vulkr
\ No newline at end of file
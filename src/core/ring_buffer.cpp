@@ -0,0 +1,148 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ring_buffer.h"
+#include "device.h"
+#include "buffer.h"
+#include "common/helpers.h"
+
+namespace vulkr
+{
+
+RingBuffer::RingBuffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, uint32_t frameCount, const std::vector<uint32_t> &queueFamilyIndices) :
+	device{ device },
+	size{ size }
+{
+	if (frameCount == 0)
+	{
+		LOGEANDABORT("A ring buffer requires at least one frame");
+	}
+
+	VkBufferCreateInfo bufferInfo{ VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO };
+	bufferInfo.size = size;
+	bufferInfo.usage = usage;
+	bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+	if (queueFamilyIndices.size() > 1)
+	{
+		bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+		bufferInfo.queueFamilyIndexCount = to_u32(queueFamilyIndices.size());
+		bufferInfo.pQueueFamilyIndices = queueFamilyIndices.data();
+	}
+
+	VmaAllocationCreateInfo memoryInfo{};
+	memoryInfo.usage = VMA_MEMORY_USAGE_CPU_TO_GPU;
+	memoryInfo.flags = VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+	buffer = std::make_unique<Buffer>(device, bufferInfo, memoryInfo);
+
+	frameEnds.resize(frameCount, 0);
+}
+
+RingBuffer::~RingBuffer()
+{
+	buffer.reset();
+}
+
+void RingBuffer::beginFrame(uint32_t frameIndex)
+{
+	if (frameIndex >= frameEnds.size())
+	{
+		LOGEANDABORT("Frame index {} is out of range for a ring buffer with {} frames", frameIndex, frameEnds.size());
+	}
+
+	frameEnds[activeFrame] = head;
+
+	// The caller has waited on this frame's fence so everything it allocated the last time around can be reused
+	tail = std::max(tail, frameEnds[frameIndex]);
+	activeFrame = frameIndex;
+}
+
+void RingBuffer::setFrameCount(uint32_t frameCount)
+{
+	if (frameCount == 0)
+	{
+		LOGEANDABORT("A ring buffer requires at least one frame");
+	}
+
+	tail = head;
+	frameEnds.assign(frameCount, head);
+	activeFrame = 0;
+}
+
+bool RingBuffer::allocate(VkDeviceSize allocationSize, VkDeviceSize alignment, RingAllocation &allocation)
+{
+	if (allocationSize == 0 || allocationSize > size)
+	{
+		return false;
+	}
+
+	alignment = std::max<VkDeviceSize>(alignment, 1);
+
+	uint64_t position = head;
+	VkDeviceSize offset = (position % size + alignment - 1) & ~(alignment - 1);
+	if (offset + allocationSize > size)
+	{
+		// Sub-allocations never straddle the end of the buffer, skip the remainder and wrap around to the start
+		position += size - position % size;
+		offset = 0;
+	}
+	else
+	{
+		position += offset - position % size;
+	}
+
+	uint64_t newHead = position + allocationSize;
+	if (newHead - tail > size)
+	{
+		return false;
+	}
+
+	head = newHead;
+
+	allocation.offset = offset;
+	allocation.size = allocationSize;
+	allocation.mappedData = static_cast<uint8_t *>(buffer->map()) + offset;
+
+	return true;
+}
+
+void RingBuffer::flush(const RingAllocation &allocation) const
+{
+	buffer->flush(allocation.offset, allocation.size);
+}
+
+const Buffer &RingBuffer::getBuffer() const
+{
+	return *buffer;
+}
+
+VkDeviceSize RingBuffer::getSize() const
+{
+	return size;
+}
+
+VkDeviceSize RingBuffer::getUsedSize() const
+{
+	return head - tail;
+}
+
+} // namespace vulkr
@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "common/vulkan_common.h"
+
+namespace vulkr
+{
+
+class Device;
+class Buffer;
+
+/* A sub-allocation handed out by the RingBuffer */
+struct RingAllocation
+{
+	VkDeviceSize offset{ 0 };
+	VkDeviceSize size{ 0 };
+	uint8_t *mappedData{ nullptr };
+};
+
+/*
+ * A persistently mapped buffer that hands out linear, aligned sub-allocations for data that only lives for a frame (staging copies, uniforms and SSBO writes).
+ * Each frame in flight owns the region it allocated from, which is recycled once beginFrame() is called again for the same frame index; by then the
+ * caller must have waited for the GPU to finish that frame.
+ */
+class RingBuffer
+{
+public:
+	/**
+	 * @param queueFamilyIndices The queue families accessing the buffer if there is more than one, such as a transfer queue reading staging copies,
+	 * in which case the buffer is shared concurrently since its regions are recycled between families without ownership transfers
+	 */
+	RingBuffer(Device &device, VkDeviceSize size, VkBufferUsageFlags usage, uint32_t frameCount, const std::vector<uint32_t> &queueFamilyIndices = {});
+	~RingBuffer();
+
+	RingBuffer(RingBuffer &&) = delete;
+	RingBuffer(const RingBuffer &) = delete;
+	RingBuffer &operator=(const RingBuffer &) = delete;
+	RingBuffer &operator=(RingBuffer &&) = delete;
+
+	/* Close the region of the previous frame and recycle the region previously used by this frame index */
+	void beginFrame(uint32_t frameIndex);
+
+	/* Change the number of frames in flight, the GPU must have finished every frame allocated from the ring so all of it is recycled */
+	void setFrameCount(uint32_t frameCount);
+
+	/**
+	 * Sub-allocate from the ring for the current frame
+	 * @param size The amount of bytes required
+	 * @param alignment The required alignment of the offset, must be a power of two
+	 * @param allocation Filled in with the offset and mapped pointer of the sub-allocation on success
+	 * @return False if the ring doesn't have enough free space, in which case the caller should fall back to a dedicated buffer
+	 */
+	bool allocate(VkDeviceSize size, VkDeviceSize alignment, RingAllocation &allocation);
+
+	/* Flushes the sub-allocation if the memory is not HOST_COHERENT */
+	void flush(const RingAllocation &allocation) const;
+
+	const Buffer &getBuffer() const;
+
+	VkDeviceSize getSize() const;
+
+	/* Gets the amount of bytes currently held by frames in flight, including the padding lost to alignment and wrapping */
+	VkDeviceSize getUsedSize() const;
+private:
+	Device &device;
+
+	std::unique_ptr<Buffer> buffer{ nullptr };
+
+	VkDeviceSize size{ 0 };
+
+	// Head and tail are monotonically increasing positions, the offset into the buffer is the position modulo the size
+	uint64_t head{ 0 };
+	uint64_t tail{ 0 };
+
+	// The head position at the end of each frame index's most recent frame
+	std::vector<uint64_t> frameEnds;
+	uint32_t activeFrame{ 0 };
+};
+
+} // namespace vulkr
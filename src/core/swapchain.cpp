@@ -38,7 +38,7 @@ Swapchain::Swapchain(
     Device &device,
     VkSurfaceKHR surface,
     const VkSurfaceTransformFlagBitsKHR transform,
-    const VkPresentModeKHR presentMode,
+    const std::vector<VkPresentModeKHR> &presentModePriorityList,
     const std::set<VkImageUsageFlagBits> &imageUsageFlags):
     device{device}, surface{surface}
 {
@@ -77,12 +77,31 @@ Swapchain::Swapchain(
     properties.imageUsage = chooseImageUsage(imageUsageFlags, surfaceCapabilities.supportedUsageFlags, formatProperties.optimalTilingFeatures);
     properties.preTransform = choosePreTransform(transform, surfaceCapabilities.supportedTransforms, surfaceCapabilities.currentTransform);
     properties.compositeAlpha = chooseCompositeAlpha(VK_COMPOSITE_ALPHA_INHERIT_BIT_KHR, surfaceCapabilities.supportedCompositeAlpha);
-    properties.presentMode = choosePresentMode(presentMode);
+    properties.presentMode = choosePresentMode(presentModePriorityList);
     properties.clipped = VK_TRUE;
 
     create();
 }
 
+Swapchain::Swapchain(Swapchain &oldSwapchain, const std::vector<VkPresentModeKHR> &presentModePriorityList) :
+    surface{ oldSwapchain.surface },
+    device{ oldSwapchain.device },
+    properties{ oldSwapchain.properties },
+    availableSurfaceFormats{ oldSwapchain.availableSurfaceFormats },
+    availablePresentModes{ oldSwapchain.availablePresentModes }
+{
+    // Only the extent and transform are re-queried, the surface formats and present modes don't change when the window is resized
+    VkSurfaceCapabilitiesKHR surfaceCapabilities{};
+    VK_CHECK(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device.getPhysicalDevice().getHandle(), surface, &surfaceCapabilities));
+
+    properties.imageExtent = chooseImageExtent(surfaceCapabilities.currentExtent, surfaceCapabilities.minImageExtent, surfaceCapabilities.maxImageExtent);
+    properties.preTransform = choosePreTransform(properties.preTransform, surfaceCapabilities.supportedTransforms, surfaceCapabilities.currentTransform);
+    properties.presentMode = choosePresentMode(presentModePriorityList);
+    properties.oldSwapchain = oldSwapchain.getHandle();
+
+    create();
+}
+
 Swapchain::~Swapchain()
 {
     if (handle != VK_NULL_HANDLE)
@@ -310,29 +329,20 @@ VkCompositeAlphaFlagBitsKHR Swapchain::chooseCompositeAlpha(VkCompositeAlphaFlag
     LOGEANDABORT("A compatible composite alpha was not found.");
 }
 
-VkPresentModeKHR Swapchain::choosePresentMode(VkPresentModeKHR requestedPresentMode) const
+VkPresentModeKHR Swapchain::choosePresentMode(const std::vector<VkPresentModeKHR> &presentModePriorityList) const
 {
-    auto presentModeIt = std::find(availablePresentModes.begin(), availablePresentModes.end(), requestedPresentMode);
-
-    if (presentModeIt == availablePresentModes.end())
+    for (VkPresentModeKHR presentMode : presentModePriorityList)
     {
-        // If nothing found, default to FIFO since that's guarenteed to be supported
-        VkPresentModeKHR chosenPresentMode = VK_PRESENT_MODE_FIFO_KHR;
-
-        for (auto& present_mode : presentModePriorityList)
+        if (std::find(availablePresentModes.begin(), availablePresentModes.end(), presentMode) != availablePresentModes.end())
         {
-            if (std::find(availablePresentModes.begin(), availablePresentModes.end(), present_mode) != availablePresentModes.end())
-            {
-                chosenPresentMode = present_mode;
-            }
+            LOGI("(Swapchain) Present mode selected: {}", to_string(presentMode));
+            return presentMode;
         }
-
-        LOGW("(Swapchain) Present mode '{}' not supported. Selecting '{}'.", to_string(requestedPresentMode), to_string(chosenPresentMode));
-        return chosenPresentMode;
     }
 
-    LOGI("(Swapchain) Present mode selected: {}", to_string(requestedPresentMode));
-    return *presentModeIt;
+    // If nothing found, default to FIFO since that's guarenteed to be supported
+    LOGW("(Swapchain) None of the requested present modes are supported. Selecting '{}'.", to_string(VK_PRESENT_MODE_FIFO_KHR));
+    return VK_PRESENT_MODE_FIFO_KHR;
 }
 
 } // namespace vulkr
\ No newline at end of file
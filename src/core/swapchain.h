@@ -53,8 +53,10 @@ public:
 		Device &device,
 		VkSurfaceKHR surface,
 		const VkSurfaceTransformFlagBitsKHR transform,
-		const VkPresentModeKHR presentMode,
+		const std::vector<VkPresentModeKHR> &presentModePriorityList,
 		const std::set<VkImageUsageFlagBits> &imageUsageFlags);
+	/* Recreate the swapchain at the current surface extent, keeping the properties of the old swapchain which is retired but still has to be destroyed by the caller */
+	Swapchain(Swapchain &oldSwapchain, const std::vector<VkPresentModeKHR> &presentModePriorityList);
 	~Swapchain();
 
 	Swapchain(const Swapchain &) = delete;
@@ -93,12 +95,6 @@ private:
 	/* All available present modes available to use */
 	std::vector<VkPresentModeKHR> availablePresentModes{};
 
-	/* A list of present modes in decreasing priority */
-	const std::vector<VkPresentModeKHR> presentModePriorityList = {
-		VK_PRESENT_MODE_FIFO_KHR, /* Ideal option */
-		VK_PRESENT_MODE_MAILBOX_KHR
-	};
-
 	/* A list of surface formats in descreasing priority */
 	const std::vector<VkSurfaceFormatKHR> surfaceFormatPriorityList = {
 		{VK_FORMAT_B8G8R8A8_SRGB, VK_COLOR_SPACE_SRGB_NONLINEAR_KHR}, /* Ideal option */
@@ -134,9 +130,8 @@ private:
 	VkImageUsageFlags chooseImageUsage(const std::set<VkImageUsageFlagBits> &requestedImageUsageFlags, VkImageUsageFlags supportedImageUsage, VkFormatFeatureFlags supportedFormatFeatures) const;
 	VkSurfaceTransformFlagBitsKHR choosePreTransform(VkSurfaceTransformFlagBitsKHR requestedTransform, VkSurfaceTransformFlagsKHR supportedTransform, VkSurfaceTransformFlagBitsKHR currentTransform) const;
 	VkCompositeAlphaFlagBitsKHR chooseCompositeAlpha(VkCompositeAlphaFlagBitsKHR requestedCompositeAlpha, VkCompositeAlphaFlagsKHR supportedCompositeAlpha) const;
-	VkPresentModeKHR choosePresentMode(VkPresentModeKHR requestedPresentMode) const;
+	VkPresentModeKHR choosePresentMode(const std::vector<VkPresentModeKHR> &presentModePriorityList) const;
 	// clipped
-	// old swapchain
 };
 
 } // namespace vulkr
\ No newline at end of file
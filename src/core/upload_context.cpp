@@ -0,0 +1,500 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "upload_context.h"
+#include "device.h"
+#include "physical_device.h"
+#include "queue.h"
+#include "command_pool.h"
+#include "command_buffer.h"
+#include "buffer.h"
+#include "image.h"
+#include "common/helpers.h"
+
+#include <algorithm>
+
+namespace vulkr
+{
+
+namespace
+{
+
+// Only used for the upload statistics, so unknown formats fall back to the common 4 byte texel
+VkDeviceSize getImageDataSize(VkFormat format, uint32_t width, uint32_t height)
+{
+	const VkDeviceSize texelCount{ static_cast<VkDeviceSize>(width) * height };
+	const VkDeviceSize blockCount{ static_cast<VkDeviceSize>((width + 3) / 4) * ((height + 3) / 4) };
+
+	switch (format)
+	{
+	case VK_FORMAT_R8_UNORM:
+	case VK_FORMAT_R8_SRGB:
+		return texelCount;
+	case VK_FORMAT_R8G8_UNORM:
+	case VK_FORMAT_R8G8_SRGB:
+		return texelCount * 2;
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+		return texelCount * 8;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return texelCount * 16;
+	case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+	case VK_FORMAT_BC1_RGBA_UNORM_BLOCK:
+	case VK_FORMAT_BC1_RGBA_SRGB_BLOCK:
+		return blockCount * 8;
+	case VK_FORMAT_BC3_UNORM_BLOCK:
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+	case VK_FORMAT_BC7_UNORM_BLOCK:
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return blockCount * 16;
+	default:
+		return texelCount * 4;
+	}
+}
+
+} // namespace
+
+UploadContext::UploadContext(Device &device, const Queue &queue) :
+	UploadContext{ device, queue, queue }
+{
+}
+
+UploadContext::UploadContext(Device &device, const Queue &queue, const Queue &destinationQueue) :
+	device{ device },
+	queue{ queue },
+	destinationQueue{ destinationQueue }
+{
+	commandPool = std::make_unique<CommandPool>(device, queue.getFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+
+	if (transfersOwnership())
+	{
+		acquireCommandPool = std::make_unique<CommandPool>(device, destinationQueue.getFamilyIndex(), VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT);
+	}
+}
+
+UploadContext::~UploadContext()
+{
+	flush();
+
+	for (VkFence fence : freeFences)
+	{
+		vkDestroyFence(device.getHandle(), fence, nullptr);
+	}
+	freeFences.clear();
+
+	for (VkSemaphore semaphore : freeSemaphores)
+	{
+		vkDestroySemaphore(device.getHandle(), semaphore, nullptr);
+	}
+	freeSemaphores.clear();
+
+	acquireCommandPool.reset();
+	commandPool.reset();
+}
+
+VkCommandBuffer UploadContext::getCommandBuffer()
+{
+	if (!recordingBatch)
+	{
+		recordingBatch = std::make_unique<Batch>();
+		recordingBatch->commandBuffer = std::make_unique<CommandBuffer>(*commandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+		recordingBatch->commandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
+	}
+
+	return recordingBatch->commandBuffer->getHandle();
+}
+
+void UploadContext::copyBufferToBuffer(const Buffer &srcBuffer, const Buffer &dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset)
+{
+	VkBufferCopy copyRegion{};
+	copyRegion.srcOffset = srcOffset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(getCommandBuffer(), srcBuffer.getHandle(), dstBuffer.getHandle(), 1, &copyRegion);
+
+	if (transfersOwnership())
+	{
+		VkBufferMemoryBarrier barrier{ VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER };
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.buffer = dstBuffer.getHandle();
+		barrier.offset = dstOffset;
+		barrier.size = size;
+		transferOwnership(barrier, VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT);
+	}
+
+	totalBytesUploaded += size;
+}
+
+void UploadContext::copyBufferToImage(const Buffer &srcBuffer, const Image &dstImage, uint32_t width, uint32_t height, VkDeviceSize srcOffset, uint32_t mipLevel)
+{
+	VkBufferImageCopy region{};
+	region.bufferOffset = srcOffset;
+	region.bufferRowLength = 0;
+	region.bufferImageHeight = 0;
+	region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	region.imageSubresource.mipLevel = mipLevel;
+	region.imageSubresource.baseArrayLayer = 0;
+	region.imageSubresource.layerCount = 1;
+	region.imageOffset = { 0, 0, 0 };
+	region.imageExtent = { width, height, 1 };
+
+	vkCmdCopyBufferToImage(getCommandBuffer(), srcBuffer.getHandle(), dstImage.getHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+	totalBytesUploaded += getImageDataSize(dstImage.getFormat(), width, height);
+}
+
+void UploadContext::copyBufferToImage(const Buffer &srcBuffer, const Image &dstImage, const std::vector<VkBufferImageCopy> &regions)
+{
+	vkCmdCopyBufferToImage(getCommandBuffer(), srcBuffer.getHandle(), dstImage.getHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, to_u32(regions.size()), regions.data());
+
+	for (const VkBufferImageCopy &region : regions)
+	{
+		totalBytesUploaded += getImageDataSize(dstImage.getFormat(), region.imageExtent.width, region.imageExtent.height);
+	}
+}
+
+void UploadContext::transitionImageLayout(const Image &image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t baseMipLevel, uint32_t levelCount)
+{
+	VkImageMemoryBarrier barrier{ VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER };
+	barrier.oldLayout = oldLayout;
+	barrier.newLayout = newLayout;
+	barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	barrier.image = image.getHandle();
+	barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+	barrier.subresourceRange.baseMipLevel = baseMipLevel;
+	barrier.subresourceRange.levelCount = levelCount;
+	barrier.subresourceRange.baseArrayLayer = 0;
+	barrier.subresourceRange.layerCount = 1;
+
+	VkPipelineStageFlags sourceStage;
+	VkPipelineStageFlags destinationStage;
+
+	if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL)
+	{
+		barrier.srcAccessMask = 0;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		destinationStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+	}
+	else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+		sourceStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		destinationStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+	else
+	{
+		LOGEANDABORT("unsupported layout transition!");
+	}
+
+	if (transfersOwnership() && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL)
+	{
+		// The image is ready to be sampled so it moves to the destination queue, the release and acquire pair performs the layout transition once
+		transferOwnership(barrier, barrier.dstAccessMask, destinationStage);
+		return;
+	}
+
+	vkCmdPipelineBarrier(
+		getCommandBuffer(),
+		sourceStage, destinationStage,
+		0,
+		0, nullptr,
+		0, nullptr,
+		1, &barrier
+	);
+}
+
+bool UploadContext::canGenerateMipmaps(VkFormat format) const
+{
+	VkFormatProperties properties;
+	vkGetPhysicalDeviceFormatProperties(device.getPhysicalDevice().getHandle(), format, &properties);
+
+	const VkFormatFeatureFlags requiredFeatures{ VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT };
+	return queue.supportsQueueFlags(VK_QUEUE_GRAPHICS_BIT) && (properties.optimalTilingFeatures & requiredFeatures) == requiredFeatures;
+}
+
+void UploadContext::generateMipmaps(const Image &image)
+{
+	if (!queue.supportsQueueFlags(VK_QUEUE_GRAPHICS_BIT))
+	{
+		LOGEANDABORT("Blitting the mip levels requires an upload queue with graphics support");
+	}
+
+	const uint32_t levelCount{ image.getMipLevelCount() };
+	int32_t width{ static_cast<int32_t>(image.getExtent().width) };
+	int32_t height{ static_cast<int32_t>(image.getExtent().height) };
+
+	for (uint32_t level = 1; level < levelCount; ++level)
+	{
+		// The previous level has been written, either by the upload or by the last blit, so it can become the source of this one
+		transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, level - 1, 1);
+
+		int32_t levelWidth{ std::max(width / 2, 1) };
+		int32_t levelHeight{ std::max(height / 2, 1) };
+
+		VkImageBlit blit{};
+		blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.srcSubresource.mipLevel = level - 1;
+		blit.srcSubresource.baseArrayLayer = 0;
+		blit.srcSubresource.layerCount = 1;
+		blit.srcOffsets[1] = { width, height, 1 };
+		blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		blit.dstSubresource.mipLevel = level;
+		blit.dstSubresource.baseArrayLayer = 0;
+		blit.dstSubresource.layerCount = 1;
+		blit.dstOffsets[1] = { levelWidth, levelHeight, 1 };
+
+		vkCmdBlitImage(getCommandBuffer(), image.getHandle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.getHandle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+
+		// Nothing reads the previous level during the mip generation anymore
+		transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, level - 1, 1);
+
+		width = levelWidth;
+		height = levelHeight;
+	}
+
+	// The last level is only ever written to
+	transitionImageLayout(image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, levelCount - 1, 1);
+}
+
+void UploadContext::retainStagingBuffer(std::unique_ptr<Buffer> &&stagingBuffer)
+{
+	// Make sure the staging buffer is tied to the batch that will read from it
+	getCommandBuffer();
+	recordingBatch->stagingBuffers.push_back(std::move(stagingBuffer));
+}
+
+UploadTicket UploadContext::submit()
+{
+	if (!recordingBatch)
+	{
+		return lastSubmittedTicket;
+	}
+
+	recordingBatch->commandBuffer->end();
+	recordingBatch->fence = requestFence();
+	recordingBatch->ticket = ++lastSubmittedTicket;
+
+	VkSubmitInfo submitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &recordingBatch->commandBuffer->getHandle();
+
+	if (!transfersOwnership())
+	{
+		VK_CHECK(vkQueueSubmit(queue.getHandle(), 1, &submitInfo, recordingBatch->fence));
+	}
+	else
+	{
+		recordingBatch->semaphore = requestSemaphore();
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &recordingBatch->semaphore;
+		VK_CHECK(vkQueueSubmit(queue.getHandle(), 1, &submitInfo, VK_NULL_HANDLE));
+
+		// The fence is signalled on the destination queue, so a completed ticket means the resources are owned there. The acquisition is submitted even
+		// without barriers, which means the fence or semaphore signalled by any later submission to the destination queue also covers the upload (and its staging memory)
+		VkSubmitInfo acquireSubmitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO };
+		const VkPipelineStageFlags waitStageMask{ VK_PIPELINE_STAGE_ALL_COMMANDS_BIT };
+		acquireSubmitInfo.waitSemaphoreCount = 1;
+		acquireSubmitInfo.pWaitSemaphores = &recordingBatch->semaphore;
+		acquireSubmitInfo.pWaitDstStageMask = &waitStageMask;
+
+		if (recordingBatch->acquireCommandBuffer)
+		{
+			recordingBatch->acquireCommandBuffer->end();
+			acquireSubmitInfo.commandBufferCount = 1;
+			acquireSubmitInfo.pCommandBuffers = &recordingBatch->acquireCommandBuffer->getHandle();
+		}
+
+		VK_CHECK(vkQueueSubmit(destinationQueue.getHandle(), 1, &acquireSubmitInfo, recordingBatch->fence));
+	}
+
+	pendingBatches.push_back(std::move(recordingBatch));
+
+	return lastSubmittedTicket;
+}
+
+void UploadContext::retireCompleted()
+{
+	while (!pendingBatches.empty() && vkGetFenceStatus(device.getHandle(), pendingBatches.front()->fence) == VK_SUCCESS)
+	{
+		std::unique_ptr<Batch> batch = std::move(pendingBatches.front());
+		pendingBatches.pop_front();
+		retireBatch(std::move(batch));
+	}
+}
+
+bool UploadContext::isComplete(UploadTicket ticket)
+{
+	retireCompleted();
+
+	return ticket <= lastCompletedTicket;
+}
+
+void UploadContext::wait(UploadTicket ticket)
+{
+	if (ticket > lastSubmittedTicket)
+	{
+		LOGEANDABORT("Waiting on an upload ticket that has not been submitted");
+	}
+
+	while (!pendingBatches.empty() && pendingBatches.front()->ticket <= ticket)
+	{
+		std::unique_ptr<Batch> batch = std::move(pendingBatches.front());
+		pendingBatches.pop_front();
+
+		VK_CHECK(vkWaitForFences(device.getHandle(), 1, &batch->fence, VK_TRUE, UINT64_MAX));
+		retireBatch(std::move(batch));
+	}
+}
+
+void UploadContext::flush()
+{
+	wait(submit());
+}
+
+bool UploadContext::transfersOwnership() const
+{
+	return queue.getFamilyIndex() != destinationQueue.getFamilyIndex();
+}
+
+uint64_t UploadContext::getSubmittedBatchCount() const
+{
+	return lastSubmittedTicket;
+}
+
+VkDeviceSize UploadContext::getTotalBytesUploaded() const
+{
+	return totalBytesUploaded;
+}
+
+VkFence UploadContext::requestFence()
+{
+	if (!freeFences.empty())
+	{
+		VkFence fence = freeFences.back();
+		freeFences.pop_back();
+		return fence;
+	}
+
+	VkFence fence{ VK_NULL_HANDLE };
+	VkFenceCreateInfo fenceCreateInfo{ VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
+	VK_CHECK(vkCreateFence(device.getHandle(), &fenceCreateInfo, nullptr, &fence));
+
+	return fence;
+}
+
+VkSemaphore UploadContext::requestSemaphore()
+{
+	if (!freeSemaphores.empty())
+	{
+		VkSemaphore semaphore = freeSemaphores.back();
+		freeSemaphores.pop_back();
+		return semaphore;
+	}
+
+	VkSemaphore semaphore{ VK_NULL_HANDLE };
+	VkSemaphoreCreateInfo semaphoreCreateInfo{ VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
+	VK_CHECK(vkCreateSemaphore(device.getHandle(), &semaphoreCreateInfo, nullptr, &semaphore));
+
+	return semaphore;
+}
+
+void UploadContext::retireBatch(std::unique_ptr<Batch> batch)
+{
+	VK_CHECK(vkResetFences(device.getHandle(), 1, &batch->fence));
+	freeFences.push_back(batch->fence);
+
+	// The acquisition waited on the semaphore before the fence was signalled, so it is unsignalled again
+	if (batch->semaphore != VK_NULL_HANDLE)
+	{
+		freeSemaphores.push_back(batch->semaphore);
+	}
+
+	lastCompletedTicket = batch->ticket;
+
+	// Releasing the batch frees its command buffer and staging buffers
+	batch.reset();
+}
+
+VkCommandBuffer UploadContext::getAcquireCommandBuffer()
+{
+	// The acquire barriers always belong to the batch recording the matching release
+	getCommandBuffer();
+
+	if (!recordingBatch->acquireCommandBuffer)
+	{
+		recordingBatch->acquireCommandBuffer = std::make_unique<CommandBuffer>(*acquireCommandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+		recordingBatch->acquireCommandBuffer->begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr);
+	}
+
+	return recordingBatch->acquireCommandBuffer->getHandle();
+}
+
+void UploadContext::transferOwnership(VkBufferMemoryBarrier barrier, VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask)
+{
+	barrier.srcQueueFamilyIndex = queue.getFamilyIndex();
+	barrier.dstQueueFamilyIndex = destinationQueue.getFamilyIndex();
+
+	// The release only makes the transfer writes available, its destination access is ignored
+	barrier.dstAccessMask = 0;
+	vkCmdPipelineBarrier(getCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+	// The semaphore wait covers every stage of the acquisition, so the acquire barrier only has to block the stages consuming the resource
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = dstAccessMask;
+	vkCmdPipelineBarrier(getAcquireCommandBuffer(), dstStageMask, dstStageMask, 0, 0, nullptr, 1, &barrier, 0, nullptr);
+}
+
+void UploadContext::transferOwnership(VkImageMemoryBarrier barrier, VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask)
+{
+	barrier.srcQueueFamilyIndex = queue.getFamilyIndex();
+	barrier.dstQueueFamilyIndex = destinationQueue.getFamilyIndex();
+
+	barrier.dstAccessMask = 0;
+	vkCmdPipelineBarrier(getCommandBuffer(), VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	barrier.srcAccessMask = 0;
+	barrier.dstAccessMask = dstAccessMask;
+	vkCmdPipelineBarrier(getAcquireCommandBuffer(), dstStageMask, dstStageMask, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+} // namespace vulkr
@@ -0,0 +1,150 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "common/vulkan_common.h"
+
+namespace vulkr
+{
+
+class Device;
+class Queue;
+class CommandPool;
+class CommandBuffer;
+class Buffer;
+class Image;
+
+/* Identifies a submitted upload batch; tickets increase monotonically so a completed ticket implies all earlier ones are complete */
+using UploadTicket = uint64_t;
+
+/*
+ * Records uploads into batches submitted to a queue, with a fence per batch so the caller can poll for completion without stalling
+ * When the upload queue is from a different family than the queue that consumes the resources (a dedicated transfer queue), the ownership of the
+ * uploaded resources is released at the end of each batch and acquired by a small submission to the destination queue that waits on a semaphore
+ * signalled by the upload; the batch only completes once the resources are owned by the destination queue
+ */
+class UploadContext
+{
+public:
+	UploadContext(Device &device, const Queue &queue);
+	UploadContext(Device &device, const Queue &queue, const Queue &destinationQueue);
+	~UploadContext();
+
+	UploadContext(UploadContext &&) = delete;
+	UploadContext(const UploadContext &) = delete;
+	UploadContext &operator=(const UploadContext &) = delete;
+	UploadContext &operator=(UploadContext &&) = delete;
+
+	/* Get the command buffer of the batch currently being recorded, beginning a new batch if required */
+	VkCommandBuffer getCommandBuffer();
+
+	/* Record a copy between two buffers into the current batch; the destination is expected to be read as vertex or index data */
+	void copyBufferToBuffer(const Buffer &srcBuffer, const Buffer &dstBuffer, VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
+
+	/* Record a copy from a buffer into a mip level of an image; the level must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL */
+	void copyBufferToImage(const Buffer &srcBuffer, const Image &dstImage, uint32_t width, uint32_t height, VkDeviceSize srcOffset = 0, uint32_t mipLevel = 0);
+
+	/* Record a copy of several regions from a buffer into an image with a single command, such as every mip level of a texture; the levels must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL */
+	void copyBufferToImage(const Buffer &srcBuffer, const Image &dstImage, const std::vector<VkBufferImageCopy> &regions);
+
+	/* Record an image layout transition of a range of mip levels into the current batch, by default every level of the image */
+	void transitionImageLayout(const Image &image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t baseMipLevel = 0, uint32_t levelCount = VK_REMAINING_MIP_LEVELS);
+
+	/* Whether generateMipmaps supports the format, which requires it to be blittable with linear filtering and the upload queue to support graphics */
+	bool canGenerateMipmaps(VkFormat format) const;
+
+	/**
+	 * Record the generation of the mip chain of an image by blitting every level into the next one
+	 * The first level must hold the image, every level must be in VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL and they all end up in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+	 * The image must have been created with VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+	 */
+	void generateMipmaps(const Image &image);
+
+	/* Keep a staging buffer alive until the batch that reads from it has completed */
+	void retainStagingBuffer(std::unique_ptr<Buffer> &&stagingBuffer);
+
+	/* Submit everything recorded since the last submit with a single vkQueueSubmit (and the ownership acquisition to the destination queue); returns the ticket of the last submitted batch if nothing was recorded */
+	UploadTicket submit();
+
+	/* Poll the fences of pending batches without blocking, releasing the resources of completed ones */
+	void retireCompleted();
+
+	/* Retire the completed batches and check whether the batch identified by the ticket is one of them */
+	bool isComplete(UploadTicket ticket);
+
+	/* Block until the batch identified by the ticket (and every batch before it) has completed */
+	void wait(UploadTicket ticket);
+
+	/* Submit any recorded work and wait for all batches to complete */
+	void flush();
+
+	/* Whether the uploads run on a different queue family than the one consuming them, in which case every batch transfers the ownership of its resources */
+	bool transfersOwnership() const;
+
+	uint64_t getSubmittedBatchCount() const;
+	VkDeviceSize getTotalBytesUploaded() const;
+private:
+	struct Batch
+	{
+		UploadTicket ticket{ 0 };
+		std::unique_ptr<CommandBuffer> commandBuffer{ nullptr };
+		VkFence fence{ VK_NULL_HANDLE };
+		std::vector<std::unique_ptr<Buffer>> stagingBuffers;
+
+		/* Only used when transferring ownership: the acquire barriers recorded for the destination queue and the semaphore handing the batch over */
+		std::unique_ptr<CommandBuffer> acquireCommandBuffer{ nullptr };
+		VkSemaphore semaphore{ VK_NULL_HANDLE };
+	};
+
+	Device &device;
+	const Queue &queue;
+	const Queue &destinationQueue;
+
+	std::unique_ptr<CommandPool> commandPool{ nullptr };
+	std::unique_ptr<CommandPool> acquireCommandPool{ nullptr };
+
+	std::unique_ptr<Batch> recordingBatch{ nullptr };
+	std::deque<std::unique_ptr<Batch>> pendingBatches;
+	std::vector<VkFence> freeFences;
+	std::vector<VkSemaphore> freeSemaphores;
+
+	UploadTicket lastSubmittedTicket{ 0 };
+	UploadTicket lastCompletedTicket{ 0 };
+	VkDeviceSize totalBytesUploaded{ 0 };
+
+	VkFence requestFence();
+	VkSemaphore requestSemaphore();
+	void retireBatch(std::unique_ptr<Batch> batch);
+
+	/* Get the command buffer recording the acquire barriers of the current batch, beginning it if required */
+	VkCommandBuffer getAcquireCommandBuffer();
+
+	/* Record the release of a resource written by transfers on the upload queue, and its acquisition for the given access on the destination queue */
+	void transferOwnership(VkBufferMemoryBarrier barrier, VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask);
+	void transferOwnership(VkImageMemoryBarrier barrier, VkAccessFlags dstAccessMask, VkPipelineStageFlags dstStageMask);
+};
+
+} // namespace vulkr
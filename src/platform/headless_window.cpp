@@ -0,0 +1,60 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "headless_window.h"
+
+namespace vulkr
+{
+
+HeadlessWindow::HeadlessWindow(Platform &platform, uint32_t frameCount) :
+	Window{ platform },
+	frameCount{ frameCount }
+{
+	LOGI("Running headless at {}x{}", WIDTH, HEIGHT);
+}
+
+void HeadlessWindow::createSurface(VkInstance instance)
+{
+	this->instance = instance;
+}
+
+std::vector<const char *> HeadlessWindow::getRequiredSurfaceExtensions() const
+{
+	return {};
+}
+
+bool HeadlessWindow::shouldClose() const
+{
+	return frameCount != 0u && processedFrameCount >= frameCount;
+}
+
+void HeadlessWindow::processEvents()
+{
+	++processedFrameCount;
+}
+
+void HeadlessWindow::updateTitle(std::string title) const
+{
+	LOGI("{} [Frames: {}]", title, processedFrameCount);
+}
+
+} // namespace vulkr
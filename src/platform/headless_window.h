@@ -0,0 +1,62 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "window.h"
+
+namespace vulkr
+{
+
+/* A window with no native surface, used when rendering offscreen on machines without a display */
+class HeadlessWindow : public Window
+{
+public:
+	/* A frameCount of 0 will keep the application running until it is terminated externally */
+	HeadlessWindow(Platform &platform, uint32_t frameCount);
+	~HeadlessWindow() = default;
+
+	HeadlessWindow(const HeadlessWindow &) = delete;
+	HeadlessWindow(HeadlessWindow &&) = delete;
+	HeadlessWindow &operator=(const HeadlessWindow &) = delete;
+	HeadlessWindow &operator=(HeadlessWindow &&) = delete;
+
+	/* No surface is created since nothing will be presented */
+	void createSurface(VkInstance instance) override;
+
+	/* No surface extensions are required */
+	std::vector<const char *> getRequiredSurfaceExtensions() const override;
+
+	/* Checks whether the requested number of frames have been processed */
+	bool shouldClose() const override;
+
+	/* There are no events to poll so we only count the processed frames */
+	void processEvents() override;
+
+	/* Log the title since there is no window to display it on */
+	void updateTitle(std::string title) const override;
+private:
+	uint32_t frameCount{ 0u };
+	uint32_t processedFrameCount{ 0u };
+};
+
+} // namespace vulkr
@@ -21,10 +21,12 @@
  */
 
 #include "platform.h"
+#include "glfw_window.h"
+#include "headless_window.h"
 
 namespace vulkr {
 
-void Platform::initialize(std::unique_ptr<Application> &&application)
+void Platform::initialize(std::unique_ptr<Application> &&application, bool headless, uint32_t headlessFrameCount)
 {
 	if (application == nullptr) {
 		LOGEANDABORT("Application is not valid");
@@ -41,7 +43,15 @@ void Platform::initialize(std::unique_ptr<Application> &&application)
 	spdlog::set_pattern(LOGGER_FORMAT);
 	LOGI("Logger initialized");
 
-	window = std::make_unique<Window>(*this);
+	this->headless = headless;
+	if (headless)
+	{
+		window = std::make_unique<HeadlessWindow>(*this, headlessFrameCount);
+	}
+	else
+	{
+		window = std::make_unique<GlfwWindow>(*this);
+	}
 }
 
 void Platform::prepareApplication() const
@@ -109,4 +119,9 @@ const Window &Platform::getWindow() const
 	return *window;
 }
 
+bool Platform::isHeadless() const
+{
+	return headless;
+}
+
 } // namespace vulkr
\ No newline at end of file
@@ -42,8 +42,12 @@ public:
 	Platform &operator=(const Platform &) = delete;
 	Platform &operator=(Platform &&) = delete;
 
-	/* Initialize the platform by creating the window and logger */
-	void initialize(std::unique_ptr<Application> &&application);
+	/**
+	 * Initialize the platform by creating the window and logger
+	 * @param headless Render offscreen without creating a native window or swapchain
+	 * @param headlessFrameCount The number of frames to render before closing when headless, 0 runs indefinitely
+	 */
+	void initialize(std::unique_ptr<Application> &&application, bool headless = false, uint32_t headlessFrameCount = 0u);
 
 	/* Prepare the application before the main processing loop begins */
 	void prepareApplication() const;
@@ -73,9 +77,13 @@ public:
 	const VkSurfaceKHR getSurface() const;
 
 	const Window &getWindow() const;
+
+	/* Whether the platform is rendering without a native window */
+	bool isHeadless() const;
 private:
 	std::unique_ptr<Window> window{ nullptr };
 	std::unique_ptr<Application> application{ nullptr };
+	bool headless{ false };
 
 	void processApplication() const;
 };
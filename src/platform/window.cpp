@@ -21,188 +21,12 @@
  */
 
 #include "window.h"
-#include "platform.h"
-#include "input_event.h"
-#include "common/helpers.h"
 
 namespace vulkr
 {
 
-namespace
-{
-
-void errorCallback(int error, const char *description)
-{
-	LOGEANDABORT("GLFW error code {} thrown: {}", error, description);
-}
-
-void windowCloseCallback(GLFWwindow *window)
-{
-	glfwSetWindowShouldClose(window, GLFW_TRUE);
-}
-
-void windowSizeCallback(GLFWwindow *window, int width, int height)
-{
-	if (Window *windowClassHandle = reinterpret_cast<Window *>(glfwGetWindowUserPointer(window)))
-	{
-		const Platform &platform = windowClassHandle->getPlatform();
-		platform.handleWindowResize(to_u32(width), to_u32(height));
-	}
-}
-
-void windowFocusCallback(GLFWwindow *window, int focused)
-{
-	if (Window *windowClassHandle = reinterpret_cast<Window *>(glfwGetWindowUserPointer(window)))
-	{
-		const Platform &platform = windowClassHandle->getPlatform();
-		platform.handleFocusChange(focused ? true : false);
-	}
-}
-
-void keyCallback(GLFWwindow *window, int key, int /*scancode*/, int action, int /*mods*/)
-{
-	KeyInput keyInput = KeyInput::Unknown;
-	KeyAction keyAction = KeyAction::Unknown;
-
-	auto keyInputIt = keyInputMap.find(key);
-	if (keyInputIt != keyInputMap.end())
-	{
-		keyInput = keyInputIt->second;
-	}
-
-	auto keyActionIt = keyActionMap.find(action);
-	if (keyActionIt != keyActionMap.end())
-	{
-		keyAction = keyActionIt->second;
-	}
-
-	if (Window *windowClassHandle = reinterpret_cast<Window *>(glfwGetWindowUserPointer(window)))
-	{
-		const Platform &platform = windowClassHandle->getPlatform();
-		platform.handleInputEvents(KeyInputEvent{ keyInput, keyAction });
-	}
-}
-
-void cursorPositionCallback(GLFWwindow *window, double xPos, double yPos)
-{
-	if (Window *windowClassHandle = reinterpret_cast<Window *>(glfwGetWindowUserPointer(window)))
-	{
-		const Platform &platform = windowClassHandle->getPlatform();
-		platform.handleInputEvents(MouseInputEvent{
-			MouseInput::None,
-			MouseAction::Move,
-			xPos,
-			yPos
-		});
-	}
-}
-
-void mouseButtonCallback(GLFWwindow *window, int button, int action, int /*mods*/)
-{
-	MouseInput mouseInput = MouseInput::None;
-	MouseAction mouseAction = MouseAction::Unknown;
-
-	auto mouseInputIt = mouseInputMap.find(button);
-	if (mouseInputIt != mouseInputMap.end())
-	{
-		mouseInput = mouseInputIt->second;
-	}
-
-	auto mouseActionIt = mouseActionMap.find(action);
-	if (mouseActionIt != mouseActionMap.end())
-	{
-		mouseAction = mouseActionIt->second;
-	}
-
-	if (Window *windowClassHandle = reinterpret_cast<Window*>(glfwGetWindowUserPointer(window)))
-	{
-		const Platform &platform = windowClassHandle->getPlatform();
-		double xPos, yPos;
-		glfwGetCursorPos(window, &xPos, &yPos);
-
-		platform.handleInputEvents(MouseInputEvent{
-			mouseInput,
-			mouseAction,
-			xPos,
-			yPos
-		});
-	}
-}
-
-void scrollCallback(GLFWwindow *window, double xoffset, double yoffset)
-{
-	if (Window *windowClassHandle = reinterpret_cast<Window *>(glfwGetWindowUserPointer(window)))
-	{
-		MouseInput mouseInput = MouseInput::Middle;
-		MouseAction mouseAction = MouseAction::Scroll;
-		const Platform &platform = windowClassHandle->getPlatform();
-
-		platform.handleInputEvents(MouseInputEvent{
-			mouseInput,
-			mouseAction,
-			xoffset,
-			yoffset
-		});
-	}
-}
-
-} // namespace
-
-
 Window::Window(Platform &platform) : platform{ platform }
-{
-	if (!glfwInit())
-	{
-		LOGEANDABORT("GLFW failed to initialize");
-	}
-
-	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-
-	handle = glfwCreateWindow(WIDTH, HEIGHT, "Vulkr", nullptr, nullptr);
-	if (handle == VK_NULL_HANDLE) {
-		LOGEANDABORT("glfwCreateWindow has failed to create a window");
-	}
-
-	// Expose the window class to glfw
-	glfwSetWindowUserPointer(handle, this);
-
-	/* Direct window interation callbacks */
-	glfwSetErrorCallback(errorCallback);
-	glfwSetWindowCloseCallback(handle, windowCloseCallback);
-	glfwSetWindowSizeCallback(handle, windowSizeCallback);
-	glfwSetWindowFocusCallback(handle, windowFocusCallback);
-
-	/* Window input callbacks */
-	glfwSetKeyCallback(handle, keyCallback);
-	glfwSetCursorPosCallback(handle, cursorPositionCallback);
-	glfwSetMouseButtonCallback(handle, mouseButtonCallback);
-	glfwSetScrollCallback(handle, scrollCallback);
-
-	/* Prevent inputs from being lost if actions happen between pollEvent calls */
-	glfwSetInputMode(handle, GLFW_STICKY_KEYS, 1);
-	glfwSetInputMode(handle, GLFW_STICKY_MOUSE_BUTTONS, 1);
-}
-
-Window::~Window()
-{
-	glfwDestroyWindow(handle);
-	glfwTerminate();
-}
-
-void Window::createSurface(VkInstance instance)
-{
-	if (surface != VK_NULL_HANDLE) {
-		LOGEANDABORT("createSurface was called more than once")
-	}
-	this->instance = instance;
-
-	VK_CHECK(glfwCreateWindowSurface(instance, handle, nullptr, &surface));
-}
-
-GLFWwindow *Window::getHandle() const
-{
-	return handle;
-}
+{}
 
 VkSurfaceKHR Window::getSurfaceHandle() const
 {
@@ -220,19 +44,4 @@ VkExtent2D Window::getWindowExtent()
 	return extent;
 }
 
-bool Window::shouldClose() const
-{
-	return glfwWindowShouldClose(handle);
-}
-
-void Window::processEvents() const
-{
-	glfwPollEvents();
-}
-
-void Window::updateTitle(std::string title) const
-{
-	glfwSetWindowTitle(handle, title.c_str());
-}
-
-} // namespace vulkr
\ No newline at end of file
+} // namespace vulkr
@@ -24,17 +24,17 @@
 
 #include "common/vulkan_common.h"
 
-#include <GLFW/glfw3.h>
 namespace vulkr
 {
 
 class Platform;
 
+/* The base window class, derived classes decide whether we present to a native window or render without one */
 class Window
 {
 public:
 	Window(Platform &platform);
-	~Window();
+	virtual ~Window() = default;
 
 	Window(const Window &) = delete;
 	Window(Window &&) = delete;
@@ -42,24 +42,25 @@ public:
 	Window &operator=(Window &&) = delete;
 
 	/* Create the window surface */
-	void createSurface(VkInstance instance);
+	virtual void createSurface(VkInstance instance) = 0;
 
-	/* Getters */
-	GLFWwindow *getHandle() const;
-	VkSurfaceKHR getSurfaceHandle() const;
-	Platform &getPlatform() const;
-	static VkExtent2D getWindowExtent();
+	/* Get the instance extensions required to create a surface for this window */
+	virtual std::vector<const char *> getRequiredSurfaceExtensions() const = 0;
 
 	/* Checks whether the window should close */
-	bool shouldClose() const;
+	virtual bool shouldClose() const = 0;
 
 	/* Poll for any input events */
-	void processEvents() const;
+	virtual void processEvents() = 0;
 
 	/* Update the title of the window */
-	void updateTitle(std::string title) const;
-private:
-	GLFWwindow *handle;
+	virtual void updateTitle(std::string title) const = 0;
+
+	/* Getters */
+	VkSurfaceKHR getSurfaceHandle() const;
+	Platform &getPlatform() const;
+	static VkExtent2D getWindowExtent();
+protected:
 	VkSurfaceKHR surface{ VK_NULL_HANDLE };
 	VkInstance instance{ VK_NULL_HANDLE };
 	Platform &platform;
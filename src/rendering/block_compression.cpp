@@ -0,0 +1,608 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "block_compression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+#include <vector>
+
+namespace vulkr
+{
+
+namespace
+{
+
+constexpr uint32_t blockTexelCount{ 16 };
+
+// The interpolation weights of the 4 bit indices of BC7, out of 64
+constexpr std::array<uint32_t, 16> bc7Weights{ 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// The texels of a block as RGBA in [0, 255]
+using Block = std::array<std::array<float, 4>, blockTexelCount>;
+using Color = std::array<float, 4>;
+
+void loadBlock(const uint8_t *pixels, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block &block)
+{
+	for (uint32_t y = 0; y < 4; ++y)
+	{
+		const uint32_t pixelY{ std::min(blockY * 4 + y, height - 1) };
+		for (uint32_t x = 0; x < 4; ++x)
+		{
+			const uint32_t pixelX{ std::min(blockX * 4 + x, width - 1) };
+			const uint8_t *pixel = pixels + (static_cast<size_t>(pixelY) * width + pixelX) * 4;
+			for (uint32_t channel = 0; channel < 4; ++channel)
+			{
+				block[y * 4 + x][channel] = static_cast<float>(pixel[channel]);
+			}
+		}
+	}
+}
+
+float getSquaredError(const Color &a, const Color &b, uint32_t channelCount)
+{
+	float error{ 0.0f };
+	for (uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		float difference = a[channel] - b[channel];
+		error += difference * difference;
+	}
+	return error;
+}
+
+/*
+ * Finds the two ends of the line that fits the texels best, the principal axis of their covariance found by power iteration,
+ * clipped to the range the texels project onto and inset slightly since the extremes are rarely hit exactly after quantization
+ */
+void findEndpoints(const Block &block, uint32_t channelCount, Color &endpoint0, Color &endpoint1)
+{
+	Color mean{};
+	Color minimum{ 255.0f, 255.0f, 255.0f, 255.0f };
+	Color maximum{};
+	for (const Color &texel : block)
+	{
+		for (uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			mean[channel] += texel[channel] / blockTexelCount;
+			minimum[channel] = std::min(minimum[channel], texel[channel]);
+			maximum[channel] = std::max(maximum[channel], texel[channel]);
+		}
+	}
+
+	float covariance[4][4]{};
+	for (const Color &texel : block)
+	{
+		for (uint32_t i = 0; i < channelCount; ++i)
+		{
+			for (uint32_t j = 0; j < channelCount; ++j)
+			{
+				covariance[i][j] += (texel[i] - mean[i]) * (texel[j] - mean[j]);
+			}
+		}
+	}
+
+	Color axis{};
+	for (uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		axis[channel] = maximum[channel] - minimum[channel];
+	}
+	for (uint32_t iteration = 0; iteration < 8; ++iteration)
+	{
+		Color next{};
+		float length{ 0.0f };
+		for (uint32_t i = 0; i < channelCount; ++i)
+		{
+			for (uint32_t j = 0; j < channelCount; ++j)
+			{
+				next[i] += covariance[i][j] * axis[j];
+			}
+			length = std::max(length, std::abs(next[i]));
+		}
+
+		if (length == 0.0f)
+		{
+			break;
+		}
+		for (uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			axis[channel] = next[channel] / length;
+		}
+	}
+
+	float axisLengthSquared{ 0.0f };
+	for (uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		axisLengthSquared += axis[channel] * axis[channel];
+	}
+
+	if (axisLengthSquared == 0.0f)
+	{
+		// Every texel has the same colour
+		endpoint0 = mean;
+		endpoint1 = mean;
+		return;
+	}
+
+	float minimumProjection{ std::numeric_limits<float>::max() };
+	float maximumProjection{ std::numeric_limits<float>::lowest() };
+	for (const Color &texel : block)
+	{
+		float projection{ 0.0f };
+		for (uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			projection += (texel[channel] - mean[channel]) * axis[channel];
+		}
+		minimumProjection = std::min(minimumProjection, projection / axisLengthSquared);
+		maximumProjection = std::max(maximumProjection, projection / axisLengthSquared);
+	}
+
+	const float inset{ (maximumProjection - minimumProjection) / 32.0f };
+	minimumProjection += inset;
+	maximumProjection -= inset;
+
+	for (uint32_t channel = 0; channel < 4; ++channel)
+	{
+		endpoint0[channel] = std::clamp(mean[channel] + axis[channel] * minimumProjection, 0.0f, 255.0f);
+		endpoint1[channel] = std::clamp(mean[channel] + axis[channel] * maximumProjection, 0.0f, 255.0f);
+	}
+}
+
+/*
+ * Solves for the endpoints that minimize the squared error of the texels, given how far along the line each texel was placed
+ * @return False if every texel was placed at the same weight, in which case the line can't be solved for
+ */
+bool solveEndpoints(const Block &block, uint32_t channelCount, const std::array<float, blockTexelCount> &weights, Color &endpoint0, Color &endpoint1)
+{
+	float a{ 0.0f }, b{ 0.0f }, c{ 0.0f };
+	Color x{}, y{};
+	for (uint32_t i = 0; i < blockTexelCount; ++i)
+	{
+		const float weight0{ 1.0f - weights[i] };
+		const float weight1{ weights[i] };
+		a += weight0 * weight0;
+		b += weight0 * weight1;
+		c += weight1 * weight1;
+		for (uint32_t channel = 0; channel < channelCount; ++channel)
+		{
+			x[channel] += weight0 * block[i][channel];
+			y[channel] += weight1 * block[i][channel];
+		}
+	}
+
+	const float determinant{ a * c - b * b };
+	if (std::abs(determinant) < 1e-6f)
+	{
+		return false;
+	}
+
+	for (uint32_t channel = 0; channel < channelCount; ++channel)
+	{
+		endpoint0[channel] = std::clamp((c * x[channel] - b * y[channel]) / determinant, 0.0f, 255.0f);
+		endpoint1[channel] = std::clamp((a * y[channel] - b * x[channel]) / determinant, 0.0f, 255.0f);
+	}
+	return true;
+}
+
+uint16_t packRgb565(const Color &color)
+{
+	const uint32_t r{ static_cast<uint32_t>(std::lround(color[0] * 31.0f / 255.0f)) };
+	const uint32_t g{ static_cast<uint32_t>(std::lround(color[1] * 63.0f / 255.0f)) };
+	const uint32_t b{ static_cast<uint32_t>(std::lround(color[2] * 31.0f / 255.0f)) };
+	return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+Color unpackRgb565(uint16_t packed)
+{
+	const uint32_t r{ (packed >> 11) & 31u };
+	const uint32_t g{ (packed >> 5) & 63u };
+	const uint32_t b{ packed & 31u };
+	return Color{ static_cast<float>((r << 3) | (r >> 2)), static_cast<float>((g << 2) | (g >> 4)), static_cast<float>((b << 3) | (b >> 2)), 255.0f };
+}
+
+/* Encodes the colour of a block in the four colour mode of BC1, which is also the colour block of BC3 */
+void encodeBc1ColorBlock(const Block &block, uint8_t *dest)
+{
+	// The weight of the second endpoint for each index of the four colour mode
+	constexpr std::array<float, 4> indexWeights{ 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+
+	Color endpoint0, endpoint1;
+	findEndpoints(block, 3, endpoint0, endpoint1);
+
+	uint16_t bestColor0{ 0 }, bestColor1{ 0 };
+	uint32_t bestIndices{ 0 };
+	float bestError{ std::numeric_limits<float>::max() };
+
+	for (uint32_t iteration = 0; iteration < 3; ++iteration)
+	{
+		const uint16_t color0{ packRgb565(endpoint0) };
+		const uint16_t color1{ packRgb565(endpoint1) };
+		const Color quantized0{ unpackRgb565(color0) };
+		const Color quantized1{ unpackRgb565(color1) };
+
+		std::array<Color, 4> palette;
+		for (uint32_t index = 0; index < 4; ++index)
+		{
+			for (uint32_t channel = 0; channel < 3; ++channel)
+			{
+				palette[index][channel] = quantized0[channel] + (quantized1[channel] - quantized0[channel]) * indexWeights[index];
+			}
+		}
+
+		uint32_t indices{ 0 };
+		float error{ 0.0f };
+		std::array<float, blockTexelCount> weights;
+		for (uint32_t i = 0; i < blockTexelCount; ++i)
+		{
+			uint32_t bestIndex{ 0 };
+			float bestTexelError{ std::numeric_limits<float>::max() };
+			for (uint32_t index = 0; index < 4; ++index)
+			{
+				float texelError = getSquaredError(block[i], palette[index], 3);
+				if (texelError < bestTexelError)
+				{
+					bestTexelError = texelError;
+					bestIndex = index;
+				}
+			}
+			indices |= bestIndex << (i * 2);
+			error += bestTexelError;
+			weights[i] = indexWeights[bestIndex];
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			bestColor0 = color0;
+			bestColor1 = color1;
+			bestIndices = indices;
+		}
+
+		if (error == 0.0f || !solveEndpoints(block, 3, weights, endpoint0, endpoint1))
+		{
+			break;
+		}
+	}
+
+	// A BC1 block is only decoded in the four colour mode if the first endpoint is the larger one
+	if (bestColor0 < bestColor1)
+	{
+		std::swap(bestColor0, bestColor1);
+		bestIndices ^= 0x55555555u;
+	}
+	else if (bestColor0 == bestColor1)
+	{
+		bestIndices = 0;
+	}
+
+	dest[0] = static_cast<uint8_t>(bestColor0 & 0xFF);
+	dest[1] = static_cast<uint8_t>(bestColor0 >> 8);
+	dest[2] = static_cast<uint8_t>(bestColor1 & 0xFF);
+	dest[3] = static_cast<uint8_t>(bestColor1 >> 8);
+	for (uint32_t i = 0; i < 4; ++i)
+	{
+		dest[4 + i] = static_cast<uint8_t>(bestIndices >> (i * 8));
+	}
+}
+
+/* Picks the best index of an alpha palette for every texel, returning the total squared error */
+float fitAlphaIndices(const Block &block, const std::array<float, 8> &palette, uint64_t &indices)
+{
+	indices = 0;
+	float error{ 0.0f };
+	for (uint32_t i = 0; i < blockTexelCount; ++i)
+	{
+		uint64_t bestIndex{ 0 };
+		float bestTexelError{ std::numeric_limits<float>::max() };
+		for (uint32_t index = 0; index < 8; ++index)
+		{
+			float difference = block[i][3] - palette[index];
+			if (difference * difference < bestTexelError)
+			{
+				bestTexelError = difference * difference;
+				bestIndex = index;
+			}
+		}
+		indices |= bestIndex << (i * 3);
+		error += bestTexelError;
+	}
+	return error;
+}
+
+/*
+ * Encodes the alpha of a block for BC3, trying both the eight value mode that interpolates between the extremes,
+ * and the six value mode with explicit 0 and 255, which keeps alpha tested cutouts exact
+ */
+void encodeBc3AlphaBlock(const Block &block, uint8_t *dest)
+{
+	uint32_t minimum{ 255 }, maximum{ 0 };
+	uint32_t innerMinimum{ 255 }, innerMaximum{ 0 };
+	for (const Color &texel : block)
+	{
+		const uint32_t alpha{ static_cast<uint32_t>(texel[3]) };
+		minimum = std::min(minimum, alpha);
+		maximum = std::max(maximum, alpha);
+		if (alpha != 0 && alpha != 255)
+		{
+			innerMinimum = std::min(innerMinimum, alpha);
+			innerMaximum = std::max(innerMaximum, alpha);
+		}
+	}
+
+	uint32_t bestAlpha0{ maximum }, bestAlpha1{ maximum };
+	uint64_t bestIndices{ 0 };
+	float bestError{ std::numeric_limits<float>::max() };
+
+	if (maximum > minimum)
+	{
+		// Eight value mode, selected by the first endpoint being the larger one
+		std::array<float, 8> palette;
+		palette[0] = static_cast<float>(maximum);
+		palette[1] = static_cast<float>(minimum);
+		for (uint32_t index = 2; index < 8; ++index)
+		{
+			palette[index] = (static_cast<float>(8 - index) * maximum + static_cast<float>(index - 1) * minimum) / 7.0f;
+		}
+
+		bestError = fitAlphaIndices(block, palette, bestIndices);
+		bestAlpha0 = maximum;
+		bestAlpha1 = minimum;
+	}
+
+	if (innerMinimum > innerMaximum)
+	{
+		// Only 0 and 255 appear, which the six value mode represents exactly
+		innerMinimum = innerMaximum = 255;
+	}
+
+	{
+		std::array<float, 8> palette;
+		palette[0] = static_cast<float>(innerMinimum);
+		palette[1] = static_cast<float>(innerMaximum);
+		for (uint32_t index = 2; index < 6; ++index)
+		{
+			palette[index] = (static_cast<float>(6 - index) * innerMinimum + static_cast<float>(index - 1) * innerMaximum) / 5.0f;
+		}
+		palette[6] = 0.0f;
+		palette[7] = 255.0f;
+
+		uint64_t indices;
+		float error = fitAlphaIndices(block, palette, indices);
+		if (error < bestError)
+		{
+			bestError = error;
+			bestAlpha0 = innerMinimum;
+			bestAlpha1 = innerMaximum;
+			bestIndices = indices;
+		}
+	}
+
+	dest[0] = static_cast<uint8_t>(bestAlpha0);
+	dest[1] = static_cast<uint8_t>(bestAlpha1);
+	for (uint32_t i = 0; i < 6; ++i)
+	{
+		dest[2 + i] = static_cast<uint8_t>(bestIndices >> (i * 8));
+	}
+}
+
+/* Quantizes an endpoint to the 7 bits per channel and shared lowest bit of BC7 mode 6, picking the lowest bit that fits best */
+void quantizeBc7Endpoint(const Color &endpoint, std::array<uint32_t, 4> &quantized, uint32_t &pBit, Color &reconstructed)
+{
+	float bestError{ std::numeric_limits<float>::max() };
+	for (uint32_t candidatePBit = 0; candidatePBit < 2; ++candidatePBit)
+	{
+		std::array<uint32_t, 4> candidate;
+		Color candidateColor;
+		for (uint32_t channel = 0; channel < 4; ++channel)
+		{
+			long value = std::lround((endpoint[channel] - static_cast<float>(candidatePBit)) / 2.0f);
+			candidate[channel] = static_cast<uint32_t>(std::clamp(value, 0l, 127l));
+			candidateColor[channel] = static_cast<float>((candidate[channel] << 1) | candidatePBit);
+		}
+
+		float error = getSquaredError(endpoint, candidateColor, 4);
+		if (error < bestError)
+		{
+			bestError = error;
+			quantized = candidate;
+			pBit = candidatePBit;
+			reconstructed = candidateColor;
+		}
+	}
+}
+
+void writeBits(uint8_t *dest, uint32_t &bitOffset, uint32_t value, uint32_t bitCount)
+{
+	for (uint32_t bit = 0; bit < bitCount; ++bit, ++bitOffset)
+	{
+		if ((value >> bit) & 1u)
+		{
+			dest[bitOffset / 8] |= static_cast<uint8_t>(1u << (bitOffset % 8));
+		}
+	}
+}
+
+void encodeBc7Block(const Block &block, uint8_t *dest)
+{
+	Color endpoint0, endpoint1;
+	findEndpoints(block, 4, endpoint0, endpoint1);
+
+	std::array<uint32_t, 4> bestQuantized0{}, bestQuantized1{};
+	uint32_t bestPBit0{ 0 }, bestPBit1{ 0 };
+	std::array<uint32_t, blockTexelCount> bestIndices{};
+	float bestError{ std::numeric_limits<float>::max() };
+
+	for (uint32_t iteration = 0; iteration < 3; ++iteration)
+	{
+		std::array<uint32_t, 4> quantized0, quantized1;
+		uint32_t pBit0, pBit1;
+		Color reconstructed0, reconstructed1;
+		quantizeBc7Endpoint(endpoint0, quantized0, pBit0, reconstructed0);
+		quantizeBc7Endpoint(endpoint1, quantized1, pBit1, reconstructed1);
+
+		std::array<Color, 16> palette;
+		for (uint32_t index = 0; index < 16; ++index)
+		{
+			for (uint32_t channel = 0; channel < 4; ++channel)
+			{
+				const uint32_t value0{ static_cast<uint32_t>(reconstructed0[channel]) };
+				const uint32_t value1{ static_cast<uint32_t>(reconstructed1[channel]) };
+				palette[index][channel] = static_cast<float>(((64 - bc7Weights[index]) * value0 + bc7Weights[index] * value1 + 32) >> 6);
+			}
+		}
+
+		std::array<uint32_t, blockTexelCount> indices;
+		std::array<float, blockTexelCount> weights;
+		float error{ 0.0f };
+		for (uint32_t i = 0; i < blockTexelCount; ++i)
+		{
+			float bestTexelError{ std::numeric_limits<float>::max() };
+			for (uint32_t index = 0; index < 16; ++index)
+			{
+				float texelError = getSquaredError(block[i], palette[index], 4);
+				if (texelError < bestTexelError)
+				{
+					bestTexelError = texelError;
+					indices[i] = index;
+				}
+			}
+			error += bestTexelError;
+			weights[i] = static_cast<float>(bc7Weights[indices[i]]) / 64.0f;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			bestQuantized0 = quantized0;
+			bestQuantized1 = quantized1;
+			bestPBit0 = pBit0;
+			bestPBit1 = pBit1;
+			bestIndices = indices;
+		}
+
+		if (error == 0.0f || !solveEndpoints(block, 4, weights, endpoint0, endpoint1))
+		{
+			break;
+		}
+	}
+
+	// The highest bit of the first index is implicitly zero, so flip the line if the first texel sits in its upper half
+	if (bestIndices[0] >= 8)
+	{
+		std::swap(bestQuantized0, bestQuantized1);
+		std::swap(bestPBit0, bestPBit1);
+		for (uint32_t &index : bestIndices)
+		{
+			index = 15 - index;
+		}
+	}
+
+	memset(dest, 0, 16);
+	uint32_t bitOffset{ 0 };
+	writeBits(dest, bitOffset, 1u << 6, 7);
+	for (uint32_t channel = 0; channel < 4; ++channel)
+	{
+		writeBits(dest, bitOffset, bestQuantized0[channel], 7);
+		writeBits(dest, bitOffset, bestQuantized1[channel], 7);
+	}
+	writeBits(dest, bitOffset, bestPBit0, 1);
+	writeBits(dest, bitOffset, bestPBit1, 1);
+	for (uint32_t i = 0; i < blockTexelCount; ++i)
+	{
+		writeBits(dest, bitOffset, bestIndices[i], i == 0 ? 3 : 4);
+	}
+}
+
+void encodeBlock(BlockCompression compression, const Block &block, uint8_t *dest)
+{
+	switch (compression)
+	{
+	case BlockCompression::BC1:
+		encodeBc1ColorBlock(block, dest);
+		break;
+	case BlockCompression::BC3:
+		encodeBc3AlphaBlock(block, dest);
+		encodeBc1ColorBlock(block, dest + 8);
+		break;
+	case BlockCompression::BC7:
+		encodeBc7Block(block, dest);
+		break;
+	}
+}
+
+} // namespace
+
+uint32_t getCompressedBlockSize(BlockCompression compression)
+{
+	return compression == BlockCompression::BC1 ? 8u : 16u;
+}
+
+size_t getCompressedImageSize(BlockCompression compression, uint32_t width, uint32_t height)
+{
+	const size_t blockCountX{ (width + 3u) / 4u };
+	const size_t blockCountY{ (height + 3u) / 4u };
+	return blockCountX * blockCountY * getCompressedBlockSize(compression);
+}
+
+void compressImage(BlockCompression compression, const uint8_t *pixels, uint32_t width, uint32_t height, uint8_t *dest, uint32_t threadCount)
+{
+	const uint32_t blockCountX{ (width + 3u) / 4u };
+	const uint32_t blockCountY{ (height + 3u) / 4u };
+	const uint32_t blockSize{ getCompressedBlockSize(compression) };
+
+	auto compressRows = [&](uint32_t firstRow, uint32_t lastRow)
+	{
+		Block block;
+		for (uint32_t blockY = firstRow; blockY < lastRow; ++blockY)
+		{
+			for (uint32_t blockX = 0; blockX < blockCountX; ++blockX)
+			{
+				loadBlock(pixels, width, height, blockX, blockY, block);
+				encodeBlock(compression, block, dest + (static_cast<size_t>(blockY) * blockCountX + blockX) * blockSize);
+			}
+		}
+	};
+
+	if (threadCount == 0u)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	threadCount = std::min(threadCount, blockCountY);
+
+	// The calling thread compresses the first range of rows while the workers handle the rest
+	std::vector<std::thread> workers;
+	workers.reserve(threadCount - 1);
+	for (uint32_t i = 1; i < threadCount; ++i)
+	{
+		workers.emplace_back(compressRows, blockCountY * i / threadCount, blockCountY * (i + 1) / threadCount);
+	}
+	compressRows(0, blockCountY / threadCount);
+	for (std::thread &worker : workers)
+	{
+		worker.join();
+	}
+}
+
+} // namespace vulkr
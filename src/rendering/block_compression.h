@@ -0,0 +1,53 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vulkr
+{
+
+/* The block compressed formats compressImage can encode, every one of them stores blocks of 4x4 texels */
+enum class BlockCompression
+{
+	BC1, // RGB at 4 bits per texel, for images without alpha
+	BC3, // RGBA at 8 bits per texel, the alpha is stored separately from a BC1 colour block
+	BC7  // RGBA at 8 bits per texel with more precision than BC3, only mode 6 (a single RGBA line per block) is encoded
+};
+
+/* Size in bytes of a single compressed block */
+uint32_t getCompressedBlockSize(BlockCompression compression);
+
+/* Size in bytes of a compressed image, edges that aren't a multiple of 4 texels are rounded up to a whole block */
+size_t getCompressedImageSize(BlockCompression compression, uint32_t width, uint32_t height);
+
+/**
+ * Compresses an RGBA8 image, splitting the rows of blocks across threads
+ * Blocks that overlap the right or bottom edge are padded by repeating the last column and row of the image
+ * @param dest Receives getCompressedImageSize bytes with the blocks stored in row major order
+ * @param threadCount The number of threads to encode with, 0 uses every hardware thread
+ */
+void compressImage(BlockCompression compression, const uint8_t *pixels, uint32_t width, uint32_t height, uint8_t *dest, uint32_t threadCount = 0);
+
+} // namespace vulkr
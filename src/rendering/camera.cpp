@@ -102,6 +102,12 @@ void Camera::setAspect(float aspect)
 	updatePerspectiveProjection();
 }
 
+void Camera::setViewport(int32_t viewportWidth, int32_t viewportHeight)
+{
+	viewport = glm::vec2(viewportWidth, viewportHeight);
+	setAspect(viewportWidth / static_cast<float>(viewportHeight));
+}
+
 void Camera::setPosition(glm::vec3 position)
 {
 	this->position = position;
@@ -62,6 +62,7 @@ public:
 	/* Setters */
 	void setFovY(float fovy);
 	void setAspect(float aspect);
+	void setViewport(int32_t viewportWidth, int32_t viewportHeight);
 	void setPosition(glm::vec3 position);
 	void setCenter(glm::vec3 center);
 	void setUp(glm::vec3 up);
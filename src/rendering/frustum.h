@@ -0,0 +1,44 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <glm/glm.hpp>
+
+namespace vulkr
+{
+
+/* The six planes bounding what a camera sees, every plane is (normal, distance) with the normal pointing inside */
+struct Frustum
+{
+	std::array<glm::vec4, 6> planes; // Left, right, bottom, top, near, far
+
+	/* Extract the planes from a projection * view matrix with a [0, 1] depth range, see "Fast Extraction of Viewing Frustum Planes from the World-View-Projection Matrix" (Gribb and Hartmann) */
+	static Frustum fromViewProjection(const glm::mat4 &viewProjection);
+
+	/* Whether an axis aligned box is at least partly inside, boxes near a corner of the frustum may be reported inside while they aren't */
+	bool intersects(const glm::vec3 &boundsMin, const glm::vec3 &boundsMax) const;
+};
+
+} // namespace vulkr
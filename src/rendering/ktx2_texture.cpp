@@ -0,0 +1,357 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "ktx2_texture.h"
+#include "common/mapped_file.h"
+#include "common/logger.h"
+#include "common/helpers.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace vulkr
+{
+
+namespace
+{
+
+constexpr uint8_t ktx2Identifier[12]{ 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A }; // "«KTX 20»\r\n\x1A\n"
+
+// Values from the Khronos Data Format Specification used by the data format descriptor
+constexpr uint16_t dfdVersionNumber{ 2 }; // KHR_DF_VERSIONNUMBER_1_3
+constexpr uint8_t dfdModelBc1a{ 128 };
+constexpr uint8_t dfdModelBc3{ 130 };
+constexpr uint8_t dfdModelBc7{ 134 };
+constexpr uint8_t dfdChannelColor{ 0 };
+constexpr uint8_t dfdChannelBc3Alpha{ 15 };
+constexpr uint8_t dfdPrimariesBt709{ 1 };
+constexpr uint8_t dfdTransferLinear{ 1 };
+constexpr uint8_t dfdTransferSrgb{ 2 };
+
+/* Layout of the file from the identifier up to the level index, every field is little endian */
+struct Ktx2Header
+{
+	uint8_t identifier[12];
+	uint32_t vkFormat;
+	uint32_t typeSize;
+	uint32_t pixelWidth;
+	uint32_t pixelHeight;
+	uint32_t pixelDepth;
+	uint32_t layerCount;
+	uint32_t faceCount;
+	uint32_t levelCount;
+	uint32_t supercompressionScheme;
+	uint32_t dfdByteOffset;
+	uint32_t dfdByteLength;
+	uint32_t kvdByteOffset;
+	uint32_t kvdByteLength;
+	uint64_t sgdByteOffset;
+	uint64_t sgdByteLength;
+};
+
+struct Ktx2LevelIndex
+{
+	uint64_t byteOffset;
+	uint64_t byteLength;
+	uint64_t uncompressedByteLength;
+};
+
+/* A sample of the basic data format descriptor block, describing which bits of a block hold which channel */
+struct DfdSample
+{
+	uint16_t bitOffset;
+	uint8_t bitLength; // Number of bits minus one
+	uint8_t channelType;
+	uint8_t samplePosition[4];
+	uint32_t sampleLower;
+	uint32_t sampleUpper;
+};
+
+struct FormatInfo
+{
+	VkFormat format;
+	uint32_t blockSize;
+	uint8_t colorModel;
+	uint8_t transferFunction;
+};
+
+constexpr FormatInfo supportedFormats[]{
+	{ VK_FORMAT_BC1_RGB_UNORM_BLOCK, 8, dfdModelBc1a, dfdTransferLinear },
+	{ VK_FORMAT_BC1_RGB_SRGB_BLOCK, 8, dfdModelBc1a, dfdTransferSrgb },
+	{ VK_FORMAT_BC3_UNORM_BLOCK, 16, dfdModelBc3, dfdTransferLinear },
+	{ VK_FORMAT_BC3_SRGB_BLOCK, 16, dfdModelBc3, dfdTransferSrgb },
+	{ VK_FORMAT_BC7_UNORM_BLOCK, 16, dfdModelBc7, dfdTransferLinear },
+	{ VK_FORMAT_BC7_SRGB_BLOCK, 16, dfdModelBc7, dfdTransferSrgb }
+};
+
+static_assert(sizeof(Ktx2Header) == 80, "The KTX2 header is written and read as raw bytes");
+static_assert(sizeof(Ktx2LevelIndex) == 24, "The KTX2 level index is written and read as raw bytes");
+static_assert(sizeof(DfdSample) == 16, "The data format descriptor samples are written as raw bytes");
+
+const FormatInfo *findFormatInfo(VkFormat format)
+{
+	for (const FormatInfo &info : supportedFormats)
+	{
+		if (info.format == format)
+		{
+			return &info;
+		}
+	}
+	return nullptr;
+}
+
+uint64_t getLevelSize(const FormatInfo &info, uint32_t width, uint32_t height, uint32_t level)
+{
+	const uint64_t levelWidth{ std::max(width >> level, 1u) };
+	const uint64_t levelHeight{ std::max(height >> level, 1u) };
+	return ((levelWidth + 3u) / 4u) * ((levelHeight + 3u) / 4u) * info.blockSize;
+}
+
+/* Builds the data format descriptor of a block compressed format, a single basic descriptor block preceded by its total size */
+std::vector<uint8_t> createDataFormatDescriptor(const FormatInfo &info)
+{
+	std::vector<DfdSample> samples;
+	if (info.colorModel == dfdModelBc3)
+	{
+		// The alpha block comes first in BC3
+		samples.push_back(DfdSample{ 0, 63, dfdChannelBc3Alpha, {}, 0u, 0xFFFFFFFFu });
+		samples.push_back(DfdSample{ 64, 63, dfdChannelColor, {}, 0u, 0xFFFFFFFFu });
+	}
+	else
+	{
+		samples.push_back(DfdSample{ 0, static_cast<uint8_t>(info.blockSize * 8 - 1), dfdChannelColor, {}, 0u, 0xFFFFFFFFu });
+	}
+
+	const uint32_t blockSize{ to_u32(24 + samples.size() * sizeof(DfdSample)) };
+	const uint32_t totalSize{ 4 + blockSize };
+
+	std::vector<uint8_t> descriptor(totalSize, 0);
+	uint8_t *data = descriptor.data();
+	const uint32_t vendorAndType{ 0 }; // Khronos vendor, basic descriptor type
+	const uint32_t versionAndSize{ dfdVersionNumber | (blockSize << 16) };
+	const uint8_t model[4]{ info.colorModel, dfdPrimariesBt709, info.transferFunction, 0 };
+	const uint8_t texelBlockDimensions[4]{ 3, 3, 0, 0 }; // 4x4x1x1, stored minus one
+	const uint8_t bytesPlane[8]{ static_cast<uint8_t>(info.blockSize) };
+
+	memcpy(data, &totalSize, 4);
+	memcpy(data + 4, &vendorAndType, 4);
+	memcpy(data + 8, &versionAndSize, 4);
+	memcpy(data + 12, model, 4);
+	memcpy(data + 16, texelBlockDimensions, 4);
+	memcpy(data + 20, bytesPlane, 8);
+	memcpy(data + 28, samples.data(), samples.size() * sizeof(DfdSample));
+
+	return descriptor;
+}
+
+} // namespace
+
+Ktx2Texture::Ktx2Texture(const std::string &path)
+{
+	file = std::make_unique<MappedFile>(path);
+	if (!file->isMapped() || file->getSize() < sizeof(Ktx2Header))
+	{
+		file.reset();
+		return;
+	}
+
+	Ktx2Header header;
+	memcpy(&header, file->getData(), sizeof(header));
+
+	const FormatInfo *info = findFormatInfo(static_cast<VkFormat>(header.vkFormat));
+	bool headerValid = memcmp(header.identifier, ktx2Identifier, sizeof(ktx2Identifier)) == 0 &&
+		info != nullptr &&
+		header.typeSize == 1 &&
+		header.pixelWidth > 0 &&
+		header.pixelHeight > 0 &&
+		header.pixelDepth == 0 &&
+		header.layerCount <= 1 &&
+		header.faceCount == 1 &&
+		header.levelCount > 0 &&
+		header.levelCount <= getMipLevelCount(header.pixelWidth, header.pixelHeight) &&
+		header.supercompressionScheme == 0 &&
+		sizeof(Ktx2Header) + header.levelCount * sizeof(Ktx2LevelIndex) <= file->getSize();
+
+	if (!headerValid)
+	{
+		file.reset();
+		return;
+	}
+
+	levelRanges.resize(header.levelCount);
+	for (uint32_t level = 0; level < header.levelCount; ++level)
+	{
+		Ktx2LevelIndex index;
+		memcpy(&index, file->getData() + sizeof(Ktx2Header) + level * sizeof(Ktx2LevelIndex), sizeof(index));
+
+		// The level sizes are checked against the format so the uploads never read past the end of the mapping
+		if (index.byteLength != getLevelSize(*info, header.pixelWidth, header.pixelHeight, level) ||
+			index.byteOffset % info->blockSize != 0 ||
+			index.byteOffset > file->getSize() ||
+			index.byteLength > file->getSize() - index.byteOffset)
+		{
+			file.reset();
+			levelRanges.clear();
+			return;
+		}
+
+		levelRanges[level] = Ktx2LevelRange{ index.byteOffset, index.byteLength };
+	}
+
+	format = info->format;
+	width = header.pixelWidth;
+	height = header.pixelHeight;
+	valid = true;
+}
+
+Ktx2Texture::~Ktx2Texture()
+{
+	file.reset();
+}
+
+bool Ktx2Texture::isValid() const
+{
+	return valid;
+}
+
+VkFormat Ktx2Texture::getFormat() const
+{
+	return format;
+}
+
+uint32_t Ktx2Texture::getWidth() const
+{
+	return width;
+}
+
+uint32_t Ktx2Texture::getHeight() const
+{
+	return height;
+}
+
+uint32_t Ktx2Texture::getLevelCount() const
+{
+	return to_u32(levelRanges.size());
+}
+
+const uint8_t *Ktx2Texture::getData() const
+{
+	return reinterpret_cast<const uint8_t *>(file->getData());
+}
+
+const Ktx2LevelRange &Ktx2Texture::getLevelRange(uint32_t level) const
+{
+	return levelRanges[level];
+}
+
+bool Ktx2Texture::isFormatSupported(VkFormat format)
+{
+	return findFormatInfo(format) != nullptr;
+}
+
+bool Ktx2Texture::write(const std::string &path, VkFormat format, uint32_t width, uint32_t height, const std::vector<Ktx2Level> &levels)
+{
+	const FormatInfo *info = findFormatInfo(format);
+	if (!info)
+	{
+		LOGW("KTX2 files can't be written with format {}, not writing {}", static_cast<int>(format), path);
+		return false;
+	}
+
+	for (uint32_t level = 0; level < to_u32(levels.size()); ++level)
+	{
+		if (levels[level].size != getLevelSize(*info, width, height, level))
+		{
+			LOGW("Level {} of {} doesn't have the size of a {}x{} image, not writing it", level, path, std::max(width >> level, 1u), std::max(height >> level, 1u));
+			return false;
+		}
+	}
+
+	const std::vector<uint8_t> dataFormatDescriptor = createDataFormatDescriptor(*info);
+
+	Ktx2Header header{};
+	memcpy(header.identifier, ktx2Identifier, sizeof(ktx2Identifier));
+	header.vkFormat = static_cast<uint32_t>(format);
+	header.typeSize = 1;
+	header.pixelWidth = width;
+	header.pixelHeight = height;
+	header.faceCount = 1;
+	header.levelCount = to_u32(levels.size());
+	header.dfdByteOffset = to_u32(sizeof(Ktx2Header) + levels.size() * sizeof(Ktx2LevelIndex));
+	header.dfdByteLength = to_u32(dataFormatDescriptor.size());
+
+	// The levels are stored from the smallest to the full resolution image, each one aligned to the block size
+	std::vector<Ktx2LevelIndex> levelIndex(levels.size());
+	uint64_t offset{ header.dfdByteOffset + header.dfdByteLength };
+	for (size_t level = levels.size(); level-- > 0;)
+	{
+		offset = (offset + info->blockSize - 1) / info->blockSize * info->blockSize;
+		levelIndex[level] = Ktx2LevelIndex{ offset, levels[level].size, levels[level].size };
+		offset += levels[level].size;
+	}
+
+	// Write to a temporary file first so a partially written texture is never picked up
+	const std::string temporaryPath = path + ".tmp";
+	{
+		std::ofstream textureFile{ temporaryPath, std::ios::binary | std::ios::trunc };
+		if (!textureFile)
+		{
+			LOGW("Failed to create {}", temporaryPath);
+			return false;
+		}
+
+		textureFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		textureFile.write(reinterpret_cast<const char *>(levelIndex.data()), static_cast<std::streamsize>(levelIndex.size() * sizeof(Ktx2LevelIndex)));
+		textureFile.write(reinterpret_cast<const char *>(dataFormatDescriptor.data()), static_cast<std::streamsize>(dataFormatDescriptor.size()));
+
+		const char padding[16]{};
+		uint64_t position{ header.dfdByteOffset + header.dfdByteLength };
+		for (size_t level = levels.size(); level-- > 0;)
+		{
+			textureFile.write(padding, static_cast<std::streamsize>(levelIndex[level].byteOffset - position));
+			textureFile.write(static_cast<const char *>(levels[level].data), static_cast<std::streamsize>(levels[level].size));
+			position = levelIndex[level].byteOffset + levels[level].size;
+		}
+
+		if (!textureFile)
+		{
+			LOGW("Failed to write {}", temporaryPath);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, path, error);
+	if (error)
+	{
+		LOGW("Failed to replace {}: {}", path, error.message());
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace vulkr
@@ -0,0 +1,98 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/vulkan_common.h"
+
+namespace vulkr
+{
+
+class MappedFile;
+
+/* The data of a single mip level passed to Ktx2Texture::write */
+struct Ktx2Level
+{
+	const void *data;
+	uint64_t size;
+};
+
+/* Location of a mip level inside the mapping of a KTX2 file */
+struct Ktx2LevelRange
+{
+	uint64_t offset;
+	uint64_t size;
+};
+
+/*
+ * A memory mapped KTX2 file holding a single 2D image and its mip chain without supercompression.
+ * Only the block compressed formats the renderer encodes are accepted, any other file is reported as invalid so the texture can be imported from its source again
+ */
+class Ktx2Texture
+{
+public:
+	Ktx2Texture(const std::string &path);
+	~Ktx2Texture();
+
+	Ktx2Texture(Ktx2Texture &&) = delete;
+	Ktx2Texture(const Ktx2Texture &) = delete;
+	Ktx2Texture &operator=(const Ktx2Texture &) = delete;
+	Ktx2Texture &operator=(Ktx2Texture &&) = delete;
+
+	/* Whether the file exists, is mapped and holds a texture that can be uploaded as is */
+	bool isValid() const;
+
+	VkFormat getFormat() const;
+	uint32_t getWidth() const;
+	uint32_t getHeight() const;
+	uint32_t getLevelCount() const;
+
+	/* Pointer to the start of the file, the level ranges are relative to it */
+	const uint8_t *getData() const;
+
+	/* Location of a mip level, level 0 being the full resolution image */
+	const Ktx2LevelRange &getLevelRange(uint32_t level) const;
+
+	/* Whether the format can be stored by write and read back */
+	static bool isFormatSupported(VkFormat format);
+
+	/**
+	 * Writes a KTX2 file, replacing any existing one
+	 * @param levels The data of every mip level ordered from the full resolution image to the smallest level
+	 * @return False if the file couldn't be written, which is not fatal since the texture can always be imported from its source again
+	 */
+	static bool write(const std::string &path, VkFormat format, uint32_t width, uint32_t height, const std::vector<Ktx2Level> &levels);
+private:
+	std::unique_ptr<MappedFile> file{ nullptr };
+	VkFormat format{ VK_FORMAT_UNDEFINED };
+	uint32_t width{ 0 };
+	uint32_t height{ 0 };
+	std::vector<Ktx2LevelRange> levelRanges;
+	bool valid{ false };
+};
+
+} // namespace vulkr
@@ -0,0 +1,257 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mesh.h"
+#include "common/helpers.h"
+#include "common/logger.h"
+#include "rendering/obj_loader.h"
+#include "rendering/vertex_weld_table.h"
+#include "rendering/mesh_optimizer.h"
+#include "rendering/mesh_simplifier.h"
+#include "rendering/vertex_layout.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vulkr
+{
+
+void Mesh::loadFromObjFile(const char *filename)
+{
+	cache = std::make_unique<MeshCache>(filename, to_u32(sizeof(Vertex)), MESH_IMPORT_VERSION);
+	if (cache->isValid())
+	{
+		const MeshCacheHeader &header = cache->getHeader();
+		vertexCount = to_u32(header.vertexCount);
+		indexCount = to_u32(header.indexCount);
+		lods.assign(cache->getLodData(), cache->getLodData() + header.lodCount);
+		boundsMin = glm::vec3{ header.boundsMin[0], header.boundsMin[1], header.boundsMin[2] };
+		boundsMax = glm::vec3{ header.boundsMax[0], header.boundsMax[1], header.boundsMax[2] };
+		return;
+	}
+	cache.reset();
+
+	ObjData objData;
+	if (!loadObjFile(filename, objData))
+	{
+		LOGEANDABORT("Failed to load {}", filename);
+	}
+
+	// Every face corner could be a unique vertex, so sizing the table for the corner count means it never has to grow
+	VertexWeldTable<Vertex> weldTable{ objData.indices.size() };
+	indices.reserve(objData.indices.size());
+
+	for (const ObjIndex &index : objData.indices)
+	{
+		// Every member is written explicitly since the weld table compares vertices bitwise
+		Vertex newVertex;
+		newVertex.position = { objData.positions[3 * index.position + 0], objData.positions[3 * index.position + 1], objData.positions[3 * index.position + 2] };
+		newVertex.normal = glm::vec3{ 0.0f };
+		if (index.normal >= 0)
+		{
+			newVertex.normal = { objData.normals[3 * index.normal + 0], objData.normals[3 * index.normal + 1], objData.normals[3 * index.normal + 2] };
+		}
+		newVertex.color = newVertex.normal; // Set the colour as the normal values for now
+		newVertex.textureCoordinate = glm::vec2{ 0.0f };
+		if (index.texcoord >= 0)
+		{
+			newVertex.textureCoordinate = { objData.texcoords[2 * index.texcoord + 0], 1 - objData.texcoords[2 * index.texcoord + 1] };
+		}
+
+		indices.push_back(weldTable.weld(newVertex, vertices));
+	}
+
+	const VertexWeldStatistics &weldStatistics = weldTable.getStatistics();
+	LOGD("{}: welded {} corners into {} vertices, {} collisions, average probe length {:.2f}, max probe length {}", filename, weldStatistics.lookups, weldStatistics.uniqueVertices, weldStatistics.collisions, weldStatistics.getAverageProbeLength(), weldStatistics.maxProbeLength);
+
+	optimize(filename);
+	generateLods(filename);
+
+	vertexCount = to_u32(vertices.size());
+	indexCount = to_u32(indices.size());
+
+	if (!vertices.empty())
+	{
+		boundsMin = boundsMax = vertices[0].position;
+		for (const Vertex &vertex : vertices)
+		{
+			boundsMin = glm::min(boundsMin, vertex.position);
+			boundsMax = glm::max(boundsMax, vertex.position);
+		}
+	}
+
+	MeshCache::write(filename, MESH_IMPORT_VERSION, vertices.data(), vertices.size(), to_u32(sizeof(Vertex)), indices.data(), indices.size(), lods.data(), to_u32(lods.size()), boundsMin, boundsMax);
+}
+
+const Vertex *Mesh::getVertexData() const
+{
+	return cache ? static_cast<const Vertex *>(cache->getVertexData()) : vertices.data();
+}
+
+const uint32_t *Mesh::getIndexData() const
+{
+	return cache ? cache->getIndexData() : indices.data();
+}
+
+void Mesh::optimize(const char *fileName)
+{
+	if (indices.empty())
+	{
+		return;
+	}
+
+	VertexCacheStatistics before = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+
+	optimizeVertexCache(indices.data(), indices.data(), indices.size(), vertices.size());
+	optimizeOverdraw(indices.data(), indices.data(), indices.size(), &vertices[0].position.x, vertices.size(), sizeof(Vertex));
+
+	std::vector<uint32_t> remap(vertices.size());
+	size_t referencedVertexCount = optimizeVertexFetch(remap.data(), indices.data(), indices.size(), vertices.size());
+
+	std::vector<Vertex> remappedVertices(vertices.size());
+	for (size_t i = 0; i < vertices.size(); ++i)
+	{
+		remappedVertices[remap[i]] = vertices[i];
+	}
+	remappedVertices.resize(referencedVertexCount);
+	vertices = std::move(remappedVertices);
+
+	VertexCacheStatistics after = analyzeVertexCache(indices.data(), indices.size(), vertices.size());
+	LOGI("{}: optimized vertex cache ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}", fileName, before.acmr, after.acmr, before.atvr, after.atvr);
+}
+
+void Mesh::generateLods(const char *fileName)
+{
+	lods.clear();
+	lods.push_back({ 0u, to_u32(indices.size()), 0.0f });
+	if (indices.empty())
+	{
+		return;
+	}
+
+	std::vector<uint32_t> lodIndices{ indices };
+	while (lods.size() < MAX_MESH_LOD_COUNT)
+	{
+		// Every LOD is simplified from the previous one, which is much faster than starting from the full detail mesh each time
+		size_t previousIndexCount = lodIndices.size();
+		size_t targetIndexCount = static_cast<size_t>(static_cast<float>(previousIndexCount / 3) * MESH_LOD_REDUCTION) * 3;
+
+		float error{ 0.0f };
+		size_t lodIndexCount = simplifyMesh(lodIndices.data(), lodIndices.data(), previousIndexCount, &vertices[0].position.x, vertices.size(), sizeof(Vertex), targetIndexCount, std::numeric_limits<float>::max(), &error);
+
+		// Stop once the simplifier is held up by locked vertices, a LOD that barely removes any triangles isn't worth its memory
+		if (lodIndexCount == 0 || lodIndexCount > previousIndexCount * 9 / 10)
+		{
+			break;
+		}
+
+		lodIndices.resize(lodIndexCount);
+		optimizeVertexCache(lodIndices.data(), lodIndices.data(), lodIndices.size(), vertices.size());
+
+		// The errors of the successive simplifications add up
+		lods.push_back({ to_u32(indices.size()), to_u32(lodIndexCount), lods.back().error + error });
+		indices.insert(indices.end(), lodIndices.begin(), lodIndices.end());
+
+		LOGD("{}: LOD {} has {} triangles with an error of {}", fileName, lods.size() - 1, lodIndexCount / 3, lods.back().error);
+	}
+
+	LOGI("{}: generated {} LODs, the coarsest has {} of {} triangles", fileName, lods.size(), lods.back().indexCount / 3, lods.front().indexCount / 3);
+}
+
+std::vector<QuantizedVertex> Mesh::quantizeVertices()
+{
+	const Vertex *vertexData = getVertexData();
+	std::vector<QuantizedVertex> quantizedVertices(vertexCount);
+	if (vertexCount == 0)
+	{
+		return quantizedVertices;
+	}
+
+	// Positions are quantized within the mesh bounds, a zero extent axis is kept non zero so the scale stays invertible
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+	glm::vec3 halfExtent = glm::max((boundsMax - boundsMin) * 0.5f, glm::vec3{ std::numeric_limits<float>::min() });
+
+	glm::vec2 textureCoordinateMin = vertexData[0].textureCoordinate;
+	glm::vec2 textureCoordinateMax = vertexData[0].textureCoordinate;
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		textureCoordinateMin = glm::min(textureCoordinateMin, vertexData[i].textureCoordinate);
+		textureCoordinateMax = glm::max(textureCoordinateMax, vertexData[i].textureCoordinate);
+	}
+	glm::vec2 textureCoordinateRange = glm::max(textureCoordinateMax - textureCoordinateMin, glm::vec2{ std::numeric_limits<float>::min() });
+
+	for (uint32_t i = 0; i < vertexCount; ++i)
+	{
+		const Vertex &vertex = vertexData[i];
+		QuantizedVertex &quantizedVertex = quantizedVertices[i];
+
+		glm::vec3 position = (vertex.position - center) / halfExtent;
+		quantizedVertex.position[0] = quantizeSnorm16(position.x);
+		quantizedVertex.position[1] = quantizeSnorm16(position.y);
+		quantizedVertex.position[2] = quantizeSnorm16(position.z);
+		quantizedVertex.position[3] = 0;
+
+		glm::vec2 normal = encodeOctahedral(vertex.normal);
+		quantizedVertex.normal[0] = quantizeSnorm16(normal.x);
+		quantizedVertex.normal[1] = quantizeSnorm16(normal.y);
+
+		glm::vec2 textureCoordinate = (vertex.textureCoordinate - textureCoordinateMin) / textureCoordinateRange;
+		quantizedVertex.textureCoordinate[0] = quantizeUnorm16(textureCoordinate.x);
+		quantizedVertex.textureCoordinate[1] = quantizeUnorm16(textureCoordinate.y);
+	}
+
+	dequantizationMatrix = glm::scale(glm::translate(glm::mat4{ 1.0f }, center), halfExtent);
+	textureCoordinateTransform = glm::vec4{ textureCoordinateRange, textureCoordinateMin };
+
+	return quantizedVertices;
+}
+
+uint32_t Mesh::selectLod(const glm::mat4 &transform, const Camera &camera, float errorThreshold) const
+{
+	// Bound the mesh with a sphere in world space, using the largest scale of the transform so the error is never underestimated
+	float scale = std::max({ glm::length(glm::vec3{ transform[0] }), glm::length(glm::vec3{ transform[1] }), glm::length(glm::vec3{ transform[2] }) });
+	glm::vec3 center = glm::vec3{ transform * glm::vec4{ (boundsMin + boundsMax) * 0.5f, 1.0f } };
+	float radius = glm::length(boundsMax - boundsMin) * 0.5f * scale;
+
+	// The error is projected at the closest point of the sphere, inside of it any simplification could be right in front of the camera
+	float distance = glm::length(center - camera.getPosition()) - radius;
+	if (distance <= camera.getClipNear())
+	{
+		return 0u;
+	}
+
+	float pixelsPerUnit = camera.getViewport().y / (2.0f * std::tan(glm::radians(camera.getFovY()) * 0.5f) * distance);
+
+	// The errors grow with every LOD, so pick the last one still under the threshold
+	uint32_t lodIndex{ 0 };
+	while (lodIndex + 1 < lods.size() && lods[lodIndex + 1].error * scale * pixelsPerUnit <= errorThreshold)
+	{
+		++lodIndex;
+	}
+
+	return lodIndex;
+}
+
+} // namespace vulkr
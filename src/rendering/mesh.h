@@ -0,0 +1,109 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "core/geometry_arena.h"
+#include "rendering/camera.h"
+#include "rendering/mesh_cache.h"
+
+#include <glm/glm.hpp>
+
+namespace vulkr
+{
+
+constexpr uint32_t MESH_IMPORT_VERSION{ 4 }; // Bump whenever Mesh::loadFromObjFile changes its output so existing mesh caches get rebuilt
+constexpr uint32_t MAX_MESH_LOD_COUNT{ 5 }; // Including the full detail mesh
+constexpr float MESH_LOD_REDUCTION{ 0.5f }; // Each LOD aims for this fraction of the triangles of the previous one
+
+struct Vertex
+{
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec3 color;
+	glm::vec2 textureCoordinate;
+
+	bool operator==(const Vertex &other) const
+	{
+		return position == other.position && normal == other.normal && color == other.color && textureCoordinate == other.textureCoordinate;
+	}
+};
+
+// The vertex welding during mesh import hashes and compares vertices as raw bytes, so there must not be any padding
+static_assert(sizeof(Vertex) == 11 * sizeof(float), "Vertex must be tightly packed");
+
+// Compact form of Vertex uploaded when vertex quantization is enabled, the colour is dropped since it is a copy of the normal
+struct QuantizedVertex
+{
+	int16_t position[4]; // snorm16 within the mesh bounds, w is padding since three component 16 bit formats are rarely supported as vertex input
+	int16_t normal[2]; // snorm16 octahedral encoding
+	uint16_t textureCoordinate[2]; // unorm16 within the mesh texture coordinate range
+};
+
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must be tightly packed");
+
+struct Mesh
+{
+	uint32_t id{ 0 }; // The index in the mesh table, which the render queue sort keys refer to
+	std::vector<Vertex> vertices;
+	std::vector<uint32_t> indices;
+	GeometryHandle geometry{ INVALID_GEOMETRY_HANDLE }; // The vertices and indices of every LOD in the geometry arena
+
+	// When the mesh is loaded from its cache the vectors above stay empty and the data is read straight from the mapping
+	std::unique_ptr<MeshCache> cache;
+	uint32_t vertexCount{ 0 };
+	uint32_t indexCount{ 0 }; // Of all LODs together
+	std::vector<MeshLod> lods;
+	glm::vec3 boundsMin{ 0.0f };
+	glm::vec3 boundsMax{ 0.0f };
+
+	// Undo the quantization of QuantizedVertex, the matrix is folded into the model matrix and the transform (xy scale, zw offset) is a push constant
+	glm::mat4 dequantizationMatrix{ 1.0f };
+	glm::vec4 textureCoordinateTransform{ 1.0f, 1.0f, 0.0f, 0.0f };
+
+	/* Imports the mesh from its cache when that is up to date, otherwise from the OBJ file, and writes the cache for the next run */
+	void loadFromObjFile(const char *fileName);
+	const Vertex *getVertexData() const;
+	const uint32_t *getIndexData() const;
+
+	/* Reorders the triangles for the vertex cache and overdraw, then the vertices in the order they are first used; unreferenced vertices are dropped */
+	void optimize(const char *fileName);
+
+	/* Packs the vertices into QuantizedVertex and sets up the dequantization parameters */
+	std::vector<QuantizedVertex> quantizeVertices();
+
+	/* Appends progressively simplified versions of the full detail indices, every LOD uses the same vertices */
+	void generateLods(const char *fileName);
+
+	/**
+	 * Picks the coarsest LOD whose error stays within the threshold once projected on screen
+	 * @param transform The transform from the space of the vertices to world space
+	 * @param errorThreshold The largest error in pixels a LOD may show
+	 */
+	uint32_t selectLod(const glm::mat4 &transform, const Camera &camera, float errorThreshold) const;
+};
+
+} // namespace vulkr
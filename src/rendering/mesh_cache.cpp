@@ -0,0 +1,270 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mesh_cache.h"
+#include "common/mapped_file.h"
+#include "common/logger.h"
+#include "common/helpers.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <type_traits>
+
+namespace vulkr
+{
+
+namespace
+{
+
+constexpr uint32_t meshCacheMagic{ 0x4D524B56 }; // "VKRM"
+constexpr uint32_t meshCacheFormatVersion{ 2 };
+
+static_assert(std::is_trivially_copyable<MeshCacheHeader>::value, "The mesh cache header is written and read as raw bytes");
+static_assert(std::is_trivially_copyable<MeshLod>::value, "The mesh cache LODs are written and read as raw bytes");
+
+bool getSourceStatus(const std::string &sourcePath, uint64_t &size, int64_t &modifiedTime)
+{
+	std::error_code error;
+	size = static_cast<uint64_t>(std::filesystem::file_size(sourcePath, error));
+	if (error)
+	{
+		return false;
+	}
+
+	auto writeTime = std::filesystem::last_write_time(sourcePath, error);
+	if (error)
+	{
+		return false;
+	}
+	modifiedTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+
+	return true;
+}
+
+bool hashSource(const std::string &sourcePath, uint64_t &hash)
+{
+	MappedFile source{ sourcePath };
+	if (!source.isMapped())
+	{
+		return false;
+	}
+
+	hash = hashBytes(source.getData(), source.getSize());
+	return true;
+}
+
+} // namespace
+
+MeshCache::MeshCache(const std::string &sourcePath, uint32_t vertexStride, uint32_t importVersion)
+{
+	const std::string cachePath = getCachePath(sourcePath);
+	if (!map(cachePath, vertexStride, importVersion))
+	{
+		return;
+	}
+
+	uint64_t sourceSize;
+	int64_t sourceModifiedTime;
+	if (!getSourceStatus(sourcePath, sourceSize, sourceModifiedTime))
+	{
+		// The cache is self contained, so it can still be used if the source isn't shipped
+		LOGW("{} could not be found, using {} without validating it", sourcePath, cachePath);
+		valid = true;
+		return;
+	}
+
+	if (sourceSize != header->sourceSize)
+	{
+		return;
+	}
+
+	if (sourceModifiedTime == header->sourceModifiedTime)
+	{
+		valid = true;
+		return;
+	}
+
+	// The source was touched but may not have changed, compare the contents before throwing the cache away
+	uint64_t sourceHash;
+	if (!hashSource(sourcePath, sourceHash) || sourceHash != header->sourceHash)
+	{
+		return;
+	}
+
+	// Record the new timestamp so the next start doesn't have to hash the source again
+	file.reset();
+	header = nullptr;
+	{
+		std::fstream cacheFile{ cachePath, std::ios::binary | std::ios::in | std::ios::out };
+		cacheFile.seekp(offsetof(MeshCacheHeader, sourceModifiedTime));
+		cacheFile.write(reinterpret_cast<const char *>(&sourceModifiedTime), sizeof(sourceModifiedTime));
+	}
+
+	valid = map(cachePath, vertexStride, importVersion);
+}
+
+MeshCache::~MeshCache()
+{
+	file.reset();
+}
+
+bool MeshCache::map(const std::string &cachePath, uint32_t vertexStride, uint32_t importVersion)
+{
+	file = std::make_unique<MappedFile>(cachePath);
+	if (!file->isMapped() || file->getSize() < sizeof(MeshCacheHeader))
+	{
+		file.reset();
+		return false;
+	}
+
+	header = reinterpret_cast<const MeshCacheHeader *>(file->getData());
+
+	const uint64_t vertexDataSize{ header->vertexCount * header->vertexStride };
+	const uint64_t indexDataSize{ header->indexCount * sizeof(uint32_t) };
+	const uint64_t lodDataSize{ header->lodCount * sizeof(MeshLod) };
+
+	bool headerValid = header->magic == meshCacheMagic &&
+		header->formatVersion == meshCacheFormatVersion &&
+		header->importVersion == importVersion &&
+		header->vertexStride == vertexStride &&
+		header->vertexDataOffset >= sizeof(MeshCacheHeader) &&
+		header->vertexDataOffset + vertexDataSize <= file->getSize() &&
+		header->indexDataOffset % alignof(uint32_t) == 0 &&
+		header->indexDataOffset + indexDataSize <= file->getSize() &&
+		header->lodDataOffset % alignof(MeshLod) == 0 &&
+		header->lodDataOffset + lodDataSize <= file->getSize();
+
+	if (!headerValid)
+	{
+		file.reset();
+		header = nullptr;
+		return false;
+	}
+
+	return true;
+}
+
+bool MeshCache::isValid() const
+{
+	return valid;
+}
+
+const MeshCacheHeader &MeshCache::getHeader() const
+{
+	return *header;
+}
+
+const void *MeshCache::getVertexData() const
+{
+	return file->getData() + header->vertexDataOffset;
+}
+
+const uint32_t *MeshCache::getIndexData() const
+{
+	return reinterpret_cast<const uint32_t *>(file->getData() + header->indexDataOffset);
+}
+
+const MeshLod *MeshCache::getLodData() const
+{
+	return reinterpret_cast<const MeshLod *>(file->getData() + header->lodDataOffset);
+}
+
+std::string MeshCache::getCachePath(const std::string &sourcePath)
+{
+	return sourcePath + ".vkrmesh";
+}
+
+bool MeshCache::write(
+	const std::string &sourcePath,
+	uint32_t importVersion,
+	const void *vertices,
+	uint64_t vertexCount,
+	uint32_t vertexStride,
+	const uint32_t *indices,
+	uint64_t indexCount,
+	const MeshLod *lods,
+	uint32_t lodCount,
+	const glm::vec3 &boundsMin,
+	const glm::vec3 &boundsMax
+)
+{
+	MeshCacheHeader header{};
+	header.magic = meshCacheMagic;
+	header.formatVersion = meshCacheFormatVersion;
+	header.importVersion = importVersion;
+	header.vertexStride = vertexStride;
+	header.vertexCount = vertexCount;
+	header.indexCount = indexCount;
+	header.vertexDataOffset = sizeof(MeshCacheHeader);
+	header.indexDataOffset = header.vertexDataOffset + ((vertexCount * vertexStride + 3u) & ~uint64_t{ 3u });
+	header.lodDataOffset = header.indexDataOffset + indexCount * sizeof(uint32_t);
+	header.lodCount = lodCount;
+	memcpy(header.boundsMin, &boundsMin.x, sizeof(header.boundsMin));
+	memcpy(header.boundsMax, &boundsMax.x, sizeof(header.boundsMax));
+
+	if (!getSourceStatus(sourcePath, header.sourceSize, header.sourceModifiedTime) || !hashSource(sourcePath, header.sourceHash))
+	{
+		LOGW("Failed to read {}, not writing a mesh cache for it", sourcePath);
+		return false;
+	}
+
+	// Write to a temporary file first so a partially written cache is never picked up
+	const std::string cachePath = getCachePath(sourcePath);
+	const std::string temporaryPath = cachePath + ".tmp";
+	{
+		std::ofstream cacheFile{ temporaryPath, std::ios::binary | std::ios::trunc };
+		if (!cacheFile)
+		{
+			LOGW("Failed to create {}", temporaryPath);
+			return false;
+		}
+
+		const char padding[4]{};
+		cacheFile.write(reinterpret_cast<const char *>(&header), sizeof(header));
+		cacheFile.write(static_cast<const char *>(vertices), static_cast<std::streamsize>(vertexCount * vertexStride));
+		cacheFile.write(padding, static_cast<std::streamsize>(header.indexDataOffset - header.vertexDataOffset - vertexCount * vertexStride));
+		cacheFile.write(reinterpret_cast<const char *>(indices), static_cast<std::streamsize>(indexCount * sizeof(uint32_t)));
+		cacheFile.write(reinterpret_cast<const char *>(lods), static_cast<std::streamsize>(lodCount * sizeof(MeshLod)));
+
+		if (!cacheFile)
+		{
+			LOGW("Failed to write {}", temporaryPath);
+			return false;
+		}
+	}
+
+	std::error_code error;
+	std::filesystem::rename(temporaryPath, cachePath, error);
+	if (error)
+	{
+		LOGW("Failed to replace {}: {}", cachePath, error.message());
+		std::filesystem::remove(temporaryPath, error);
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace vulkr
@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <glm/glm.hpp>
+
+namespace vulkr
+{
+
+class MappedFile;
+
+/* A level of detail of a mesh, a range of the shared index buffer drawn with the full vertex buffer */
+struct MeshLod
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	float error; // The largest distance a vertex was moved by compared to the full detail mesh, in model units
+};
+
+/* Layout of the header at the start of a .vkrmesh file, the vertex, index and LOD arrays follow at the recorded offsets in native byte order */
+struct MeshCacheHeader
+{
+	uint32_t magic;
+	uint32_t formatVersion;
+	uint32_t importVersion; // Bumped by the application whenever the import processing changes the output
+	uint32_t vertexStride;
+	uint64_t vertexCount;
+	uint64_t indexCount;
+	uint64_t vertexDataOffset;
+	uint64_t indexDataOffset;
+	float boundsMin[3];
+	float boundsMax[3];
+	uint64_t sourceSize;
+	int64_t sourceModifiedTime;
+	uint64_t sourceHash;
+	uint64_t lodDataOffset;
+	uint32_t lodCount;
+	uint32_t padding;
+};
+
+/*
+ * A memory mapped binary cache of an imported mesh, stored next to the source file with a .vkrmesh extension.
+ * A cache is only considered valid if it was written for the same vertex layout and import version, and the source file
+ * still has the recorded size and modification time; if only the modification time differs the source is hashed to decide.
+ */
+class MeshCache
+{
+public:
+	MeshCache(const std::string &sourcePath, uint32_t vertexStride, uint32_t importVersion);
+	~MeshCache();
+
+	MeshCache(MeshCache &&) = delete;
+	MeshCache(const MeshCache &) = delete;
+	MeshCache &operator=(const MeshCache &) = delete;
+	MeshCache &operator=(MeshCache &&) = delete;
+
+	/* Whether the cache exists, is mapped and is up to date with the source file */
+	bool isValid() const;
+
+	const MeshCacheHeader &getHeader() const;
+
+	/* Pointer to the vertex array inside the mapping, vertexCount * vertexStride bytes */
+	const void *getVertexData() const;
+
+	/* Pointer to the index array inside the mapping, holding the indices of every LOD */
+	const uint32_t *getIndexData() const;
+
+	/* Pointer to the LOD array inside the mapping, ordered from the full detail mesh to the coarsest */
+	const MeshLod *getLodData() const;
+
+	/* Gets the path of the cache belonging to a source file */
+	static std::string getCachePath(const std::string &sourcePath);
+
+	/**
+	 * Writes the cache for a source file, replacing any existing one
+	 * @return False if the cache couldn't be written, which is not fatal since the source can always be imported again
+	 */
+	static bool write(
+		const std::string &sourcePath,
+		uint32_t importVersion,
+		const void *vertices,
+		uint64_t vertexCount,
+		uint32_t vertexStride,
+		const uint32_t *indices,
+		uint64_t indexCount,
+		const MeshLod *lods,
+		uint32_t lodCount,
+		const glm::vec3 &boundsMin,
+		const glm::vec3 &boundsMax
+	);
+private:
+	std::unique_ptr<MappedFile> file{ nullptr };
+	const MeshCacheHeader *header{ nullptr };
+	bool valid{ false };
+
+	/* Maps the cache and validates everything in the header that doesn't depend on the source file */
+	bool map(const std::string &cachePath, uint32_t vertexStride, uint32_t importVersion);
+};
+
+} // namespace vulkr
@@ -0,0 +1,441 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace vulkr
+{
+
+namespace
+{
+
+// Tuning values from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+constexpr uint32_t forsythCacheSize{ 32 };
+constexpr float cacheDecayPower{ 1.5f };
+constexpr float lastTriangleScore{ 0.75f };
+constexpr float valenceBoostScale{ 2.0f };
+constexpr float valenceBoostPower{ 0.5f };
+
+// The cache size assumed when splitting clusters for the overdraw optimization, matching the analysis default
+constexpr uint32_t clusterCacheSize{ 16 };
+
+float computeVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+{
+	if (remainingTriangles == 0)
+	{
+		// No triangle needs this vertex anymore
+		return -1.0f;
+	}
+
+	float score{ 0.0f };
+	if (cachePosition >= 0)
+	{
+		if (cachePosition < 3)
+		{
+			// The vertex was used by the last triangle, a fixed score stops the algorithm from strongly preferring to reuse the same edge
+			score = lastTriangleScore;
+		}
+		else
+		{
+			const float scaler{ 1.0f / static_cast<float>(forsythCacheSize - 3) };
+			score = std::pow(1.0f - static_cast<float>(cachePosition - 3) * scaler, cacheDecayPower);
+		}
+	}
+
+	// Boost vertices with few triangles left so that lone triangles don't get left behind
+	score += valenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -valenceBoostPower);
+
+	return score;
+}
+
+/* Returns the amount of vertices of the triangle that missed the FIFO cache, updating the cache timestamps */
+uint32_t simulateTriangle(const uint32_t *triangle, std::vector<uint32_t> &timestamps, uint32_t &timestamp, uint32_t cacheSize)
+{
+	uint32_t misses{ 0 };
+	for (uint32_t corner = 0; corner < 3; ++corner)
+	{
+		uint32_t vertex = triangle[corner];
+		if (timestamp - timestamps[vertex] > cacheSize)
+		{
+			timestamps[vertex] = timestamp++;
+			++misses;
+		}
+	}
+	return misses;
+}
+
+glm::vec3 getPosition(const float *positions, size_t positionStride, uint32_t vertex)
+{
+	const float *position = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positions) + vertex * positionStride);
+	return glm::vec3{ position[0], position[1], position[2] };
+}
+
+} // namespace
+
+VertexCacheStatistics analyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize)
+{
+	VertexCacheStatistics statistics{};
+	if (indexCount == 0 || vertexCount == 0)
+	{
+		return statistics;
+	}
+
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t timestamp{ cacheSize + 1 };
+
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		statistics.transformedVertices += simulateTriangle(&indices[i], timestamps, timestamp, cacheSize);
+	}
+
+	statistics.acmr = static_cast<float>(statistics.transformedVertices) / static_cast<float>(indexCount / 3);
+	statistics.atvr = static_cast<float>(statistics.transformedVertices) / static_cast<float>(vertexCount);
+
+	return statistics;
+}
+
+void optimizeVertexCache(uint32_t *destination, const uint32_t *indices, size_t indexCount, size_t vertexCount)
+{
+	const size_t triangleCount{ indexCount / 3 };
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// Copy the input so the destination may alias it
+	std::vector<uint32_t> input(indices, indices + triangleCount * 3);
+
+	// Build the vertex to triangle adjacency, the live triangles of a vertex are kept at the front of its range
+	std::vector<uint32_t> liveTriangleCounts(vertexCount, 0);
+	for (uint32_t index : input)
+	{
+		++liveTriangleCounts[index];
+	}
+
+	std::vector<uint32_t> adjacencyOffsets(vertexCount, 0);
+	uint32_t offset{ 0 };
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		adjacencyOffsets[vertex] = offset;
+		offset += liveTriangleCounts[vertex];
+	}
+
+	std::vector<uint32_t> adjacency(triangleCount * 3);
+	std::vector<uint32_t> fillCounts(vertexCount, 0);
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		for (size_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = input[triangle * 3 + corner];
+			adjacency[adjacencyOffsets[vertex] + fillCounts[vertex]++] = static_cast<uint32_t>(triangle);
+		}
+	}
+
+	std::vector<int32_t> cachePositions(vertexCount, -1);
+	std::vector<float> vertexScores(vertexCount);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		vertexScores[vertex] = computeVertexScore(-1, liveTriangleCounts[vertex]);
+	}
+
+	std::vector<float> triangleScores(triangleCount);
+	std::vector<bool> emitted(triangleCount, false);
+
+	int64_t bestTriangle{ -1 };
+	float bestScore{ -1.0f };
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		triangleScores[triangle] = vertexScores[input[triangle * 3]] + vertexScores[input[triangle * 3 + 1]] + vertexScores[input[triangle * 3 + 2]];
+		if (triangleScores[triangle] > bestScore)
+		{
+			bestScore = triangleScores[triangle];
+			bestTriangle = static_cast<int64_t>(triangle);
+		}
+	}
+
+	// The cache holds up to three extra entries while a triangle is being added
+	std::array<uint32_t, forsythCacheSize + 3> cache{};
+	std::array<uint32_t, forsythCacheSize + 3> newCache{};
+	uint32_t cacheCount{ 0 };
+
+	size_t searchCursor{ 0 };
+	for (size_t outputTriangle = 0; outputTriangle < triangleCount; ++outputTriangle)
+	{
+		if (bestTriangle < 0)
+		{
+			// None of the cached vertices have triangles left, fall back to the next triangle in the input order
+			while (emitted[searchCursor])
+			{
+				++searchCursor;
+			}
+			bestTriangle = static_cast<int64_t>(searchCursor);
+		}
+
+		const uint32_t triangle{ static_cast<uint32_t>(bestTriangle) };
+		const uint32_t *triangleVertices = &input[triangle * 3];
+
+		destination[outputTriangle * 3 + 0] = triangleVertices[0];
+		destination[outputTriangle * 3 + 1] = triangleVertices[1];
+		destination[outputTriangle * 3 + 2] = triangleVertices[2];
+		emitted[triangle] = true;
+
+		// Remove the triangle from the live adjacency of its vertices
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = triangleVertices[corner];
+			uint32_t *triangles = &adjacency[adjacencyOffsets[vertex]];
+			uint32_t &liveCount = liveTriangleCounts[vertex];
+			for (uint32_t i = 0; i < liveCount; ++i)
+			{
+				if (triangles[i] == triangle)
+				{
+					std::swap(triangles[i], triangles[liveCount - 1]);
+					--liveCount;
+					break;
+				}
+			}
+		}
+
+		// Move the triangle's vertices to the front of the cache, followed by the remaining previously cached vertices
+		uint32_t newCacheCount{ 0 };
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t vertex = triangleVertices[corner];
+			if (std::find(newCache.begin(), newCache.begin() + newCacheCount, vertex) == newCache.begin() + newCacheCount)
+			{
+				newCache[newCacheCount++] = vertex;
+			}
+		}
+		for (uint32_t i = 0; i < cacheCount; ++i)
+		{
+			uint32_t vertex = cache[i];
+			if (vertex != triangleVertices[0] && vertex != triangleVertices[1] && vertex != triangleVertices[2])
+			{
+				newCache[newCacheCount++] = vertex;
+			}
+		}
+
+		// Update the scores of every vertex that moved, including those pushed out of the cache, and propagate the change to their triangles
+		for (uint32_t i = 0; i < newCacheCount; ++i)
+		{
+			uint32_t vertex = newCache[i];
+			cachePositions[vertex] = i < forsythCacheSize ? static_cast<int32_t>(i) : -1;
+
+			float score = computeVertexScore(cachePositions[vertex], liveTriangleCounts[vertex]);
+			float delta = score - vertexScores[vertex];
+			vertexScores[vertex] = score;
+
+			const uint32_t *triangles = &adjacency[adjacencyOffsets[vertex]];
+			for (uint32_t j = 0; j < liveTriangleCounts[vertex]; ++j)
+			{
+				triangleScores[triangles[j]] += delta;
+			}
+		}
+
+		cacheCount = std::min(newCacheCount, forsythCacheSize);
+		std::copy(newCache.begin(), newCache.begin() + cacheCount, cache.begin());
+
+		// The next triangle is the best scoring one that touches the cache
+		bestTriangle = -1;
+		bestScore = -1.0f;
+		for (uint32_t i = 0; i < cacheCount; ++i)
+		{
+			uint32_t vertex = cache[i];
+			const uint32_t *triangles = &adjacency[adjacencyOffsets[vertex]];
+			for (uint32_t j = 0; j < liveTriangleCounts[vertex]; ++j)
+			{
+				if (triangleScores[triangles[j]] > bestScore)
+				{
+					bestScore = triangleScores[triangles[j]];
+					bestTriangle = static_cast<int64_t>(triangles[j]);
+				}
+			}
+		}
+	}
+}
+
+void optimizeOverdraw(uint32_t *destination, const uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t positionStride, float threshold)
+{
+	const size_t triangleCount{ indexCount / 3 };
+	if (triangleCount == 0)
+	{
+		return;
+	}
+
+	// Copy the input so the destination may alias it
+	std::vector<uint32_t> input(indices, indices + triangleCount * 3);
+
+	std::vector<uint32_t> timestamps(vertexCount, 0);
+	uint32_t timestamp{ clusterCacheSize + 1 };
+	auto resetCache = [&timestamp]() { timestamp += clusterCacheSize + 1; };
+
+	// Hard boundaries are where the vertex cache optimizer had to start from scratch, reordering there can't hurt the vertex cache
+	std::vector<uint32_t> hardBoundaries;
+	for (size_t triangle = 0; triangle < triangleCount; ++triangle)
+	{
+		uint32_t misses = simulateTriangle(&input[triangle * 3], timestamps, timestamp, clusterCacheSize);
+		if (triangle == 0 || misses == 3)
+		{
+			hardBoundaries.push_back(static_cast<uint32_t>(triangle));
+		}
+	}
+	hardBoundaries.push_back(static_cast<uint32_t>(triangleCount));
+
+	// Soft boundaries split hard clusters further as long as each piece stays within the threshold of the cluster's own ACMR
+	std::vector<uint32_t> clusterStarts;
+	for (size_t hard = 0; hard + 1 < hardBoundaries.size(); ++hard)
+	{
+		const uint32_t start{ hardBoundaries[hard] };
+		const uint32_t end{ hardBoundaries[hard + 1] };
+
+		resetCache();
+		uint32_t clusterMisses{ 0 };
+		for (uint32_t triangle = start; triangle < end; ++triangle)
+		{
+			clusterMisses += simulateTriangle(&input[triangle * 3], timestamps, timestamp, clusterCacheSize);
+		}
+		const float acmrThreshold{ threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start) };
+
+		resetCache();
+		uint32_t clusterStart{ start };
+		clusterMisses = 0;
+		for (uint32_t triangle = start; triangle < end; ++triangle)
+		{
+			clusterMisses += simulateTriangle(&input[triangle * 3], timestamps, timestamp, clusterCacheSize);
+
+			if (triangle + 1 < end && static_cast<float>(clusterMisses) <= acmrThreshold * static_cast<float>(triangle + 1 - clusterStart))
+			{
+				clusterStarts.push_back(clusterStart);
+				clusterStart = triangle + 1;
+				clusterMisses = 0;
+				resetCache();
+			}
+		}
+		clusterStarts.push_back(clusterStart);
+	}
+	clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+	const size_t clusterCount{ clusterStarts.size() - 1 };
+
+	// Area weighted centroid and normal of every cluster, and of the mesh as a whole
+	std::vector<glm::vec3> clusterCentroids(clusterCount, glm::vec3{ 0.0f });
+	std::vector<glm::vec3> clusterNormals(clusterCount, glm::vec3{ 0.0f });
+	glm::vec3 meshCentroid{ 0.0f };
+	float meshArea{ 0.0f };
+
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster)
+	{
+		float clusterArea{ 0.0f };
+		for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle)
+		{
+			glm::vec3 p0 = getPosition(positions, positionStride, input[triangle * 3 + 0]);
+			glm::vec3 p1 = getPosition(positions, positionStride, input[triangle * 3 + 1]);
+			glm::vec3 p2 = getPosition(positions, positionStride, input[triangle * 3 + 2]);
+
+			glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+			float area = glm::length(normal);
+
+			clusterCentroids[cluster] += (p0 + p1 + p2) * (area / 3.0f);
+			clusterNormals[cluster] += normal;
+			clusterArea += area;
+		}
+
+		meshCentroid += clusterCentroids[cluster];
+		meshArea += clusterArea;
+
+		if (clusterArea > 0.0f)
+		{
+			clusterCentroids[cluster] /= clusterArea;
+		}
+
+		float normalLength = glm::length(clusterNormals[cluster]);
+		if (normalLength > 0.0f)
+		{
+			clusterNormals[cluster] /= normalLength;
+		}
+	}
+
+	if (meshArea > 0.0f)
+	{
+		meshCentroid /= meshArea;
+	}
+
+	// Clusters on the outside facing outwards are most likely to occlude the rest of the mesh, so they are drawn first
+	std::vector<float> sortKeys(clusterCount);
+	std::vector<uint32_t> clusterOrder(clusterCount);
+	for (size_t cluster = 0; cluster < clusterCount; ++cluster)
+	{
+		sortKeys[cluster] = glm::dot(clusterCentroids[cluster] - meshCentroid, clusterNormals[cluster]);
+		clusterOrder[cluster] = static_cast<uint32_t>(cluster);
+	}
+
+	std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&sortKeys](uint32_t lhs, uint32_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+	size_t outputIndex{ 0 };
+	for (uint32_t cluster : clusterOrder)
+	{
+		for (uint32_t triangle = clusterStarts[cluster]; triangle < clusterStarts[cluster + 1]; ++triangle)
+		{
+			destination[outputIndex++] = input[triangle * 3 + 0];
+			destination[outputIndex++] = input[triangle * 3 + 1];
+			destination[outputIndex++] = input[triangle * 3 + 2];
+		}
+	}
+}
+
+size_t optimizeVertexFetch(uint32_t *remap, uint32_t *indices, size_t indexCount, size_t vertexCount)
+{
+	constexpr uint32_t unused{ ~0u };
+	std::fill(remap, remap + vertexCount, unused);
+
+	uint32_t nextVertex{ 0 };
+	for (size_t i = 0; i < indexCount; ++i)
+	{
+		uint32_t &vertex = remap[indices[i]];
+		if (vertex == unused)
+		{
+			vertex = nextVertex++;
+		}
+		indices[i] = vertex;
+	}
+
+	const size_t referencedVertexCount{ nextVertex };
+
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		if (remap[vertex] == unused)
+		{
+			remap[vertex] = nextVertex++;
+		}
+	}
+
+	return referencedVertexCount;
+}
+
+} // namespace vulkr
@@ -0,0 +1,69 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vulkr
+{
+
+/* Efficiency of an index buffer for the post-transform vertex cache, simulated as a FIFO cache */
+struct VertexCacheStatistics
+{
+	uint32_t transformedVertices{ 0 };
+	float acmr{ 0.0f }; // Average cache miss ratio: transformed vertices per triangle, 3 is the worst case and 0.5 the best possible on a regular grid
+	float atvr{ 0.0f }; // Average transform to vertex ratio: transformed vertices per vertex, 1 is the best case
+};
+
+/* Simulates a FIFO post-transform cache of the given size over the index buffer */
+VertexCacheStatistics analyzeVertexCache(const uint32_t *indices, size_t indexCount, size_t vertexCount, uint32_t cacheSize = 16u);
+
+/**
+ * Reorders triangles to improve post-transform vertex cache reuse with Tom Forsyth's linear-speed algorithm
+ * @param destination The reordered index buffer, may be the same as indices
+ * @param indices The triangle list to reorder
+ * @param indexCount The amount of indices, a multiple of three
+ * @param vertexCount The amount of vertices referenced by the indices
+ */
+void optimizeVertexCache(uint32_t *destination, const uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+/**
+ * Reorders clusters of a vertex cache optimized index buffer so that triangles likely to occlude others are drawn first, reducing overdraw.
+ * The triangles are split into clusters wherever the vertex cache efficiency allows, clusters are then sorted by how much they face away from the mesh center.
+ * @param destination The reordered index buffer, may be the same as indices
+ * @param positions Pointer to the x component of the first vertex position
+ * @param positionStride The amount of bytes between two vertex positions
+ * @param threshold How much the ACMR is allowed to degrade, 1.05 allows 5% worse vertex cache efficiency for better overdraw
+ */
+void optimizeOverdraw(uint32_t *destination, const uint32_t *indices, size_t indexCount, const float *positions, size_t vertexCount, size_t positionStride, float threshold = 1.05f);
+
+/**
+ * Builds a remap table that orders vertices by their first use in the index buffer, improving memory locality of vertex fetches.
+ * The indices are rewritten to the new vertex order; the caller moves vertex i to remap[i]. Unreferenced vertices are moved to the end.
+ * @param remap An array of vertexCount entries that receives the new location of every vertex
+ * @return The amount of vertices referenced by the index buffer
+ */
+size_t optimizeVertexFetch(uint32_t *remap, uint32_t *indices, size_t indexCount, size_t vertexCount);
+
+} // namespace vulkr
@@ -0,0 +1,521 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mesh_simplifier.h"
+#include "vertex_weld_table.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace vulkr
+{
+
+namespace
+{
+
+// Open border edges are pinned with planes perpendicular to the surface, weighted heavily so that borders only move along themselves
+constexpr float borderPlaneWeight{ 10.0f };
+
+// Collapses within a pass are allowed up to this multiple of the error at the collapse goal, keeping the passes close to a global greedy order
+constexpr float passErrorSlack{ 1.5f };
+
+constexpr uint32_t invalidVertex{ ~0u };
+
+enum class VertexKind : uint8_t
+{
+	Manifold, // Every edge is shared by two triangles, can collapse onto any neighbour
+	Border, // Lies on an open border, can only collapse along the border
+	Seam, // Split in two along an attribute seam, can only collapse along the seam together with its sibling
+	Locked // Anything more complex, never collapses
+};
+
+/* Sum of squared distances to a set of weighted planes, stored as the symmetric matrix A, vector b and constant c of p^T A p + 2 b^T p + c */
+struct Quadric
+{
+	double a00{ 0.0 }, a11{ 0.0 }, a22{ 0.0 };
+	double a01{ 0.0 }, a02{ 0.0 }, a12{ 0.0 };
+	double b0{ 0.0 }, b1{ 0.0 }, b2{ 0.0 };
+	double c{ 0.0 };
+	double weight{ 0.0 };
+
+	void addPlane(const glm::vec3 &normal, float distance, float planeWeight)
+	{
+		const double x{ normal.x }, y{ normal.y }, z{ normal.z }, d{ distance }, w{ planeWeight };
+
+		a00 += w * x * x;
+		a11 += w * y * y;
+		a22 += w * z * z;
+		a01 += w * x * y;
+		a02 += w * x * z;
+		a12 += w * y * z;
+		b0 += w * x * d;
+		b1 += w * y * d;
+		b2 += w * z * d;
+		c += w * d * d;
+		weight += w;
+	}
+
+	void add(const Quadric &other)
+	{
+		a00 += other.a00;
+		a11 += other.a11;
+		a22 += other.a22;
+		a01 += other.a01;
+		a02 += other.a02;
+		a12 += other.a12;
+		b0 += other.b0;
+		b1 += other.b1;
+		b2 += other.b2;
+		c += other.c;
+		weight += other.weight;
+	}
+
+	/* The weighted mean squared distance of the point to the planes */
+	float evaluate(const glm::vec3 &point) const
+	{
+		const double x{ point.x }, y{ point.y }, z{ point.z };
+
+		double result = a00 * x * x + a11 * y * y + a22 * z * z +
+			2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+			2.0 * (b0 * x + b1 * y + b2 * z) +
+			c;
+
+		return weight > 0.0 ? static_cast<float>(std::abs(result) / weight) : 0.0f;
+	}
+};
+
+/* A candidate collapse of vertex from onto vertex to */
+struct Collapse
+{
+	uint32_t from;
+	uint32_t to;
+	float error;
+};
+
+/* Vertex to triangle adjacency of the current triangle list */
+struct TriangleAdjacency
+{
+	std::vector<uint32_t> offsets;
+	std::vector<uint32_t> counts;
+	std::vector<uint32_t> triangles;
+
+	void build(const uint32_t *indices, size_t indexCount, size_t vertexCount)
+	{
+		counts.assign(vertexCount, 0);
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			++counts[indices[i]];
+		}
+
+		offsets.resize(vertexCount);
+		uint32_t offset{ 0 };
+		for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			offsets[vertex] = offset;
+			offset += counts[vertex];
+		}
+
+		triangles.resize(indexCount);
+		std::vector<uint32_t> fillCounts(vertexCount, 0);
+		for (size_t i = 0; i < indexCount; ++i)
+		{
+			uint32_t vertex = indices[i];
+			triangles[offsets[vertex] + fillCounts[vertex]++] = static_cast<uint32_t>(i / 3);
+		}
+	}
+};
+
+/* Whether any triangle has the directed edge from -> to */
+bool hasEdge(const TriangleAdjacency &adjacency, const uint32_t *indices, uint32_t from, uint32_t to)
+{
+	for (uint32_t i = 0; i < adjacency.counts[from]; ++i)
+	{
+		const uint32_t *triangle = &indices[adjacency.triangles[adjacency.offsets[from] + i] * 3];
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			if (triangle[corner] == from && triangle[(corner + 1) % 3] == to)
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* An edge is open when it isn't shared by a triangle winding the other way, either on a border or on an attribute seam */
+bool isOpenEdge(const TriangleAdjacency &adjacency, const uint32_t *indices, uint32_t a, uint32_t b)
+{
+	return hasEdge(adjacency, indices, a, b) != hasEdge(adjacency, indices, b, a);
+}
+
+/* Whether moving vertex from onto vertex to would turn any of the triangles around from upside down */
+bool hasTriangleFlip(const TriangleAdjacency &adjacency, const uint32_t *indices, const std::vector<glm::vec3> &positions, uint32_t from, uint32_t to)
+{
+	const glm::vec3 &fromPosition = positions[from];
+	const glm::vec3 &toPosition = positions[to];
+
+	for (uint32_t i = 0; i < adjacency.counts[from]; ++i)
+	{
+		const uint32_t *triangle = &indices[adjacency.triangles[adjacency.offsets[from] + i] * 3];
+
+		uint32_t corner = triangle[0] == from ? 0 : (triangle[1] == from ? 1 : 2);
+		uint32_t b = triangle[(corner + 1) % 3];
+		uint32_t c = triangle[(corner + 2) % 3];
+
+		// Triangles sharing the collapsed edge become degenerate and are removed
+		if (b == to || c == to)
+		{
+			continue;
+		}
+
+		glm::vec3 oldNormal = glm::cross(positions[b] - fromPosition, positions[c] - fromPosition);
+		glm::vec3 newNormal = glm::cross(positions[b] - toPosition, positions[c] - toPosition);
+		if (glm::dot(oldNormal, newNormal) <= 0.0f)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+} // namespace
+
+size_t simplifyMesh(
+	uint32_t *destination,
+	const uint32_t *indices,
+	size_t indexCount,
+	const float *positions,
+	size_t vertexCount,
+	size_t positionStride,
+	size_t targetIndexCount,
+	float targetError,
+	float *resultError
+)
+{
+	// Work on a copy without degenerate triangles so the destination may alias the input
+	std::vector<uint32_t> result;
+	result.reserve(indexCount);
+	for (size_t i = 0; i + 2 < indexCount; i += 3)
+	{
+		if (indices[i] != indices[i + 1] && indices[i] != indices[i + 2] && indices[i + 1] != indices[i + 2])
+		{
+			result.insert(result.end(), { indices[i], indices[i + 1], indices[i + 2] });
+		}
+	}
+
+	std::vector<glm::vec3> vertexPositions(vertexCount);
+	for (size_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		const float *position = reinterpret_cast<const float *>(reinterpret_cast<const uint8_t *>(positions) + vertex * positionStride);
+		vertexPositions[vertex] = glm::vec3{ position[0], position[1], position[2] };
+	}
+
+	// Vertices sharing a position are linked into a ring of siblings, and everything position based is stored on the first of them
+	std::vector<uint32_t> positionRemap(vertexCount);
+	std::vector<uint32_t> siblings(vertexCount);
+	{
+		VertexWeldTable<glm::vec3> positionTable{ vertexCount };
+		std::vector<glm::vec3> uniquePositions;
+		std::vector<uint32_t> firstVertices;
+		uniquePositions.reserve(vertexCount);
+
+		for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			uint32_t uniqueIndex = positionTable.weld(vertexPositions[vertex], uniquePositions);
+			if (uniqueIndex == firstVertices.size())
+			{
+				firstVertices.push_back(vertex);
+			}
+
+			uint32_t first = firstVertices[uniqueIndex];
+			positionRemap[vertex] = first;
+			if (first == vertex)
+			{
+				siblings[vertex] = vertex;
+			}
+			else
+			{
+				siblings[vertex] = siblings[first];
+				siblings[first] = vertex;
+			}
+		}
+	}
+
+	TriangleAdjacency adjacency;
+	adjacency.build(result.data(), result.size(), vertexCount);
+
+	// Classify the vertices based on their open edges, an entry pointing back at the vertex itself means there are several
+	std::vector<uint32_t> openIncoming(vertexCount, invalidVertex);
+	std::vector<uint32_t> openOutgoing(vertexCount, invalidVertex);
+	for (size_t i = 0; i < result.size(); ++i)
+	{
+		uint32_t from = result[i];
+		uint32_t to = result[i - i % 3 + (i + 1) % 3];
+		if (!hasEdge(adjacency, result.data(), to, from))
+		{
+			openOutgoing[from] = openOutgoing[from] == invalidVertex ? to : from;
+			openIncoming[to] = openIncoming[to] == invalidVertex ? from : to;
+		}
+	}
+
+	auto hasSingleOpenEdge = [&](uint32_t vertex) {
+		return openIncoming[vertex] != invalidVertex && openIncoming[vertex] != vertex && openOutgoing[vertex] != invalidVertex && openOutgoing[vertex] != vertex;
+	};
+
+	std::vector<VertexKind> kinds(vertexCount, VertexKind::Locked);
+	for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+	{
+		uint32_t sibling = siblings[vertex];
+		if (sibling == vertex)
+		{
+			if (openIncoming[vertex] == invalidVertex && openOutgoing[vertex] == invalidVertex)
+			{
+				kinds[vertex] = VertexKind::Manifold;
+			}
+			else if (hasSingleOpenEdge(vertex))
+			{
+				kinds[vertex] = VertexKind::Border;
+			}
+		}
+		else if (siblings[sibling] == vertex && hasSingleOpenEdge(vertex) && hasSingleOpenEdge(sibling))
+		{
+			// Both halves of a seam have one open edge coming in and going out, and they must run along the same positions in opposite directions
+			if (positionRemap[openIncoming[vertex]] == positionRemap[openOutgoing[sibling]] &&
+				positionRemap[openOutgoing[vertex]] == positionRemap[openIncoming[sibling]])
+			{
+				kinds[vertex] = VertexKind::Seam;
+			}
+		}
+	}
+
+	// Build the quadrics from the planes of the triangles, weighted by area, and from planes pinning the open edges
+	std::vector<Quadric> quadrics(vertexCount);
+	for (size_t i = 0; i < result.size(); i += 3)
+	{
+		const glm::vec3 &p0 = vertexPositions[result[i + 0]];
+		const glm::vec3 &p1 = vertexPositions[result[i + 1]];
+		const glm::vec3 &p2 = vertexPositions[result[i + 2]];
+
+		glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+		float area = glm::length(normal);
+		if (area == 0.0f)
+		{
+			continue;
+		}
+		normal /= area;
+
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			quadrics[positionRemap[result[i + corner]]].addPlane(normal, -glm::dot(normal, p0), area);
+		}
+
+		for (uint32_t corner = 0; corner < 3; ++corner)
+		{
+			uint32_t from = result[i + corner];
+			uint32_t to = result[i + (corner + 1) % 3];
+			if (kinds[from] == VertexKind::Manifold || kinds[from] == VertexKind::Locked || openOutgoing[from] != to)
+			{
+				continue;
+			}
+
+			glm::vec3 edge = vertexPositions[to] - vertexPositions[from];
+			float length = glm::length(edge);
+			glm::vec3 edgeNormal = glm::cross(edge, normal);
+			float edgeNormalLength = glm::length(edgeNormal);
+			if (edgeNormalLength == 0.0f)
+			{
+				continue;
+			}
+			edgeNormal /= edgeNormalLength;
+
+			float distance = -glm::dot(edgeNormal, vertexPositions[from]);
+			quadrics[positionRemap[from]].addPlane(edgeNormal, distance, length * borderPlaneWeight);
+			quadrics[positionRemap[to]].addPlane(edgeNormal, distance, length * borderPlaneWeight);
+		}
+	}
+
+	// The sibling of a seam vertex has to collapse onto the sibling of the target that continues the seam on its side
+	auto findSeamTarget = [&](uint32_t sibling, uint32_t target) {
+		uint32_t candidate = target;
+		do
+		{
+			if (isOpenEdge(adjacency, result.data(), sibling, candidate))
+			{
+				return candidate;
+			}
+			candidate = siblings[candidate];
+		} while (candidate != target);
+
+		return invalidVertex;
+	};
+
+	auto canCollapse = [&](uint32_t from, uint32_t to) {
+		switch (kinds[from])
+		{
+		case VertexKind::Manifold:
+			return !hasTriangleFlip(adjacency, result.data(), vertexPositions, from, to);
+		case VertexKind::Border:
+			return isOpenEdge(adjacency, result.data(), from, to) && !hasTriangleFlip(adjacency, result.data(), vertexPositions, from, to);
+		case VertexKind::Seam:
+		{
+			if (!isOpenEdge(adjacency, result.data(), from, to) || hasTriangleFlip(adjacency, result.data(), vertexPositions, from, to))
+			{
+				return false;
+			}
+			uint32_t sibling = siblings[from];
+			uint32_t siblingTarget = findSeamTarget(sibling, to);
+			return siblingTarget != invalidVertex && !hasTriangleFlip(adjacency, result.data(), vertexPositions, sibling, siblingTarget);
+		}
+		default:
+			return false;
+		}
+	};
+
+	const float targetErrorSquared{ targetError < std::sqrt(FLT_MAX) ? targetError * targetError : FLT_MAX };
+	float resultErrorSquared{ 0.0f };
+
+	std::vector<Collapse> collapses;
+	std::vector<uint32_t> collapseRemap(vertexCount);
+	std::vector<bool> collapseLocked(vertexCount);
+
+	while (result.size() > targetIndexCount)
+	{
+		// Pick the cheapest direction of every collapsible edge, collapses that would flip a triangle are filtered out here so they can't hold up the pass error limit
+		collapses.clear();
+		for (size_t i = 0; i < result.size(); ++i)
+		{
+			uint32_t a = result[i];
+			uint32_t b = result[i - i % 3 + (i + 1) % 3];
+
+			// Shared edges are seen from both triangles, only consider them once
+			if (a > b && hasEdge(adjacency, result.data(), b, a))
+			{
+				continue;
+			}
+
+			bool collapseA = canCollapse(a, b);
+			bool collapseB = canCollapse(b, a);
+			if (!collapseA && !collapseB)
+			{
+				continue;
+			}
+
+			float errorA = collapseA ? quadrics[positionRemap[a]].evaluate(vertexPositions[b]) : FLT_MAX;
+			float errorB = collapseB ? quadrics[positionRemap[b]].evaluate(vertexPositions[a]) : FLT_MAX;
+			collapses.push_back(errorA <= errorB ? Collapse{ a, b, errorA } : Collapse{ b, a, errorB });
+		}
+
+		if (collapses.empty())
+		{
+			break;
+		}
+
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse &lhs, const Collapse &rhs) { return lhs.error < rhs.error; });
+
+		// Most collapses remove two triangles, aim for half the remaining goal in edges so the pass doesn't overshoot the target
+		const size_t triangleCollapseGoal{ (result.size() - targetIndexCount) / 3 };
+		const size_t edgeCollapseGoal{ std::max<size_t>(triangleCollapseGoal / 2, 1) };
+		const float goalError{ edgeCollapseGoal < collapses.size() ? collapses[edgeCollapseGoal].error : collapses.back().error };
+		const float passErrorLimit{ std::min(goalError * passErrorSlack, targetErrorSquared) };
+
+		for (uint32_t vertex = 0; vertex < vertexCount; ++vertex)
+		{
+			collapseRemap[vertex] = vertex;
+		}
+		std::fill(collapseLocked.begin(), collapseLocked.end(), false);
+
+		size_t triangleCollapses{ 0 };
+		size_t edgeCollapses{ 0 };
+		for (const Collapse &collapse : collapses)
+		{
+			if (collapse.error > passErrorLimit || triangleCollapses >= triangleCollapseGoal)
+			{
+				break;
+			}
+
+			const uint32_t from{ collapse.from };
+			const uint32_t to{ collapse.to };
+			const uint32_t fromPosition{ positionRemap[from] };
+			const uint32_t toPosition{ positionRemap[to] };
+
+			// Every vertex is touched by at most one collapse per pass so the errors computed above stay accurate
+			if (collapseLocked[fromPosition] || collapseLocked[toPosition])
+			{
+				continue;
+			}
+
+			if (kinds[from] == VertexKind::Seam)
+			{
+				uint32_t sibling = siblings[from];
+				collapseRemap[sibling] = findSeamTarget(sibling, to);
+			}
+			collapseRemap[from] = to;
+
+			quadrics[toPosition].add(quadrics[fromPosition]);
+			collapseLocked[fromPosition] = true;
+			collapseLocked[toPosition] = true;
+
+			triangleCollapses += kinds[from] == VertexKind::Border ? 1 : 2;
+			++edgeCollapses;
+			resultErrorSquared = std::max(resultErrorSquared, collapse.error);
+		}
+
+		if (edgeCollapses == 0)
+		{
+			break;
+		}
+
+		// Apply the collapses and drop the triangles that became degenerate
+		size_t writeIndex{ 0 };
+		for (size_t i = 0; i < result.size(); i += 3)
+		{
+			uint32_t a = collapseRemap[result[i + 0]];
+			uint32_t b = collapseRemap[result[i + 1]];
+			uint32_t c = collapseRemap[result[i + 2]];
+			if (a != b && a != c && b != c)
+			{
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+		}
+		result.resize(writeIndex);
+
+		adjacency.build(result.data(), result.size(), vertexCount);
+	}
+
+	std::copy(result.begin(), result.end(), destination);
+
+	if (resultError)
+	{
+		*resultError = std::sqrt(resultErrorSquared);
+	}
+
+	return result.size();
+}
+
+} // namespace vulkr
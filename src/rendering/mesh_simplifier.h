@@ -0,0 +1,56 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace vulkr
+{
+
+/**
+ * Simplifies a triangle list by collapsing edges in order of their quadric error. Vertices are only ever collapsed onto other existing vertices,
+ * so the result references a subset of the original vertices and can share their vertex buffer.
+ * Open borders and attribute seams (vertices split because of differing normals or texture coordinates) are preserved by only collapsing
+ * vertices on them along the border or seam, and collapses that would flip a triangle are rejected.
+ * @param destination Receives the simplified triangle list, must have room for indexCount indices and may be the same as indices
+ * @param positions Pointer to the x component of the first vertex position
+ * @param positionStride The amount of bytes between two vertex positions
+ * @param targetIndexCount Simplification stops once the triangle list is at most this size
+ * @param targetError Simplification also stops before any vertex would move further than this distance, in the units of the positions
+ * @param resultError Optionally receives the largest distance a vertex was moved by, in the units of the positions
+ * @return The amount of indices written to destination
+ */
+size_t simplifyMesh(
+	uint32_t *destination,
+	const uint32_t *indices,
+	size_t indexCount,
+	const float *positions,
+	size_t vertexCount,
+	size_t positionStride,
+	size_t targetIndexCount,
+	float targetError,
+	float *resultError = nullptr
+);
+
+} // namespace vulkr
@@ -0,0 +1,136 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mipmap_generator.h"
+#include "common/helpers.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace vulkr
+{
+
+namespace
+{
+
+// Resolution of the linear to sRGB table, fine enough that every 8 bit sRGB value round trips exactly
+constexpr uint32_t linearToSrgbTableSize{ 4096 };
+
+struct SrgbTables
+{
+	std::array<float, 256> toLinear;
+	std::array<uint8_t, linearToSrgbTableSize + 1> fromLinear;
+
+	SrgbTables()
+	{
+		for (uint32_t i = 0; i < toLinear.size(); ++i)
+		{
+			float value = static_cast<float>(i) / 255.0f;
+			toLinear[i] = value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+		}
+
+		for (uint32_t i = 0; i < fromLinear.size(); ++i)
+		{
+			float value = static_cast<float>(i) / static_cast<float>(linearToSrgbTableSize);
+			float encoded = value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+			fromLinear[i] = static_cast<uint8_t>(std::lround(std::clamp(encoded, 0.0f, 1.0f) * 255.0f));
+		}
+	}
+};
+
+const SrgbTables &getSrgbTables()
+{
+	static const SrgbTables tables;
+	return tables;
+}
+
+/* Halves a level like a linear blit between the level extents would, the last row or column of an odd size is dropped and a size of 1 is clamped */
+void downsample(const uint8_t *source, uint32_t sourceWidth, uint32_t sourceHeight, uint8_t *destination, uint32_t width, uint32_t height, bool srgb)
+{
+	const SrgbTables &tables = getSrgbTables();
+
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		const uint8_t *row0 = source + static_cast<size_t>(std::min(y * 2, sourceHeight - 1)) * sourceWidth * 4;
+		const uint8_t *row1 = source + static_cast<size_t>(std::min(y * 2 + 1, sourceHeight - 1)) * sourceWidth * 4;
+		uint8_t *output = destination + static_cast<size_t>(y) * width * 4;
+
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			const uint32_t x0{ std::min(x * 2, sourceWidth - 1) * 4 };
+			const uint32_t x1{ std::min(x * 2 + 1, sourceWidth - 1) * 4 };
+
+			for (uint32_t channel = 0; channel < 3; ++channel)
+			{
+				if (srgb)
+				{
+					float sum = tables.toLinear[row0[x0 + channel]] + tables.toLinear[row0[x1 + channel]] + tables.toLinear[row1[x0 + channel]] + tables.toLinear[row1[x1 + channel]];
+					output[x * 4 + channel] = tables.fromLinear[static_cast<uint32_t>(sum * (linearToSrgbTableSize / 4.0f) + 0.5f)];
+				}
+				else
+				{
+					output[x * 4 + channel] = static_cast<uint8_t>((row0[x0 + channel] + row0[x1 + channel] + row1[x0 + channel] + row1[x1 + channel] + 2u) / 4u);
+				}
+			}
+
+			// Alpha is always linear
+			output[x * 4 + 3] = static_cast<uint8_t>((row0[x0 + 3] + row0[x1 + 3] + row1[x0 + 3] + row1[x1 + 3] + 2u) / 4u);
+		}
+	}
+}
+
+} // namespace
+
+std::vector<uint8_t> generateMipChainRGBA8(const uint8_t *pixels, uint32_t width, uint32_t height, bool srgb, std::vector<MipLevel> &levels)
+{
+	const uint32_t levelCount{ getMipLevelCount(width, height) };
+
+	levels.clear();
+	levels.reserve(levelCount);
+
+	size_t totalSize{ 0 };
+	uint32_t levelWidth{ width };
+	uint32_t levelHeight{ height };
+	for (uint32_t level = 0; level < levelCount; ++level)
+	{
+		levels.push_back({ totalSize, levelWidth, levelHeight });
+		totalSize += static_cast<size_t>(levelWidth) * levelHeight * 4;
+
+		levelWidth = std::max(levelWidth / 2, 1u);
+		levelHeight = std::max(levelHeight / 2, 1u);
+	}
+
+	std::vector<uint8_t> data(totalSize);
+	std::copy(pixels, pixels + static_cast<size_t>(width) * height * 4, data.begin());
+
+	for (uint32_t level = 1; level < levelCount; ++level)
+	{
+		const MipLevel &source = levels[level - 1];
+		const MipLevel &destination = levels[level];
+		downsample(data.data() + source.offset, source.width, source.height, data.data() + destination.offset, destination.width, destination.height, srgb);
+	}
+
+	return data;
+}
+
+} // namespace vulkr
@@ -0,0 +1,48 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vulkr
+{
+
+/* Location of a level inside a packed mip chain */
+struct MipLevel
+{
+	size_t offset;
+	uint32_t width;
+	uint32_t height;
+};
+
+/**
+ * Generates the full mip chain of an RGBA8 image on the CPU with a 2x2 box filter, for formats the GPU can't blit with linear filtering
+ * @param srgb Whether the colour channels are sRGB encoded, in which case they are filtered in linear space
+ * @param levels Receives the location of every level inside the returned data, the first level is a copy of the source image
+ * @return Every level of the chain packed one after the other
+ */
+std::vector<uint8_t> generateMipChainRGBA8(const uint8_t *pixels, uint32_t width, uint32_t height, bool srgb, std::vector<MipLevel> &levels);
+
+} // namespace vulkr
@@ -0,0 +1,521 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "obj_loader.h"
+#include "common/mapped_file.h"
+#include "common/logger.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include <tiny_obj_loader.h>
+
+namespace vulkr
+{
+
+namespace
+{
+
+// Files smaller than this are not worth splitting across threads
+constexpr size_t minimumChunkSize{ 512 * 1024 };
+
+// The largest power of ten that is exactly representable as a double is 10^22
+constexpr double exactPowersOfTen[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Set on a face corner attribute whose index was negative (relative to the attributes defined so far) and still needs the offset of the preceding chunks
+enum RelativeIndexFlags : uint8_t
+{
+	RelativePosition = 1 << 0,
+	RelativeTexcoord = 1 << 1,
+	RelativeNormal = 1 << 2
+};
+
+struct ObjChunk
+{
+	const char *begin{ nullptr };
+	const char *end{ nullptr };
+
+	std::vector<float> positions;
+	std::vector<float> normals;
+	std::vector<float> texcoords;
+	std::vector<ObjIndex> indices;
+	std::vector<uint8_t> relativeFlags;
+
+	bool valid{ true };
+};
+
+inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+inline bool isWhitespace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+inline const char *skipWhitespace(const char *p, const char *end)
+{
+	while (p < end && isWhitespace(*p))
+	{
+		++p;
+	}
+	return p;
+}
+
+void parseFloats(const char *p, const char *end, size_t count, std::vector<float> &output)
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		p = skipWhitespace(p, end);
+
+		// Missing components (e.g. a vt record with only a u coordinate) default to zero
+		float value{ 0.0f };
+		p = parseFloat(p, end, value);
+		output.push_back(value);
+	}
+}
+
+/* Parses a single v, v/vt, v//vn or v/vt/vn index, resolving it against the amount of attributes the chunk has seen so far */
+const char *parseIndex(const char *p, const char *end, int32_t localCount, int32_t &index, bool &relative, bool &valid)
+{
+	bool negative{ false };
+	if (p < end && *p == '-')
+	{
+		negative = true;
+		++p;
+	}
+
+	int32_t value{ 0 };
+	const char *digits = p;
+	while (p < end && isDigit(*p))
+	{
+		value = value * 10 + (*p - '0');
+		++p;
+	}
+
+	if (p == digits || value == 0)
+	{
+		valid = false;
+		return p;
+	}
+
+	if (negative)
+	{
+		index = localCount - value;
+		relative = true;
+	}
+	else
+	{
+		index = value - 1;
+		relative = false;
+	}
+
+	return p;
+}
+
+void parseFace(const char *p, const char *end, ObjChunk &chunk, std::vector<ObjIndex> &corners, std::vector<uint8_t> &cornerFlags)
+{
+	corners.clear();
+	cornerFlags.clear();
+
+	const int32_t positionCount{ static_cast<int32_t>(chunk.positions.size() / 3) };
+	const int32_t texcoordCount{ static_cast<int32_t>(chunk.texcoords.size() / 2) };
+	const int32_t normalCount{ static_cast<int32_t>(chunk.normals.size() / 3) };
+
+	p = skipWhitespace(p, end);
+	while (p < end)
+	{
+		ObjIndex corner{};
+		uint8_t flags{ 0 };
+		bool relative{ false };
+
+		p = parseIndex(p, end, positionCount, corner.position, relative, chunk.valid);
+		flags |= relative ? RelativePosition : 0;
+
+		if (p < end && *p == '/')
+		{
+			++p;
+			if (p < end && *p != '/')
+			{
+				p = parseIndex(p, end, texcoordCount, corner.texcoord, relative, chunk.valid);
+				flags |= relative ? RelativeTexcoord : 0;
+			}
+
+			if (p < end && *p == '/')
+			{
+				++p;
+				p = parseIndex(p, end, normalCount, corner.normal, relative, chunk.valid);
+				flags |= relative ? RelativeNormal : 0;
+			}
+		}
+
+		if (!chunk.valid)
+		{
+			return;
+		}
+
+		corners.push_back(corner);
+		cornerFlags.push_back(flags);
+
+		p = skipWhitespace(p, end);
+	}
+
+	// Fan triangulation, matching the triangulation done by tinyobjloader
+	for (size_t i = 2; i < corners.size(); ++i)
+	{
+		chunk.indices.push_back(corners[0]);
+		chunk.indices.push_back(corners[i - 1]);
+		chunk.indices.push_back(corners[i]);
+		chunk.relativeFlags.push_back(cornerFlags[0]);
+		chunk.relativeFlags.push_back(cornerFlags[i - 1]);
+		chunk.relativeFlags.push_back(cornerFlags[i]);
+	}
+}
+
+void parseChunk(ObjChunk &chunk)
+{
+	std::vector<ObjIndex> corners;
+	std::vector<uint8_t> cornerFlags;
+
+	const char *p = chunk.begin;
+	while (p < chunk.end && chunk.valid)
+	{
+		const char *lineEnd = static_cast<const char *>(memchr(p, '\n', chunk.end - p));
+		if (!lineEnd)
+		{
+			lineEnd = chunk.end;
+		}
+
+		p = skipWhitespace(p, lineEnd);
+		if (lineEnd - p >= 2)
+		{
+			if (p[0] == 'v' && isWhitespace(p[1]))
+			{
+				parseFloats(p + 2, lineEnd, 3, chunk.positions);
+			}
+			else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 'n' && isWhitespace(p[2]))
+			{
+				parseFloats(p + 3, lineEnd, 3, chunk.normals);
+			}
+			else if (lineEnd - p >= 3 && p[0] == 'v' && p[1] == 't' && isWhitespace(p[2]))
+			{
+				parseFloats(p + 3, lineEnd, 2, chunk.texcoords);
+			}
+			else if (p[0] == 'f' && isWhitespace(p[1]))
+			{
+				parseFace(p + 2, lineEnd, chunk, corners, cornerFlags);
+			}
+		}
+
+		p = lineEnd + 1;
+	}
+}
+
+/* Resolve the chunk's indices to file wide indices and copy its attributes into the merged arrays */
+void mergeChunk(ObjChunk &chunk, ObjData &data, size_t positionOffset, size_t normalOffset, size_t texcoordOffset, size_t indexOffset)
+{
+	std::copy(chunk.positions.begin(), chunk.positions.end(), data.positions.begin() + positionOffset * 3);
+	std::copy(chunk.normals.begin(), chunk.normals.end(), data.normals.begin() + normalOffset * 3);
+	std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), data.texcoords.begin() + texcoordOffset * 2);
+
+	const int64_t positionCount{ static_cast<int64_t>(data.positions.size() / 3) };
+	const int64_t normalCount{ static_cast<int64_t>(data.normals.size() / 3) };
+	const int64_t texcoordCount{ static_cast<int64_t>(data.texcoords.size() / 2) };
+
+	auto resolve = [&chunk](int32_t &index, bool relative, size_t offset, int64_t count)
+	{
+		if (index < 0 && !relative)
+		{
+			// The attribute isn't referenced by this face corner
+			return;
+		}
+
+		int64_t resolved{ relative ? static_cast<int64_t>(offset) + index : index };
+		if (resolved < 0 || resolved >= count)
+		{
+			chunk.valid = false;
+			return;
+		}
+		index = static_cast<int32_t>(resolved);
+	};
+
+	for (size_t i = 0; i < chunk.indices.size(); ++i)
+	{
+		ObjIndex index = chunk.indices[i];
+		uint8_t flags = chunk.relativeFlags[i];
+
+		resolve(index.position, (flags & RelativePosition) != 0, positionOffset, positionCount);
+		resolve(index.texcoord, (flags & RelativeTexcoord) != 0, texcoordOffset, texcoordCount);
+		resolve(index.normal, (flags & RelativeNormal) != 0, normalOffset, normalCount);
+
+		data.indices[indexOffset + i] = index;
+	}
+}
+
+} // namespace
+
+const char *parseFloat(const char *begin, const char *end, float &value)
+{
+	const char *p = begin;
+
+	bool negative{ false };
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		++p;
+	}
+
+	// Accumulate up to 19 significant digits, which always fit in 64 bits
+	uint64_t mantissa{ 0 };
+	int32_t exponent{ 0 };
+	int32_t significantDigits{ 0 };
+	bool truncated{ false };
+	bool hasDigits{ false };
+
+	while (p < end && isDigit(*p))
+	{
+		hasDigits = true;
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+			significantDigits += mantissa != 0 ? 1 : 0;
+		}
+		else
+		{
+			truncated = true;
+			++exponent;
+		}
+		++p;
+	}
+
+	if (p < end && *p == '.')
+	{
+		++p;
+		while (p < end && isDigit(*p))
+		{
+			hasDigits = true;
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+				significantDigits += mantissa != 0 ? 1 : 0;
+				--exponent;
+			}
+			else
+			{
+				truncated = true;
+			}
+			++p;
+		}
+	}
+
+	if (!hasDigits)
+	{
+		return begin;
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char *q = p + 1;
+		bool negativeExponent{ false };
+		if (q < end && (*q == '-' || *q == '+'))
+		{
+			negativeExponent = *q == '-';
+			++q;
+		}
+
+		if (q < end && isDigit(*q))
+		{
+			int32_t explicitExponent{ 0 };
+			while (q < end && isDigit(*q))
+			{
+				// Clamp so absurd exponents can't overflow, they end up as zero or infinity regardless
+				if (explicitExponent < 100000)
+				{
+					explicitExponent = explicitExponent * 10 + (*q - '0');
+				}
+				++q;
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			p = q;
+		}
+	}
+
+	if (mantissa == 0)
+	{
+		value = negative ? -0.0f : 0.0f;
+		return p;
+	}
+
+	// When both the mantissa and the power of ten are exact doubles a single multiplication or division is correctly rounded
+	if (!truncated && mantissa <= (uint64_t{ 1 } << 53) && exponent >= -22 && exponent <= 22)
+	{
+		double result = static_cast<double>(mantissa);
+		result = exponent < 0 ? result / exactPowersOfTen[-exponent] : result * exactPowersOfTen[exponent];
+		value = static_cast<float>(negative ? -result : result);
+		return p;
+	}
+
+	// Rare slow path for numbers with very long mantissas or large exponents
+	std::string number{ begin, p };
+	value = static_cast<float>(std::strtod(number.c_str(), nullptr));
+	return p;
+}
+
+bool loadObjFile(const std::string &filename, ObjData &data, uint32_t threadCount)
+{
+	MappedFile file{ filename };
+	if (!file.isMapped())
+	{
+		LOGW("Failed to open {}", filename);
+		return false;
+	}
+
+	data = ObjData{};
+
+	const char *fileBegin = file.getData();
+	const char *fileEnd = fileBegin + file.getSize();
+
+	if (threadCount == 0u)
+	{
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+	size_t chunkCount = std::min<size_t>(threadCount, std::max<size_t>(file.getSize() / minimumChunkSize, 1u));
+
+	// Split the file into roughly equal chunks, moving each split point forward to the start of the next line
+	std::vector<ObjChunk> chunks(chunkCount);
+	const char *chunkBegin = fileBegin;
+	for (size_t i = 0; i < chunkCount; ++i)
+	{
+		const char *chunkEnd = fileEnd;
+		if (i + 1 < chunkCount)
+		{
+			chunkEnd = std::max(chunkBegin, fileBegin + file.getSize() / chunkCount * (i + 1));
+			const char *newline = static_cast<const char *>(memchr(chunkEnd, '\n', fileEnd - chunkEnd));
+			chunkEnd = newline ? newline + 1 : fileEnd;
+		}
+
+		chunks[i].begin = chunkBegin;
+		chunks[i].end = chunkEnd;
+		chunkBegin = chunkEnd;
+	}
+
+	// The calling thread parses the first chunk while the workers handle the rest
+	std::vector<std::thread> workers;
+	workers.reserve(chunkCount - 1);
+	for (size_t i = 1; i < chunkCount; ++i)
+	{
+		workers.emplace_back(parseChunk, std::ref(chunks[i]));
+	}
+	parseChunk(chunks[0]);
+	for (std::thread &worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+
+	size_t positionCount{ 0 }, normalCount{ 0 }, texcoordCount{ 0 }, indexCount{ 0 };
+	std::vector<size_t> positionOffsets(chunkCount), normalOffsets(chunkCount), texcoordOffsets(chunkCount), indexOffsets(chunkCount);
+	for (size_t i = 0; i < chunkCount; ++i)
+	{
+		if (!chunks[i].valid)
+		{
+			LOGW("{} contains a malformed face", filename);
+			return false;
+		}
+
+		positionOffsets[i] = positionCount;
+		normalOffsets[i] = normalCount;
+		texcoordOffsets[i] = texcoordCount;
+		indexOffsets[i] = indexCount;
+
+		positionCount += chunks[i].positions.size() / 3;
+		normalCount += chunks[i].normals.size() / 3;
+		texcoordCount += chunks[i].texcoords.size() / 2;
+		indexCount += chunks[i].indices.size();
+	}
+
+	data.positions.resize(positionCount * 3);
+	data.normals.resize(normalCount * 3);
+	data.texcoords.resize(texcoordCount * 2);
+	data.indices.resize(indexCount);
+
+	for (size_t i = 1; i < chunkCount; ++i)
+	{
+		workers.emplace_back(mergeChunk, std::ref(chunks[i]), std::ref(data), positionOffsets[i], normalOffsets[i], texcoordOffsets[i], indexOffsets[i]);
+	}
+	mergeChunk(chunks[0], data, positionOffsets[0], normalOffsets[0], texcoordOffsets[0], indexOffsets[0]);
+	for (std::thread &worker : workers)
+	{
+		worker.join();
+	}
+
+	for (const ObjChunk &chunk : chunks)
+	{
+		if (!chunk.valid)
+		{
+			LOGW("{} references a vertex attribute that doesn't exist", filename);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool loadObjFileWithTinyObj(const std::string &filename, ObjData &data)
+{
+	tinyobj::attrib_t attrib;
+	std::vector<tinyobj::shape_t> shapes;
+	std::vector<tinyobj::material_t> materials;
+	std::string warn;
+	std::string err;
+
+	if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, filename.c_str(), nullptr))
+	{
+		LOGW("tinyobjloader failed to load {}: {}", filename, err);
+		return false;
+	}
+
+	data.positions = std::move(attrib.vertices);
+	data.normals = std::move(attrib.normals);
+	data.texcoords = std::move(attrib.texcoords);
+	data.indices.clear();
+
+	// The shapes are in file order, so concatenating their faces gives the face order of the parallel loader
+	for (const tinyobj::shape_t &shape : shapes)
+	{
+		for (const tinyobj::index_t &index : shape.mesh.indices)
+		{
+			data.indices.push_back(ObjIndex{ index.vertex_index, index.texcoord_index, index.normal_index });
+		}
+	}
+
+	return true;
+}
+
+} // namespace vulkr
@@ -0,0 +1,77 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vulkr
+{
+
+/* Zero based indices into the attribute arrays of an ObjData, -1 when the face corner doesn't reference that attribute */
+struct ObjIndex
+{
+	int32_t position{ -1 };
+	int32_t texcoord{ -1 };
+	int32_t normal{ -1 };
+};
+
+/* The geometry of an OBJ file with every face fan-triangulated, in file order */
+struct ObjData
+{
+	std::vector<float> positions; // xyz
+	std::vector<float> normals; // xyz
+	std::vector<float> texcoords; // uv
+	std::vector<ObjIndex> indices; // Three corners per triangle
+};
+
+/**
+ * Parses the v, vn, vt and f records of an OBJ file; all other records (groups, materials, smoothing groups, lines and points) are ignored.
+ * The file is memory mapped and split into chunks on line boundaries which are parsed concurrently and then merged in file order,
+ * so the result is identical to a sequential parse.
+ * @param filename The path to the OBJ file
+ * @param data Filled in with the parsed geometry
+ * @param threadCount The amount of threads to parse with, 0 uses every hardware thread
+ * @return False if the file couldn't be opened or references attributes that don't exist
+ */
+bool loadObjFile(const std::string &filename, ObjData &data, uint32_t threadCount = 0u);
+
+/**
+ * Parses an OBJ file with tinyobjloader into the same form as loadObjFile, which the parallel loader is validated and timed against
+ * @param filename The path to the OBJ file
+ * @param data Filled in with the parsed geometry
+ * @return False if tinyobjloader failed to parse the file
+ */
+bool loadObjFileWithTinyObj(const std::string &filename, ObjData &data);
+
+/**
+ * Parses a decimal floating point number such as those found in OBJ files
+ * @param begin The first character to parse, leading whitespace is not skipped
+ * @param end One past the last readable character
+ * @param value Set to the parsed value
+ * @return The first character after the number, begin if no number could be parsed
+ */
+const char *parseFloat(const char *begin, const char *end, float &value);
+
+} // namespace vulkr
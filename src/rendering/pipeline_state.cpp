@@ -98,7 +98,7 @@ const ColorBlendState &PipelineState::getColorBlendState() const
 	return colorBlendState;
 }
 
-const std::array<VkDynamicState, 9>  &PipelineState::getDyanmicStates() const
+const std::vector<VkDynamicState> &PipelineState::getDyanmicStates() const
 {
 	return dynamicStates;
 }
@@ -22,7 +22,7 @@
 
 #pragma once
 
-#include <array>
+#include <vector>
 
 #include "common/vulkan_common.h"
 
@@ -176,7 +176,7 @@ public:
 
 	const ColorBlendState &getColorBlendState() const;
 
-	const std::array<VkDynamicState, 9> &getDyanmicStates() const;
+	const std::vector<VkDynamicState> &getDyanmicStates() const;
 
 	uint32_t getSubpassIndex() const;
 private:
@@ -198,16 +198,10 @@ private:
 
 	ColorBlendState colorBlendState{};
 
-	std::array<VkDynamicState, 9> dynamicStates{
+	// Only the size dependent states are dynamic so that pipelines survive a swapchain resize, the viewports and scissors in the viewport state only provide their counts
+	std::vector<VkDynamicState> dynamicStates{
 		VK_DYNAMIC_STATE_VIEWPORT,
-		VK_DYNAMIC_STATE_SCISSOR,
-		VK_DYNAMIC_STATE_LINE_WIDTH,
-		VK_DYNAMIC_STATE_DEPTH_BIAS,
-		VK_DYNAMIC_STATE_BLEND_CONSTANTS,
-		VK_DYNAMIC_STATE_DEPTH_BOUNDS,
-		VK_DYNAMIC_STATE_STENCIL_COMPARE_MASK,
-		VK_DYNAMIC_STATE_STENCIL_WRITE_MASK,
-		VK_DYNAMIC_STATE_STENCIL_REFERENCE
+		VK_DYNAMIC_STATE_SCISSOR
 	};
 
 	uint32_t subpassIndex{ 0u }; // TODO do we need this, currently unused
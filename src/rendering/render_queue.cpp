@@ -0,0 +1,173 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "render_queue.h"
+
+#include <algorithm>
+#include <array>
+
+namespace vulkr
+{
+
+static constexpr uint32_t DEPTH_SHIFT{ 0 };
+static constexpr uint32_t MESH_SHIFT{ DEPTH_SHIFT + RenderQueue::DEPTH_BITS };
+static constexpr uint32_t MATERIAL_SHIFT{ MESH_SHIFT + RenderQueue::MESH_BITS };
+static constexpr uint32_t PIPELINE_SHIFT{ MATERIAL_SHIFT + RenderQueue::MATERIAL_BITS };
+static constexpr uint32_t PASS_SHIFT{ PIPELINE_SHIFT + RenderQueue::PIPELINE_BITS };
+
+static_assert(PASS_SHIFT + RenderQueue::PASS_BITS == 64, "The sort key fields must fill exactly 64 bits");
+
+static constexpr uint64_t getFieldMask(uint32_t bitCount)
+{
+	return (uint64_t{ 1 } << bitCount) - 1;
+}
+
+uint64_t RenderQueue::makeSortKey(RenderPassType pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, float depth)
+{
+	const uint64_t quantizedDepth = static_cast<uint64_t>(std::clamp(depth, 0.0f, 1.0f) * static_cast<float>(getFieldMask(DEPTH_BITS)));
+
+	return ((static_cast<uint64_t>(pass) & getFieldMask(PASS_BITS)) << PASS_SHIFT) |
+		((static_cast<uint64_t>(pipelineId) & getFieldMask(PIPELINE_BITS)) << PIPELINE_SHIFT) |
+		((static_cast<uint64_t>(materialId) & getFieldMask(MATERIAL_BITS)) << MATERIAL_SHIFT) |
+		((static_cast<uint64_t>(meshId) & getFieldMask(MESH_BITS)) << MESH_SHIFT) |
+		(quantizedDepth << DEPTH_SHIFT);
+}
+
+uint32_t RenderQueue::getPipelineId(uint64_t sortKey)
+{
+	return static_cast<uint32_t>((sortKey >> PIPELINE_SHIFT) & getFieldMask(PIPELINE_BITS));
+}
+
+uint32_t RenderQueue::getMaterialId(uint64_t sortKey)
+{
+	return static_cast<uint32_t>((sortKey >> MATERIAL_SHIFT) & getFieldMask(MATERIAL_BITS));
+}
+
+uint32_t RenderQueue::getMeshId(uint64_t sortKey)
+{
+	return static_cast<uint32_t>((sortKey >> MESH_SHIFT) & getFieldMask(MESH_BITS));
+}
+
+void RenderQueue::resize(uint32_t drawCount)
+{
+	sortKeys.resize(drawCount);
+	objectIndices.resize(drawCount);
+}
+
+void RenderQueue::setDraw(uint32_t drawIndex, uint64_t sortKey, uint32_t objectIndex)
+{
+	sortKeys[drawIndex] = sortKey;
+	objectIndices[drawIndex] = objectIndex;
+}
+
+void RenderQueue::sort()
+{
+	statistics = RenderQueueStatistics{};
+	statistics.drawCount = getDrawCount();
+	countStateChanges(statistics.unsortedPipelineChanges, statistics.unsortedMaterialChanges, statistics.unsortedMeshChanges);
+
+	const size_t drawCount = sortKeys.size();
+	scratchSortKeys.resize(drawCount);
+	scratchObjectIndices.resize(drawCount);
+
+	// Least significant digit first, one byte per pass; the histograms of every byte are built in a single read of the keys
+	constexpr uint32_t RADIX_BITS{ 8 };
+	constexpr uint32_t BUCKET_COUNT{ 1 << RADIX_BITS };
+	constexpr uint32_t PASS_COUNT{ 64 / RADIX_BITS };
+	std::array<std::array<uint32_t, BUCKET_COUNT>, PASS_COUNT> histograms{};
+	for (uint64_t sortKey : sortKeys)
+	{
+		for (uint32_t pass = 0; pass < PASS_COUNT; ++pass)
+		{
+			++histograms[pass][(sortKey >> (pass * RADIX_BITS)) & (BUCKET_COUNT - 1)];
+		}
+	}
+
+	for (uint32_t pass = 0; pass < PASS_COUNT; ++pass)
+	{
+		std::array<uint32_t, BUCKET_COUNT> &histogram = histograms[pass];
+
+		// Every key has the same byte here, so the pass wouldn't move anything; with few distinct ids most of the high bytes are skipped this way
+		if (std::find(histogram.begin(), histogram.end(), static_cast<uint32_t>(drawCount)) != histogram.end())
+		{
+			continue;
+		}
+
+		uint32_t offset{ 0 };
+		for (uint32_t &bucket : histogram)
+		{
+			uint32_t count = bucket;
+			bucket = offset;
+			offset += count;
+		}
+
+		for (size_t i = 0; i < drawCount; ++i)
+		{
+			uint32_t destination = histogram[(sortKeys[i] >> (pass * RADIX_BITS)) & (BUCKET_COUNT - 1)]++;
+			scratchSortKeys[destination] = sortKeys[i];
+			scratchObjectIndices[destination] = objectIndices[i];
+		}
+
+		sortKeys.swap(scratchSortKeys);
+		objectIndices.swap(scratchObjectIndices);
+	}
+
+	countStateChanges(statistics.pipelineChanges, statistics.materialChanges, statistics.meshChanges);
+}
+
+uint32_t RenderQueue::getDrawCount() const
+{
+	return static_cast<uint32_t>(sortKeys.size());
+}
+
+const std::vector<uint64_t> &RenderQueue::getSortKeys() const
+{
+	return sortKeys;
+}
+
+const std::vector<uint32_t> &RenderQueue::getObjectIndices() const
+{
+	return objectIndices;
+}
+
+const RenderQueueStatistics &RenderQueue::getStatistics() const
+{
+	return statistics;
+}
+
+void RenderQueue::countStateChanges(uint32_t &pipelineChanges, uint32_t &materialChanges, uint32_t &meshChanges) const
+{
+	pipelineChanges = 0;
+	materialChanges = 0;
+	meshChanges = 0;
+
+	for (size_t i = 0; i < sortKeys.size(); ++i)
+	{
+		// The first draw binds everything
+		bool first{ i == 0 };
+		pipelineChanges += first || getPipelineId(sortKeys[i]) != getPipelineId(sortKeys[i - 1]);
+		materialChanges += first || getMaterialId(sortKeys[i]) != getMaterialId(sortKeys[i - 1]);
+		meshChanges += first || getMeshId(sortKeys[i]) != getMeshId(sortKeys[i - 1]);
+	}
+}
+
+} // namespace vulkr
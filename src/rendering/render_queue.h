@@ -0,0 +1,103 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace vulkr
+{
+
+/* The passes draws are submitted in, in the order they are drawn */
+enum class RenderPassType : uint32_t
+{
+	Opaque = 0
+};
+
+/* How often the bound state changes while walking the draws, in submission order and in sorted order */
+struct RenderQueueStatistics
+{
+	uint32_t drawCount{ 0 };
+	uint32_t pipelineChanges{ 0 };
+	uint32_t materialChanges{ 0 };
+	uint32_t meshChanges{ 0 };
+	uint32_t unsortedPipelineChanges{ 0 };
+	uint32_t unsortedMaterialChanges{ 0 };
+	uint32_t unsortedMeshChanges{ 0 };
+};
+
+/*
+ * Draws described by a 64 bit sort key and the index of the object they draw. Sorting the keys groups the draws that share a pass, pipeline,
+ * material and mesh (in that order of importance) and orders them front to back within a group, so state changes can be driven from the sorted stream.
+ * Key layout from the most significant bit: pass (4) | pipeline id (10) | material id (14) | mesh id (16) | depth (20)
+ */
+class RenderQueue
+{
+public:
+	static constexpr uint32_t PASS_BITS{ 4 };
+	static constexpr uint32_t PIPELINE_BITS{ 10 };
+	static constexpr uint32_t MATERIAL_BITS{ 14 };
+	static constexpr uint32_t MESH_BITS{ 16 };
+	static constexpr uint32_t DEPTH_BITS{ 20 };
+
+	RenderQueue() = default;
+	~RenderQueue() = default;
+
+	/**
+	 * Pack a draw into a sort key, the ids must fit in their number of bits
+	 * @param depth The distance to the camera normalized to [0, 1], it's clamped and quantized to DEPTH_BITS
+	 */
+	static uint64_t makeSortKey(RenderPassType pass, uint32_t pipelineId, uint32_t materialId, uint32_t meshId, float depth);
+
+	static uint32_t getPipelineId(uint64_t sortKey);
+	static uint32_t getMaterialId(uint64_t sortKey);
+	static uint32_t getMeshId(uint64_t sortKey);
+
+	/* Set the number of draws, which are then filled in with setDraw; the storage is kept across frames */
+	void resize(uint32_t drawCount);
+
+	/* Threads may fill in different draws at the same time */
+	void setDraw(uint32_t drawIndex, uint64_t sortKey, uint32_t objectIndex);
+
+	/* Radix sort the draws by key, draws with equal keys keep their order; the statistics are gathered along the way */
+	void sort();
+
+	uint32_t getDrawCount() const;
+	const std::vector<uint64_t> &getSortKeys() const;
+	const std::vector<uint32_t> &getObjectIndices() const;
+	const RenderQueueStatistics &getStatistics() const;
+private:
+	std::vector<uint64_t> sortKeys;
+	std::vector<uint32_t> objectIndices;
+
+	// The radix sort ping-pongs between these and the arrays above
+	std::vector<uint64_t> scratchSortKeys;
+	std::vector<uint32_t> scratchObjectIndices;
+
+	RenderQueueStatistics statistics;
+
+	/* Count the pipeline, material and mesh changes along the current order of the draws */
+	void countStateChanges(uint32_t &pipelineChanges, uint32_t &materialChanges, uint32_t &meshChanges) const;
+};
+
+} // namespace vulkr
@@ -0,0 +1,210 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "scene_store.h"
+
+#include "common/logger.h"
+
+namespace vulkr
+{
+
+EntityHandle SceneStore::createEntity(const glm::mat4 &localTransform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, uint32_t meshId, uint32_t materialId)
+{
+	uint32_t slotIndex;
+	if (!freeSlots.empty())
+	{
+		slotIndex = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else
+	{
+		slotIndex = static_cast<uint32_t>(slots.size());
+		slots.emplace_back();
+	}
+
+	Slot &slot = slots[slotIndex];
+	slot.entityIndex = getEntityCount();
+	slot.alive = true;
+
+	entitySlots.push_back(slotIndex);
+	localTransforms.push_back(localTransform);
+	worldTransforms.push_back(localTransform);
+	localBoundsMin.push_back(boundsMin);
+	localBoundsMax.push_back(boundsMax);
+	worldBoundsMin.push_back(boundsMin);
+	worldBoundsMax.push_back(boundsMax);
+	meshIds.push_back(meshId);
+	materialIds.push_back(materialId);
+	flags.push_back(ENTITY_FLAG_VISIBLE | ENTITY_FLAG_TRANSFORM_CHANGED);
+
+	return EntityHandle{ slotIndex, slot.generation };
+}
+
+void SceneStore::destroyEntity(EntityHandle entity)
+{
+	const uint32_t entityIndex = getEntityIndex(entity);
+	const uint32_t lastEntityIndex = getEntityCount() - 1;
+
+	// Swapping the last entity into the hole keeps the arrays dense
+	if (entityIndex != lastEntityIndex)
+	{
+		entitySlots[entityIndex] = entitySlots[lastEntityIndex];
+		localTransforms[entityIndex] = localTransforms[lastEntityIndex];
+		worldTransforms[entityIndex] = worldTransforms[lastEntityIndex];
+		localBoundsMin[entityIndex] = localBoundsMin[lastEntityIndex];
+		localBoundsMax[entityIndex] = localBoundsMax[lastEntityIndex];
+		worldBoundsMin[entityIndex] = worldBoundsMin[lastEntityIndex];
+		worldBoundsMax[entityIndex] = worldBoundsMax[lastEntityIndex];
+		meshIds[entityIndex] = meshIds[lastEntityIndex];
+		materialIds[entityIndex] = materialIds[lastEntityIndex];
+		flags[entityIndex] = flags[lastEntityIndex];
+
+		slots[entitySlots[entityIndex]].entityIndex = entityIndex;
+	}
+
+	entitySlots.pop_back();
+	localTransforms.pop_back();
+	worldTransforms.pop_back();
+	localBoundsMin.pop_back();
+	localBoundsMax.pop_back();
+	worldBoundsMin.pop_back();
+	worldBoundsMax.pop_back();
+	meshIds.pop_back();
+	materialIds.pop_back();
+	flags.pop_back();
+
+	Slot &slot = slots[entity.slot];
+	slot.alive = false;
+	++slot.generation;
+	freeSlots.push_back(entity.slot);
+}
+
+bool SceneStore::isValid(EntityHandle entity) const
+{
+	return entity.slot < slots.size() && slots[entity.slot].alive && slots[entity.slot].generation == entity.generation;
+}
+
+void SceneStore::setLocalTransform(EntityHandle entity, const glm::mat4 &localTransform)
+{
+	const uint32_t entityIndex = getEntityIndex(entity);
+	localTransforms[entityIndex] = localTransform;
+	flags[entityIndex] |= ENTITY_FLAG_TRANSFORM_CHANGED;
+}
+
+void SceneStore::setVisible(EntityHandle entity, bool visible)
+{
+	const uint32_t entityIndex = getEntityIndex(entity);
+	if (visible)
+	{
+		flags[entityIndex] |= ENTITY_FLAG_VISIBLE;
+	}
+	else
+	{
+		flags[entityIndex] &= ~ENTITY_FLAG_VISIBLE;
+	}
+}
+
+void SceneStore::updateWorldTransforms(uint32_t firstEntity, uint32_t lastEntity)
+{
+	for (uint32_t entityIndex = firstEntity; entityIndex < lastEntity; ++entityIndex)
+	{
+		if ((flags[entityIndex] & ENTITY_FLAG_TRANSFORM_CHANGED) == 0)
+		{
+			continue;
+		}
+
+		// The scene has no hierarchy yet so the world transform is the local one, only the bounds have to follow
+		const glm::mat4 &transform = localTransforms[entityIndex];
+		worldTransforms[entityIndex] = transform;
+
+		// The box around the transformed box, see "Transforming Axis-Aligned Bounding Boxes" (Arvo, Graphics Gems 1990)
+		glm::vec3 center = glm::vec3{ transform * glm::vec4{ (localBoundsMin[entityIndex] + localBoundsMax[entityIndex]) * 0.5f, 1.0f } };
+		glm::vec3 extent = (localBoundsMax[entityIndex] - localBoundsMin[entityIndex]) * 0.5f;
+		glm::vec3 worldExtent{ 0.0f };
+		for (int column = 0; column < 3; ++column)
+		{
+			worldExtent += glm::abs(glm::vec3{ transform[column] }) * extent[column];
+		}
+		worldBoundsMin[entityIndex] = center - worldExtent;
+		worldBoundsMax[entityIndex] = center + worldExtent;
+
+		flags[entityIndex] &= ~ENTITY_FLAG_TRANSFORM_CHANGED;
+	}
+}
+
+uint32_t SceneStore::getEntityCount() const
+{
+	return static_cast<uint32_t>(entitySlots.size());
+}
+
+EntityHandle SceneStore::getHandle(uint32_t entityIndex) const
+{
+	const uint32_t slotIndex = entitySlots[entityIndex];
+	return EntityHandle{ slotIndex, slots[slotIndex].generation };
+}
+
+const std::vector<glm::mat4> &SceneStore::getLocalTransforms() const
+{
+	return localTransforms;
+}
+
+const std::vector<glm::mat4> &SceneStore::getWorldTransforms() const
+{
+	return worldTransforms;
+}
+
+const std::vector<glm::vec3> &SceneStore::getWorldBoundsMin() const
+{
+	return worldBoundsMin;
+}
+
+const std::vector<glm::vec3> &SceneStore::getWorldBoundsMax() const
+{
+	return worldBoundsMax;
+}
+
+const std::vector<uint32_t> &SceneStore::getMeshIds() const
+{
+	return meshIds;
+}
+
+const std::vector<uint32_t> &SceneStore::getMaterialIds() const
+{
+	return materialIds;
+}
+
+const std::vector<uint32_t> &SceneStore::getFlags() const
+{
+	return flags;
+}
+
+uint32_t SceneStore::getEntityIndex(EntityHandle entity) const
+{
+	if (!isValid(entity))
+	{
+		LOGEANDABORT("The entity handle (slot {}, generation {}) doesn't refer to a live entity", entity.slot, entity.generation);
+	}
+
+	return slots[entity.slot].entityIndex;
+}
+
+} // namespace vulkr
@@ -0,0 +1,124 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace vulkr
+{
+
+/* Refers to an entity of a SceneStore, the slot is reused once the entity is destroyed but with the next generation so stale handles are detected */
+struct EntityHandle
+{
+	uint32_t slot{ std::numeric_limits<uint32_t>::max() };
+	uint32_t generation{ 0 };
+
+	bool operator==(const EntityHandle &other) const { return slot == other.slot && generation == other.generation; }
+	bool operator!=(const EntityHandle &other) const { return !(*this == other); }
+};
+
+constexpr EntityHandle INVALID_ENTITY_HANDLE{};
+
+enum EntityFlags : uint32_t
+{
+	ENTITY_FLAG_VISIBLE = 1 << 0, // Drawn when inside the view frustum
+	ENTITY_FLAG_TRANSFORM_CHANGED = 1 << 1 // The world transform and bounds are out of date
+};
+
+/*
+ * The entities of the scene as a structure of arrays, so the per frame passes (transform updates, culling, sorting and the object data upload) stream linearly over the fields they need.
+ * The arrays are dense: an entity's position in them is its instance index and changes when another entity is destroyed, the handles stay valid.
+ */
+class SceneStore
+{
+public:
+	SceneStore() = default;
+	~SceneStore() = default;
+
+	SceneStore(const SceneStore &) = delete;
+	SceneStore(SceneStore &&) = delete;
+	SceneStore &operator=(const SceneStore &) = delete;
+	SceneStore &operator=(SceneStore &&) = delete;
+
+	/**
+	 * Add a visible entity
+	 * @param boundsMin The lower corner of the bounds in the space of the entity, usually the bounds of its mesh
+	 */
+	EntityHandle createEntity(const glm::mat4 &localTransform, const glm::vec3 &boundsMin, const glm::vec3 &boundsMax, uint32_t meshId, uint32_t materialId);
+
+	/* Remove an entity, the last entity in the arrays takes its place */
+	void destroyEntity(EntityHandle entity);
+
+	/* Whether the handle refers to an entity that wasn't destroyed */
+	bool isValid(EntityHandle entity) const;
+
+	void setLocalTransform(EntityHandle entity, const glm::mat4 &localTransform);
+
+	void setVisible(EntityHandle entity, bool visible);
+
+	/* Bring the world transforms and bounds of the entities in [firstEntity, lastEntity) up to date, disjoint ranges can be updated in parallel */
+	void updateWorldTransforms(uint32_t firstEntity, uint32_t lastEntity);
+
+	uint32_t getEntityCount() const;
+
+	/* The handle of the entity at a position in the arrays */
+	EntityHandle getHandle(uint32_t entityIndex) const;
+
+	/* The arrays, indexed by the position of an entity */
+	const std::vector<glm::mat4> &getLocalTransforms() const;
+	const std::vector<glm::mat4> &getWorldTransforms() const;
+	const std::vector<glm::vec3> &getWorldBoundsMin() const;
+	const std::vector<glm::vec3> &getWorldBoundsMax() const;
+	const std::vector<uint32_t> &getMeshIds() const;
+	const std::vector<uint32_t> &getMaterialIds() const;
+	const std::vector<uint32_t> &getFlags() const;
+private:
+	struct Slot
+	{
+		uint32_t entityIndex{ 0 };
+		uint32_t generation{ 0 };
+		bool alive{ false };
+	};
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+
+	std::vector<uint32_t> entitySlots; // The slot of every entity, to fix up the slot of the entity moved by destroyEntity
+	std::vector<glm::mat4> localTransforms;
+	std::vector<glm::mat4> worldTransforms;
+	std::vector<glm::vec3> localBoundsMin;
+	std::vector<glm::vec3> localBoundsMax;
+	std::vector<glm::vec3> worldBoundsMin;
+	std::vector<glm::vec3> worldBoundsMax;
+	std::vector<uint32_t> meshIds;
+	std::vector<uint32_t> materialIds;
+	std::vector<uint32_t> flags;
+
+	/* Get the position of the entity in the arrays, aborts on stale handles */
+	uint32_t getEntityIndex(EntityHandle entity) const;
+};
+
+} // namespace vulkr
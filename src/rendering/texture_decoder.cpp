@@ -0,0 +1,222 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "texture_decoder.h"
+#include "common/helpers.h"
+#include "common/logger.h"
+#include "common/timer.h"
+#include "rendering/block_compression.h"
+#include "rendering/ktx2_texture.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+namespace vulkr
+{
+
+static bool isCompressedTextureCurrent(const std::string &sourcePath, const std::string &compressedPath)
+{
+	std::error_code error;
+	auto compressedTime = std::filesystem::last_write_time(compressedPath, error);
+	if (error)
+	{
+		return false;
+	}
+
+	// The compressed texture is self contained, so it can still be used if the source isn't shipped
+	auto sourceTime = std::filesystem::last_write_time(sourcePath, error);
+	return error || sourceTime <= compressedTime;
+}
+
+static bool hasTranslucentTexels(const stbi_uc *pixels, size_t texelCount)
+{
+	for (size_t i = 0; i < texelCount; ++i)
+	{
+		if (pixels[i * 4 + 3] != 255)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+static BlockCompression getBlockCompression(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+		return BlockCompression::BC1;
+	case VK_FORMAT_BC3_SRGB_BLOCK:
+		return BlockCompression::BC3;
+	case VK_FORMAT_BC7_SRGB_BLOCK:
+		return BlockCompression::BC7;
+	default:
+		LOGEANDABORT("Textures can't be compressed into format {}", static_cast<int>(format));
+	}
+}
+
+TextureDecoder::TextureDecoder(VkPhysicalDevice physicalDeviceHandle, bool blockCompressionEnabled, bool generateMipmapsOnGpu, size_t maxFreeBuffers) :
+	physicalDeviceHandle{ physicalDeviceHandle },
+	blockCompressionEnabled{ blockCompressionEnabled },
+	generateMipmapsOnGpu{ generateMipmapsOnGpu },
+	bufferPool{ maxFreeBuffers }
+{}
+
+DecodedTexture TextureDecoder::decode(const std::string &filename)
+{
+	// This runs on a texture loader thread, it only queries the physical device which doesn't require any synchronization
+	DecodedTexture decodedTexture;
+
+	// Textures are block compressed into a KTX2 file next to the source the first time they're loaded, later runs upload the file as is
+	const std::string compressedPath = filename + ".ktx2";
+	if (isCompressedTextureCurrent(filename, compressedPath))
+	{
+		Ktx2Texture compressedTexture{ compressedPath };
+		if (compressedTexture.isValid() && isCompressedFormatSupported(compressedTexture.getFormat()))
+		{
+			// The levels are packed together in the file, so they are all staged with a single copy of the range they span
+			uint64_t dataBegin{ compressedTexture.getLevelRange(0).offset };
+			uint64_t dataEnd{ 0 };
+			for (uint32_t level = 0; level < compressedTexture.getLevelCount(); ++level)
+			{
+				const Ktx2LevelRange &range = compressedTexture.getLevelRange(level);
+				dataBegin = std::min(dataBegin, range.offset);
+				dataEnd = std::max(dataEnd, range.offset + range.size);
+			}
+
+			decodedTexture.format = compressedTexture.getFormat();
+			decodedTexture.extent = { compressedTexture.getWidth(), compressedTexture.getHeight(), 1u };
+			decodedTexture.mipLevelCount = compressedTexture.getLevelCount();
+			decodedTexture.levels.resize(compressedTexture.getLevelCount());
+			for (uint32_t level = 0; level < compressedTexture.getLevelCount(); ++level)
+			{
+				const uint64_t offset{ compressedTexture.getLevelRange(level).offset - dataBegin };
+				decodedTexture.levels[level] = MipLevel{ static_cast<size_t>(offset), std::max(compressedTexture.getWidth() >> level, 1u), std::max(compressedTexture.getHeight() >> level, 1u) };
+			}
+
+			decodedTexture.data = bufferPool.acquire(static_cast<size_t>(dataEnd - dataBegin));
+			memcpy(decodedTexture.data.data(), compressedTexture.getData() + dataBegin, decodedTexture.data.size());
+			return decodedTexture;
+		}
+	}
+
+	int texWidth, texHeight, texChannels;
+
+	stbi_uc *pixels = stbi_load(filename.c_str(), &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
+	if (!pixels) {
+		LOGEANDABORT("failed to load texture image!");
+	}
+
+	decodedTexture.extent = { to_u32(texWidth), to_u32(texHeight), 1u };
+
+	const VkFormat compressedFormat{ getCompressedFormat(hasTranslucentTexels(pixels, static_cast<size_t>(texWidth) * texHeight)) };
+	if (compressedFormat != VK_FORMAT_UNDEFINED)
+	{
+		Timer compressionTimer;
+		compressionTimer.start();
+
+		std::vector<MipLevel> sourceLevels;
+		std::vector<uint8_t> mipChain = generateMipChainRGBA8(pixels, to_u32(texWidth), to_u32(texHeight), true, sourceLevels);
+		stbi_image_free(pixels);
+
+		const BlockCompression compression{ getBlockCompression(compressedFormat) };
+		decodedTexture.levels.resize(sourceLevels.size());
+		size_t compressedSize{ 0 };
+		for (size_t level = 0; level < sourceLevels.size(); ++level)
+		{
+			decodedTexture.levels[level] = MipLevel{ compressedSize, sourceLevels[level].width, sourceLevels[level].height };
+			compressedSize += getCompressedImageSize(compression, sourceLevels[level].width, sourceLevels[level].height);
+		}
+
+		decodedTexture.data = bufferPool.acquire(compressedSize);
+		std::vector<Ktx2Level> compressedLevels(decodedTexture.levels.size());
+		for (size_t level = 0; level < decodedTexture.levels.size(); ++level)
+		{
+			const MipLevel &mipLevel = decodedTexture.levels[level];
+			compressImage(compression, mipChain.data() + sourceLevels[level].offset, mipLevel.width, mipLevel.height, decodedTexture.data.data() + mipLevel.offset);
+			compressedLevels[level] = Ktx2Level{ decodedTexture.data.data() + mipLevel.offset, getCompressedImageSize(compression, mipLevel.width, mipLevel.height) };
+		}
+
+		LOGI("Compressed {} in {:.1f} ms", filename, compressionTimer.stop<Timer::Milliseconds>());
+		Ktx2Texture::write(compressedPath, compressedFormat, to_u32(texWidth), to_u32(texHeight), compressedLevels);
+
+		decodedTexture.format = compressedFormat;
+		decodedTexture.mipLevelCount = to_u32(decodedTexture.levels.size());
+		return decodedTexture;
+	}
+
+	LOGW("Block compressed textures aren't supported, uploading {} as RGBA8", filename);
+
+	decodedTexture.format = VK_FORMAT_R8G8B8A8_SRGB;
+	decodedTexture.mipLevelCount = getMipLevelCount(to_u32(texWidth), to_u32(texHeight));
+
+	if (generateMipmapsOnGpu)
+	{
+		// Only the full resolution image is uploaded, the other levels are blitted from it
+		decodedTexture.levels = { MipLevel{ 0, to_u32(texWidth), to_u32(texHeight) } };
+		decodedTexture.data = bufferPool.acquire(static_cast<size_t>(texWidth) * texHeight * 4);
+		memcpy(decodedTexture.data.data(), pixels, decodedTexture.data.size());
+	}
+	else
+	{
+		// A transfer only queue can't blit either
+		LOGW("The texture format can't be blitted with linear filtering on the streaming queue, generating the mip levels of {} on the CPU", filename);
+		decodedTexture.data = generateMipChainRGBA8(pixels, to_u32(texWidth), to_u32(texHeight), true, decodedTexture.levels);
+	}
+
+	stbi_image_free(pixels);
+
+	return decodedTexture;
+}
+
+void TextureDecoder::release(DecodedTexture &decodedTexture)
+{
+	bufferPool.release(std::move(decodedTexture.data));
+}
+
+VkFormat TextureDecoder::getCompressedFormat(bool hasAlpha) const
+{
+	if (!blockCompressionEnabled)
+	{
+		return VK_FORMAT_UNDEFINED;
+	}
+
+	// Opaque textures take half the memory as BC1, BC7 keeps more detail than BC3 for the same size when there is alpha
+	if (hasAlpha)
+	{
+		return getSupportedSampledFormat(physicalDeviceHandle, { VK_FORMAT_BC7_SRGB_BLOCK, VK_FORMAT_BC3_SRGB_BLOCK });
+	}
+	return getSupportedSampledFormat(physicalDeviceHandle, { VK_FORMAT_BC1_RGB_SRGB_BLOCK, VK_FORMAT_BC7_SRGB_BLOCK });
+}
+
+bool TextureDecoder::isCompressedFormatSupported(VkFormat format) const
+{
+	return blockCompressionEnabled &&
+		getSupportedSampledFormat(physicalDeviceHandle, { format }) == format;
+}
+
+} // namespace vulkr
@@ -0,0 +1,82 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/vulkan_common.h"
+#include "common/host_buffer_pool.h"
+#include "rendering/mipmap_generator.h"
+
+namespace vulkr
+{
+
+/* An image decoded on a texture loader thread, ready to be uploaded by the main thread */
+struct DecodedTexture
+{
+	VkFormat format{ VK_FORMAT_UNDEFINED };
+	VkExtent3D extent{};
+	uint32_t mipLevelCount{ 1 }; // More than the number of levels decoded when the remaining ones are generated on the GPU
+	std::vector<MipLevel> levels;
+	std::vector<uint8_t> data; // Every decoded level packed at the offsets in levels, handed back through TextureDecoder::release once staged
+};
+
+/*
+ * Decodes texture files into the data uploaded for them, decode can be called from any thread.
+ * When the device samples block compressed formats, a texture is compressed into a KTX2 file next to its source the first time it's decoded and later decodes read that file as is
+ */
+class TextureDecoder
+{
+public:
+	/**
+	 * @param physicalDeviceHandle Queried for the block compressed formats it can sample, which doesn't require any synchronization
+	 * @param blockCompressionEnabled Whether the textureCompressionBC feature is enabled on the device
+	 * @param generateMipmapsOnGpu Whether the mip levels of uncompressed textures are blitted on the GPU, otherwise they are generated on the CPU
+	 * @param maxFreeBuffers The number of decode buffers kept around for later decodes to reuse
+	 */
+	TextureDecoder(VkPhysicalDevice physicalDeviceHandle, bool blockCompressionEnabled, bool generateMipmapsOnGpu, size_t maxFreeBuffers);
+	~TextureDecoder() = default;
+
+	TextureDecoder(const TextureDecoder &) = delete;
+	TextureDecoder(TextureDecoder &&) = delete;
+	TextureDecoder &operator=(const TextureDecoder &) = delete;
+	TextureDecoder &operator=(TextureDecoder &&) = delete;
+
+	DecodedTexture decode(const std::string &filename);
+
+	/* Returns the data of a decoded texture to the buffer pool once it has been copied to the staging memory */
+	void release(DecodedTexture &decodedTexture);
+private:
+	VkPhysicalDevice physicalDeviceHandle{ VK_NULL_HANDLE };
+	bool blockCompressionEnabled{ false };
+	bool generateMipmapsOnGpu{ false };
+	HostBufferPool bufferPool;
+
+	/* The block compressed format new textures are compressed into, VK_FORMAT_UNDEFINED when none can be sampled */
+	VkFormat getCompressedFormat(bool hasAlpha) const;
+	bool isCompressedFormatSupported(VkFormat format) const;
+};
+
+} // namespace vulkr
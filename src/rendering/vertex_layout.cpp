@@ -0,0 +1,161 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "vertex_layout.h"
+#include "common/logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vulkr
+{
+
+VertexLayout &VertexLayout::addAttribute(uint32_t location, VkFormat format)
+{
+	for (const VertexLayoutAttribute &attribute : attributes)
+	{
+		if (attribute.location == location)
+		{
+			LOGEANDABORT("Vertex attribute location {} is already used by the layout", location);
+		}
+	}
+
+	attributes.push_back({ location, format, stride });
+	stride += getVertexFormatSize(format);
+
+	return *this;
+}
+
+VertexLayout &VertexLayout::addPadding(uint32_t size)
+{
+	stride += size;
+
+	return *this;
+}
+
+uint32_t VertexLayout::getStride() const
+{
+	return stride;
+}
+
+const std::vector<VertexLayoutAttribute> &VertexLayout::getAttributes() const
+{
+	return attributes;
+}
+
+VertexInputState VertexLayout::createVertexInputState(uint32_t binding) const
+{
+	VertexInputState vertexInputState{};
+
+	VkVertexInputBindingDescription bindingDescription{};
+	bindingDescription.binding = binding;
+	bindingDescription.stride = stride;
+	bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+	vertexInputState.bindingDescriptions.emplace_back(bindingDescription);
+
+	vertexInputState.attributeDescriptions.reserve(attributes.size());
+	for (const VertexLayoutAttribute &attribute : attributes)
+	{
+		VkVertexInputAttributeDescription attributeDescription{};
+		attributeDescription.binding = binding;
+		attributeDescription.location = attribute.location;
+		attributeDescription.format = attribute.format;
+		attributeDescription.offset = attribute.offset;
+		vertexInputState.attributeDescriptions.emplace_back(attributeDescription);
+	}
+
+	return vertexInputState;
+}
+
+uint32_t getVertexFormatSize(VkFormat format)
+{
+	switch (format)
+	{
+	case VK_FORMAT_R8G8B8A8_UNORM:
+	case VK_FORMAT_R8G8B8A8_SNORM:
+	case VK_FORMAT_R16G16_UNORM:
+	case VK_FORMAT_R16G16_SNORM:
+	case VK_FORMAT_R16G16_SFLOAT:
+	case VK_FORMAT_R32_SFLOAT:
+	case VK_FORMAT_R32_UINT:
+	case VK_FORMAT_A2B10G10R10_SNORM_PACK32:
+	case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+		return 4;
+	case VK_FORMAT_R16G16B16A16_UNORM:
+	case VK_FORMAT_R16G16B16A16_SNORM:
+	case VK_FORMAT_R16G16B16A16_SFLOAT:
+	case VK_FORMAT_R32G32_SFLOAT:
+		return 8;
+	case VK_FORMAT_R32G32B32_SFLOAT:
+		return 12;
+	case VK_FORMAT_R32G32B32A32_SFLOAT:
+		return 16;
+	default:
+		LOGEANDABORT("Vertex format {} is not supported by VertexLayout", static_cast<int>(format));
+	}
+}
+
+int16_t quantizeSnorm16(float value)
+{
+	value = std::clamp(value, -1.0f, 1.0f);
+	return static_cast<int16_t>(std::lround(value * 32767.0f));
+}
+
+uint16_t quantizeUnorm16(float value)
+{
+	value = std::clamp(value, 0.0f, 1.0f);
+	return static_cast<uint16_t>(std::lround(value * 65535.0f));
+}
+
+glm::vec2 encodeOctahedral(const glm::vec3 &direction)
+{
+	float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+	if (length == 0.0f)
+	{
+		// Missing normals decode to +z
+		return glm::vec2{ 0.0f };
+	}
+
+	glm::vec2 encoded{ direction.x / length, direction.y / length };
+	if (direction.z < 0.0f)
+	{
+		// Fold the lower hemisphere over the diagonals
+		encoded = glm::vec2{
+			(1.0f - std::abs(encoded.y)) * (encoded.x >= 0.0f ? 1.0f : -1.0f),
+			(1.0f - std::abs(encoded.x)) * (encoded.y >= 0.0f ? 1.0f : -1.0f)
+		};
+	}
+
+	return encoded;
+}
+
+glm::vec3 decodeOctahedral(const glm::vec2 &encoded)
+{
+	glm::vec3 direction{ encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+	float t = std::max(-direction.z, 0.0f);
+	direction.x += direction.x >= 0.0f ? -t : t;
+	direction.y += direction.y >= 0.0f ? -t : t;
+
+	return glm::normalize(direction);
+}
+
+} // namespace vulkr
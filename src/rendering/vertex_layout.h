@@ -0,0 +1,81 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "common/vulkan_common.h"
+#include "rendering/pipeline_state.h"
+
+namespace vulkr
+{
+
+/* A single attribute of an interleaved vertex */
+struct VertexLayoutAttribute
+{
+	uint32_t location;
+	VkFormat format;
+	uint32_t offset;
+};
+
+/* Describes the memory layout of an interleaved vertex so the matching vertex input state is generated from it instead of written by hand */
+class VertexLayout
+{
+public:
+	VertexLayout() = default;
+	~VertexLayout() = default;
+
+	/* Appends an attribute read by the vertex shader at the given location, its offset follows the previous attribute */
+	VertexLayout &addAttribute(uint32_t location, VkFormat format);
+
+	/* Appends bytes that aren't read by the vertex shader */
+	VertexLayout &addPadding(uint32_t size);
+
+	uint32_t getStride() const;
+	const std::vector<VertexLayoutAttribute> &getAttributes() const;
+
+	/* Generates the binding and attribute descriptions for a per vertex buffer bound at the given binding */
+	VertexInputState createVertexInputState(uint32_t binding = 0u) const;
+private:
+	std::vector<VertexLayoutAttribute> attributes;
+	uint32_t stride{ 0 };
+};
+
+/* Returns the size in bytes of a format usable as a vertex attribute */
+uint32_t getVertexFormatSize(VkFormat format);
+
+/* Maps a value in the range [-1, 1] to a signed normalized 16 bit integer */
+int16_t quantizeSnorm16(float value);
+
+/* Maps a value in the range [0, 1] to an unsigned normalized 16 bit integer */
+uint16_t quantizeUnorm16(float value);
+
+/* Projects a unit vector onto an octahedron unfolded into the [-1, 1] square, so that it can be stored in two components */
+glm::vec2 encodeOctahedral(const glm::vec3 &direction);
+
+/* The inverse of encodeOctahedral, matches the decoding done by the quantized vertex shader */
+glm::vec3 decodeOctahedral(const glm::vec2 &encoded);
+
+} // namespace vulkr
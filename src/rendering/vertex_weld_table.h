@@ -0,0 +1,175 @@
+/* Copyright (c) 2021 Adithya Venkatarao
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining
+ * a copy of this software and associated documentation files (the
+ * "Software"), to deal in the Software without restriction, including
+ * without limitation the rights to use, copy, modify, merge, publish,
+ * distribute, sublicense, and/or sell copies of the Software, and to
+ * permit persons to whom the Software is furnished to do so, subject to
+ * the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+ * MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY
+ * CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,
+ * TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE
+ * SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+#include "common/helpers.h"
+
+namespace vulkr
+{
+
+/* Statistics gathered by a VertexWeldTable, useful to judge the quality of the hash */
+struct VertexWeldStatistics
+{
+	size_t lookups{ 0 };
+	size_t uniqueVertices{ 0 };
+	size_t capacity{ 0 };
+	size_t rehashes{ 0 };
+	size_t collisions{ 0 }; // Probes that landed on a slot holding a different vertex
+	size_t totalProbeLength{ 0 };
+	size_t maxProbeLength{ 0 };
+
+	double getAverageProbeLength() const
+	{
+		return lookups == 0 ? 0.0 : static_cast<double>(totalProbeLength) / static_cast<double>(lookups);
+	}
+};
+
+/*
+ * A flat, open addressing (linear probing) table used to weld identical vertices during mesh import.
+ * Vertices are hashed and compared over all of their bytes, so two vertices are only welded if they are bitwise identical.
+ * The table stores indices into the caller's vertex array rather than copies of the vertices, along with a hash tag to skip most full comparisons.
+ */
+template <typename T>
+class VertexWeldTable
+{
+	static_assert(std::is_trivially_copyable<T>::value, "Vertices are hashed and compared as raw bytes");
+public:
+	/* @param expectedVertexCount An upper bound of the amount of unique vertices, such as the amount of face corners, used to size the table so it never has to grow */
+	explicit VertexWeldTable(size_t expectedVertexCount)
+	{
+		size_t capacity{ 16 };
+		while (capacity * maxLoadNumerator < expectedVertexCount * maxLoadDenominator)
+		{
+			capacity <<= 1;
+		}
+		slots.resize(capacity);
+		statistics.capacity = capacity;
+	}
+
+	/**
+	 * Finds the vertex in the table, appending it to the vertex array if no identical vertex has been seen yet
+	 * @param vertex The vertex to weld
+	 * @param vertices The vertex array that all previously welded vertices were appended to
+	 * @return The index of the vertex in the vertex array
+	 */
+	uint32_t weld(const T &vertex, std::vector<T> &vertices)
+	{
+		const uint64_t hash{ hashBytes(&vertex, sizeof(T)) };
+		const uint32_t tag{ static_cast<uint32_t>(hash >> 32) };
+		const size_t mask{ slots.size() - 1 };
+
+		++statistics.lookups;
+
+		size_t probeLength{ 1 };
+		for (size_t slotIndex = static_cast<size_t>(hash) & mask;; slotIndex = (slotIndex + 1) & mask, ++probeLength)
+		{
+			Slot &slot = slots[slotIndex];
+			if (slot.index == emptySlot)
+			{
+				recordProbe(probeLength);
+
+				slot.index = static_cast<uint32_t>(vertices.size());
+				slot.tag = tag;
+				vertices.push_back(vertex);
+
+				if (++statistics.uniqueVertices * maxLoadDenominator > slots.size() * maxLoadNumerator)
+				{
+					rehash(vertices);
+				}
+
+				return static_cast<uint32_t>(vertices.size() - 1);
+			}
+
+			if (slot.tag == tag && memcmp(&vertices[slot.index], &vertex, sizeof(T)) == 0)
+			{
+				recordProbe(probeLength);
+				return slot.index;
+			}
+
+			++statistics.collisions;
+		}
+	}
+
+	const VertexWeldStatistics &getStatistics() const
+	{
+		return statistics;
+	}
+private:
+	struct Slot
+	{
+		uint32_t index{ emptySlot };
+		uint32_t tag{ 0 };
+	};
+
+	static constexpr uint32_t emptySlot{ ~0u };
+
+	// Keep the load factor below 3/4, linear probing degrades quickly past that
+	static constexpr size_t maxLoadNumerator{ 3 };
+	static constexpr size_t maxLoadDenominator{ 4 };
+
+	std::vector<Slot> slots;
+	VertexWeldStatistics statistics;
+
+	void recordProbe(size_t probeLength)
+	{
+		statistics.totalProbeLength += probeLength;
+		if (probeLength > statistics.maxProbeLength)
+		{
+			statistics.maxProbeLength = probeLength;
+		}
+	}
+
+	/* Only happens if the table was sized with an expected count that was too small */
+	void rehash(const std::vector<T> &vertices)
+	{
+		std::vector<Slot> oldSlots(slots.size() * 2);
+		oldSlots.swap(slots);
+
+		const size_t mask{ slots.size() - 1 };
+		for (const Slot &oldSlot : oldSlots)
+		{
+			if (oldSlot.index == emptySlot)
+			{
+				continue;
+			}
+
+			const uint64_t hash{ hashBytes(&vertices[oldSlot.index], sizeof(T)) };
+			size_t slotIndex = static_cast<size_t>(hash) & mask;
+			while (slots[slotIndex].index != emptySlot)
+			{
+				slotIndex = (slotIndex + 1) & mask;
+			}
+			slots[slotIndex] = oldSlot;
+		}
+
+		statistics.capacity = slots.size();
+		++statistics.rehashes;
+	}
+};
+
+} // namespace vulkr
@@ -1,3 +1,5 @@
 C:/VulkanSDK/1.2.170.0/Bin32/glslc.exe main.vert -o main.vert.spv
+C:/VulkanSDK/1.2.170.0/Bin32/glslc.exe main_quantized.vert -o main_quantized.vert.spv
 C:/VulkanSDK/1.2.170.0/Bin32/glslc.exe default.frag -o default.frag.spv
-C:/VulkanSDK/1.2.170.0/Bin32/glslc.exe textured.frag -o textured.frag.spv
\ No newline at end of file
+C:/VulkanSDK/1.2.170.0/Bin32/glslc.exe textured.frag -o textured.frag.spv
+C:/VulkanSDK/1.2.170.0/Bin32/glslc.exe cull.comp -o cull.comp.spv
\ No newline at end of file
@@ -0,0 +1,41 @@
+#version 460
+
+layout(set = 0, binding = 0) uniform CameraBuffer {
+    mat4 view;
+    mat4 proj;
+} camera;
+
+struct ObjectData {
+	mat4 model; // Includes the mesh dequantization transform
+};
+
+layout(std140, set = 1, binding = 0) readonly buffer ObjectBuffer {
+	ObjectData objects[];
+} objectBuffer;
+
+layout(push_constant) uniform MeshConstants {
+    vec4 textureCoordinateTransform; // xy scale, zw offset
+} mesh;
+
+layout(location = 0) in vec4 inPosition; // snorm16 within the mesh bounds, w is padding
+layout(location = 1) in vec2 inNormal; // snorm16 octahedral encoding
+layout(location = 3) in vec2 inTexCoord; // unorm16 within the mesh texture coordinate range
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec2 fragTexCoord;
+
+vec3 decodeOctahedral(vec2 encoded) {
+    vec3 direction = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = max(-direction.z, 0.0f);
+    direction.xy += vec2(direction.x >= 0.0f ? -t : t, direction.y >= 0.0f ? -t : t);
+    return normalize(direction);
+}
+
+void main() {
+    mat4 modelMatrix = objectBuffer.objects[gl_BaseInstance].model;
+    gl_Position = camera.proj * camera.view * modelMatrix * vec4(inPosition.xyz, 1.0f);
+
+    // The colour attribute was a copy of the normal, so the decoded normal takes its place
+    fragColor = decodeOctahedral(inNormal);
+    fragTexCoord = inTexCoord * mesh.textureCoordinateTransform.xy + mesh.textureCoordinateTransform.zw;
+}
\ No newline at end of file